@@ -2,53 +2,679 @@
  * @file network_debug_example.cpp
  * @brief Qt网络编程调试示例代码
  *
- * 这个示例展示了如何为网络服务器添加全面的调试日志
+ * 这个示例展示了如何为网络服务器添加全面的调试日志，
+ * 以及如何把已接受的连接分发到多个Reactor工作线程（每个线程一个事件循环）。
+ * 接收数据经FrameDecoder分帧（文本行或4字节长度前缀），响应直接以字节组装，
+ * 并经OutboundQueue按高低水位发送，慢客户端不会让内存无限增长。
+ * 每个Reactor用一个分层时间轮管理所有连接的心跳和空闲断开，而不是每个套接字一个QTimer。
+ * 运行状态通过MetricsRegistry以Prometheus文本格式暴露（--metrics-port），
+ * 周期性的qDebug状态转储改为可选（--debug-dump）。
+ * Linux上可用--io-backend=epoll|io_uring绕过QTcpSocket，由NativeReactor直接驱动已接受的描述符
  */
 
+#include <QCoreApplication>
+#include <QCommandLineParser>
 #include <QObject>
 #include <QTcpServer>
 #include <QTcpSocket>
+#include <QThread>
 #include <QTimer>
+#include <QDateTime>
 #include <QHostAddress>
+#include <QTime>
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QMetaEnum>
+#include <memory>
+#include <vector>
+
+#include "../network-performance/async_logger.h"
+#include "../network-performance/frame_decoder.h"
+#include "../network-performance/metrics.h"
+#include "../network-performance/native_reactor.h"
+#include "../network-performance/reactor_metrics.h"
+#include "../network-performance/outbound_queue.h"
+#include "../network-performance/slot_map.h"
+#include "../network-performance/thread_placement.h"
+#include "../network-performance/timing_wheel.h"
+
+using IdleWheel = TimingWheel<SlotHandle>;
+
+// 单个连接的全部状态，连续存放在ConnectionRegistry的稠密数组中
+struct ConnectionState {
+    quint32 id = 0;
+    QTcpSocket *socket = nullptr;
+    QHostAddress peerAddress;       // 接受时缓存，日志不再回查套接字
+    quint16 peerPort = 0;
+    FrameDecoder decoder;           // 接收环形缓冲区 + 分帧
+    QByteArray txBuffer;            // 复用容量，一次读事件的所有响应一次入队
+    OutboundQueue outbound;         // 发送队列，受高低水位约束
+    quint64 bytesIn = 0;
+    quint64 framesIn = 0;
+    quint64 readEvents = 0;
+    qint64 lastActivityMs = 0;      // Reactor时钟；读事件只更新时间戳，不触碰时间轮
+    IdleWheel::TimerId idleTimer = IdleWheel::kInvalidTimer;
+    bool heartbeatPending = false;  // 已发送心跳且尚未收到任何数据
+    qint64 reportedQueuedBytes = 0; // 已计入队列深度指标的字节数
+};
+
+using ConnectionHandle = SlotHandle;
+using ConnectionRegistry = SlotMap<ConnectionState>;
+
+// ===== 帧处理：Qt后端和原生后端共用 =====
+
+// 对一个请求帧组装响应，追加到out
+static void appendFrameResponse(FramingMode mode, const FrameView &frame, int clockMs, QByteArray *out) {
+    if (mode == FramingMode::LengthPrefixed) {
+        // 二进制模式：原样回显帧，供负载生成器测量往返延迟
+        appendLengthPrefixedFrame(*out, frame.data, frame.size);
+        return;
+    }
+
+    const FrameView text = trimmedFrame(frame);
+    out->append("收到数据 [");
+    appendClockTime(*out, clockMs);
+    out->append("]: ");
+    out->append(text.data, text.size);
+    out->append('\n');
+}
+
+// 文本模式的欢迎消息（长度前缀模式下客户端只期望回显帧，不发送）
+static QByteArray welcomeMessage(quint32 clientId) {
+    return QString("欢迎使用网络服务器！客户端ID: %1\n").arg(clientId).toUtf8();
+}
+
+// 长度前缀模式用空帧作为心跳，文本模式发送一行PING
+static QByteArray heartbeatMessage(FramingMode mode) {
+    return mode == FramingMode::LengthPrefixed ? QByteArray(FrameDecoder::kLengthPrefixSize, '\0')
+                                               : QByteArray("PING\n");
+}
+
+// 已接受连接的I/O驱动方式；接受始终由QTcpServer完成
+enum class IoBackend {
+    Qt,         // QTcpSocket + 事件循环
+    Epoll,      // NativeReactor，边沿触发epoll（仅Linux）
+    IoUring     // NativeReactor，io_uring（仅Linux，需liburing）
+};
+
+// 连接分发策略
+enum class ReactorPlacement {
+    RoundRobin,     // 轮询分配
+    LeastLoaded     // 分配给当前连接数最少的线程
+};
+
+/**
+ * @brief 单个Reactor：拥有一个事件循环上的全部客户端套接字
+ *
+ * 多Reactor模式下每个工作线程一个实例；单事件循环模式下服务器自身持有一个内联实例。
+ * 套接字只在所属Reactor的线程中被访问，跨线程只读取原子计数。
+ * 连接状态放在协程帧上、不需要ConnectionRegistry的写法见multithreading/coroutine_sessions.cpp（需要C++20）。
+ */
+class ReactorWorker : public QObject {
+    Q_OBJECT
+
+public:
+    explicit ReactorWorker(int index, QObject *parent = nullptr);
+
+    // 必须在接管任何连接之前设置
+    void setFramingMode(FramingMode mode) { m_framingMode = mode; }
+    void setOutboundConfig(const OutboundQueueConfig &config) { m_outboundConfig = config; }
+    void setIdleConfig(const IdleTimeoutConfig &config);
+
+    int index() const { return m_index; }
+    int connectionCount() const { return static_cast<int>(m_metrics.connections->value()); }
+
+    // 由接受线程在分发前调用，保证LeastLoaded在突发连接下也能看到最新负载
+    void reserveConnection() { m_metrics.connections->add(1); }
+
+    // 已发送心跳但未回应的连接数，可跨线程读取
+    int nearTimeoutCount() const { return static_cast<int>(m_metrics.nearTimeout->value()); }
+    quint64 heartbeatsSent() const { return m_metrics.heartbeats->value(); }
+    quint64 idleDisconnects() const { return m_metrics.idleDisconnects->value(); }
+
+public slots:
+    void adoptDescriptor(qintptr socketDescriptor, quint32 clientId);
+    void adoptSocket(QTcpSocket *socket, quint32 clientId);
+    void printClientInfo();
+
+private:
+    // ✅ 句柄由lambda捕获，处理函数不再依赖sender()和按套接字查表
+    void handleReadyRead(ConnectionHandle handle);
+    void handleDisconnected(ConnectionHandle handle);
+    void handleSocketError(ConnectionHandle handle, QAbstractSocket::SocketError error);
+    void handleBytesWritten(ConnectionHandle handle, qint64 bytes);
+    void applyBackpressure(ConnectionHandle handle, BackpressureAction action);
+    void handleIdleTick();
+    void sendHeartbeat(ConnectionHandle handle);
+    qint64 nextIdleDeadline(const ConnectionState &connection, qint64 now) const {
+        return ::nextIdleDeadline(m_idleConfig, connection.lastActivityMs, connection.heartbeatPending, now);
+    }
+    void updateQueueGauge(ConnectionState *connection);
+
+    int m_index;
+    FramingMode m_framingMode;
+    OutboundQueueConfig m_outboundConfig;
+    ConnectionRegistry m_connections;
+
+    // ✅ 每个Reactor一个时间轮和一个tick定时器，连接数再多也只有一个QTimer
+    IdleTimeoutConfig m_idleConfig;
+    QElapsedTimer m_clock;
+    IdleWheel m_idleWheel;
+    QTimer *m_idleTimer;
+    std::vector<ConnectionHandle> m_expiredTimers;  // 复用容量，批量处理到期连接
+
+    // ✅ 指标序列带reactor标签，只由本线程写入；指针在构造时注册一次，热路径只做原子加法
+    ReactorMetrics m_metrics;
+};
 
 class DebuggableNetworkServer : public QTcpServer {
     Q_OBJECT
 
 public:
     explicit DebuggableNetworkServer(QObject *parent = nullptr);
+    ~DebuggableNetworkServer() override;
+
+    // 必须在startServer()之前调用；threadCount为0表示所有连接都在服务器线程上处理
+    void setReactorThreads(int threadCount, ReactorPlacement placement = ReactorPlacement::RoundRobin);
+    void setFramingMode(FramingMode mode);
+    void setOutboundConfig(const OutboundQueueConfig &config);
+    void setIdleConfig(const IdleTimeoutConfig &config);
+    // 原生后端启动失败（或非Linux平台）时回退到Qt后端
+    void setIoBackend(IoBackend backend);
+
+    // 0表示关闭；抓取端点只监听本机回环地址
+    void setMetricsPort(quint16 port);
+    // 周期性qDebug状态转储，默认关闭；intervalMs为0表示关闭
+    void setDebugDumpInterval(int intervalMs);
 
     bool startServer(quint16 port, int droneId = 1);
 
 public slots:
     void handleNewConnection();
-    void handleReadyRead();
-    void handleDisconnected();
-    void handleSocketError(QAbstractSocket::SocketError error);
 
 private slots:
     void printDebugInfo();
 
+protected:
+    void incomingConnection(qintptr socketDescriptor) override;
+
 private:
-    void logConnectionInfo(const QString &message, QTcpSocket *socket = nullptr);
-    void logDataInfo(const QString &message, const QByteArray &data = QByteArray());
+    void startReactorThreads();
+    void stopReactorThreads();
+    bool startNativeReactors();
+    template <typename Reactors>
+    auto selectReactor(const Reactors &reactors) -> decltype(&*reactors.front());
+    void logConnectionInfo(const QString &message);
+
+    ReactorWorker *m_inlineReactor;
+    std::vector<ReactorWorker*> m_reactors;
+    std::vector<QThread*> m_reactorThreads;
+#ifdef Q_OS_LINUX
+    std::vector<std::unique_ptr<NativeReactor>> m_nativeReactors;
+#endif
+    IoBackend m_ioBackend;
+    int m_reactorThreadCount;
+    ReactorPlacement m_placement;
+    size_t m_nextReactor;
+    FramingMode m_framingMode;
+    OutboundQueueConfig m_outboundConfig;
+    IdleTimeoutConfig m_idleConfig;
+    quint16 m_metricsPort;
+    std::unique_ptr<MetricsEndpoint> m_metricsEndpoint;
 
-    QList<QTcpSocket*> m_clients;
-    QMap<QTcpSocket, quint32> m_clientIds;
     quint32 m_nextClientId;
     int m_droneId;
     QTimer m_debugTimer;
 };
 
+// ===== ReactorWorker =====
+
+ReactorWorker::ReactorWorker(int index, QObject *parent)
+    : QObject(parent)
+    , m_index(index)
+    , m_framingMode(FramingMode::LineDelimited)
+    , m_idleTimer(new QTimer(this))
+    , m_metrics(QByteArray::number(index)) {
+    m_connections.reserve(1024);
+    m_clock.start();
+    m_idleWheel = IdleWheel(m_idleConfig.tickMs, m_clock.elapsed());
+
+    // 定时器随工作对象一起moveToThread，第一次接管连接时在Reactor线程中启动
+    m_idleTimer->setTimerType(Qt::CoarseTimer);
+    m_idleTimer->setInterval(static_cast<int>(m_idleConfig.tickMs));
+    connect(m_idleTimer, &QTimer::timeout, this, &ReactorWorker::handleIdleTick);
+}
+
+void ReactorWorker::setIdleConfig(const IdleTimeoutConfig &config) {
+    m_idleConfig = config;
+    m_idleWheel = IdleWheel(config.tickMs, m_clock.elapsed());
+    m_idleTimer->setInterval(static_cast<int>(m_idleWheel.tickMs()));
+}
+
+void ReactorWorker::adoptDescriptor(qintptr socketDescriptor, quint32 clientId) {
+    // ✅ 套接字在Reactor线程中创建，线程亲和性天然正确，无需moveToThread
+    QTcpSocket *socket = new QTcpSocket(this);
+    if (!socket->setSocketDescriptor(socketDescriptor)) {
+        NETLOG_ERROR(NetLogCategory::Error, "Reactor %d 无法接管套接字描述符 %d", m_index, socketDescriptor);
+        m_metrics.connections->add(-1);
+        m_metrics.acceptFailures->increment();
+        delete socket;
+        return;
+    }
+
+    adoptSocket(socket, clientId);
+}
+
+void ReactorWorker::adoptSocket(QTcpSocket *socket, quint32 clientId) {
+    ConnectionState state;
+    state.id = clientId;
+    state.socket = socket;
+    state.peerAddress = socket->peerAddress();
+    state.peerPort = socket->peerPort();
+    state.decoder = FrameDecoder(m_framingMode);
+    state.outbound = OutboundQueue(m_outboundConfig);
+    state.lastActivityMs = m_clock.elapsed();
+    const ConnectionHandle handle = m_connections.insert(std::move(state));
+
+    // ❌ 原来：读缓冲区不限大小，暂停读取后QTcpSocket仍把内核数据全部搬进自己的缓冲区，
+    //    TCP窗口始终打开，对端可以无限发送
+    // ✅ 现在：读缓冲区以高水位为上限，缓冲区满时Qt停止从内核读取，由TCP流控限制对端
+    socket->setReadBufferSize(m_outboundConfig.highWaterMark);
+
+    if (m_idleConfig.enabled()) {
+        ConnectionState *connection = m_connections.find(handle);
+        connection->idleTimer = m_idleWheel.arm(nextIdleDeadline(*connection, connection->lastActivityMs), handle);
+        if (!m_idleTimer->isActive()) {
+            m_idleTimer->start();
+        }
+    }
+
+    // 连接客户端信号
+    connect(socket, &QTcpSocket::readyRead,
+            this, [this, handle]() { handleReadyRead(handle); }, Qt::QueuedConnection);
+    connect(socket, &QTcpSocket::disconnected,
+            this, [this, handle]() { handleDisconnected(handle); }, Qt::QueuedConnection);
+    connect(socket, &QAbstractSocket::errorOccurred,
+            this, [this, handle](QAbstractSocket::SocketError error) { handleSocketError(handle, error); });
+    connect(socket, &QTcpSocket::bytesWritten,
+            this, [this, handle](qint64 bytes) { handleBytesWritten(handle, bytes); });
+    m_metrics.accepted->increment();
+
+    ConnectionState *connection = m_connections.find(handle);
+    NETLOG_INFO(NetLogCategory::Connection, "新的客户端连接 - 客户端 %a:%d (ID:%d)",
+                connection->peerAddress.toIPv4Address(), connection->peerPort, clientId);
+
+    // 发送欢迎消息（长度前缀模式下客户端只期望回显帧，不发送文本欢迎）
+    if (m_framingMode == FramingMode::LineDelimited) {
+        connection->outbound.enqueue(welcomeMessage(clientId));
+        connection->outbound.flush(socket);
+        updateQueueGauge(connection);
+    }
+
+    NETLOG_DEBUG(NetLogCategory::Debug, "已发送欢迎消息给客户端 %d，Reactor: %d", clientId, m_index);
+}
+
+void ReactorWorker::handleReadyRead(ConnectionHandle handle) {
+    ConnectionState *connection = m_connections.find(handle);
+    if (!connection) {
+        // 排队的readyRead可能晚于断开处理到达，旧句柄已失效
+        NETLOG_DEBUG(NetLogCategory::Debug, "handleReadyRead() called for a closed connection");
+        return;
+    }
+
+    const quint32 clientId = connection->id;
+    QTcpSocket *client = connection->socket;
+    NETLOG_DEBUG(NetLogCategory::Debug, "handleReadyRead() called for client %d", clientId);
+
+    // 读取已暂停：数据先积在QTcpSocket读缓冲区，达到setReadBufferSize()上限后留在内核中，
+    // TCP窗口随之收缩，客户端放慢发送
+    if (connection->outbound.readsPaused()) {
+        return;
+    }
+
+    const qint64 startNs = m_clock.nsecsElapsed();
+    FrameDecoder &decoder = connection->decoder;
+    QByteArray &response = connection->txBuffer;
+    response.resize(0);     // resize而不是clear()，保留已分配的容量
+
+    // 一个时间戳服务本次读事件的所有帧
+    const int now = QTime::currentTime().msecsSinceStartOfDay();
+    qint64 received = 0;
+    qint64 frames = 0;
+
+    // 缓冲区可能小于内核中待读数据，循环直到读空
+    for (;;) {
+        const qint64 bytes = decoder.readFrom(client);
+        received += bytes;
+
+        FrameView frame;
+        while (decoder.next(&frame)) {
+            ++frames;
+            NETLOG_DATA("接收数据，客户端ID: %d - %x", frame.data, frame.size, clientId);
+
+            appendFrameResponse(decoder.mode(), frame, now, &response);
+        }
+
+        if (decoder.hasError()) {
+            NETLOG_ERROR(NetLogCategory::Error, "客户端 %d 帧超过最大长度 %d 字节，断开连接",
+                         clientId, decoder.maxFrameSize());
+            client->abort();
+            return;
+        }
+        if (bytes == 0 || client->bytesAvailable() == 0) {
+            break;
+        }
+    }
+
+    if (received == 0) {
+        NETLOG_DEBUG(NetLogCategory::Debug, "No data available for client %d", clientId);
+        return;
+    }
+
+    connection->bytesIn += received;
+    connection->framesIn += frames;
+    ++connection->readEvents;
+    connection->lastActivityMs = startNs / 1000000;
+    if (connection->heartbeatPending) {
+        connection->heartbeatPending = false;
+        m_metrics.nearTimeout->add(-1);
+    }
+    m_metrics.bytesIn->increment(static_cast<quint64>(received));
+    m_metrics.framesIn->increment(static_cast<quint64>(frames));
+
+    if (!response.isEmpty()) {
+        NETLOG_DATA("发送响应，客户端ID: %d - %x", response.constData(), response.size(), clientId);
+
+        BackpressureAction action = connection->outbound.enqueue(response);
+        if (action != BackpressureAction::Disconnect) {
+            const BackpressureAction flushAction = connection->outbound.flush(client);
+            if (flushAction != BackpressureAction::None) {
+                action = flushAction;
+            }
+        }
+        m_metrics.framesOut->increment(static_cast<quint64>(frames));
+        applyBackpressure(handle, action);
+    }
+
+    m_metrics.readLatency->observe(m_clock.nsecsElapsed() - startNs);
+}
+
+void ReactorWorker::handleBytesWritten(ConnectionHandle handle, qint64 bytes) {
+    m_metrics.bytesOut->increment(static_cast<quint64>(bytes));
+
+    ConnectionState *connection = m_connections.find(handle);
+    if (!connection) {
+        return;
+    }
+
+    applyBackpressure(handle, connection->outbound.flush(connection->socket));
+}
+
+void ReactorWorker::applyBackpressure(ConnectionHandle handle, BackpressureAction action) {
+    ConnectionState *connection = m_connections.find(handle);
+    if (!connection) {
+        return;
+    }
+
+    switch (action) {
+    case BackpressureAction::None:
+        break;
+    case BackpressureAction::PauseReads:
+        NETLOG_WARNING(NetLogCategory::Connection, "客户端 %d 发送队列超过高水位 (%d 字节)，暂停读取",
+                       connection->id, connection->outbound.queuedBytes());
+        break;
+    case BackpressureAction::ResumeReads:
+        NETLOG_INFO(NetLogCategory::Connection, "客户端 %d 发送队列低于低水位，恢复读取", connection->id);
+        // 暂停期间到达的数据不会再触发readyRead，需要主动处理
+        if (connection->socket->bytesAvailable() > 0) {
+            QMetaObject::invokeMethod(this, [this, handle]() { handleReadyRead(handle); }, Qt::QueuedConnection);
+        }
+        break;
+    case BackpressureAction::Disconnect:
+        NETLOG_WARNING(NetLogCategory::Connection, "客户端 %d 跟不上发送速度 (排队 %d 字节)，断开连接",
+                       connection->id, connection->outbound.queuedBytes());
+        m_metrics.slowConsumerDisconnects->increment();
+        connection->outbound.clear();
+        connection->socket->abort();
+        break;
+    }
+
+    updateQueueGauge(connection);
+}
+
+// 只累加本连接队列深度的变化量，抓取时不需要遍历连接
+void ReactorWorker::updateQueueGauge(ConnectionState *connection) {
+    const qint64 queued = connection->outbound.queuedBytes();
+    if (queued != connection->reportedQueuedBytes) {
+        m_metrics.queuedBytes->add(queued - connection->reportedQueuedBytes);
+        connection->reportedQueuedBytes = queued;
+    }
+}
+
+void ReactorWorker::handleDisconnected(ConnectionHandle handle) {
+    ConnectionState *connection = m_connections.find(handle);
+    if (!connection) {
+        NETLOG_DEBUG(NetLogCategory::Debug, "handleDisconnected() called for an unknown connection");
+        return;
+    }
+
+    NETLOG_INFO(NetLogCategory::Connection, "客户端断开连接 - 客户端 %a:%d (ID:%d)",
+                connection->peerAddress.toIPv4Address(), connection->peerPort, connection->id);
+
+    QTcpSocket *client = connection->socket;
+    if (connection->idleTimer != IdleWheel::kInvalidTimer) {
+        m_idleWheel.cancel(connection->idleTimer);
+    }
+    if (connection->heartbeatPending) {
+        m_metrics.nearTimeout->add(-1);
+    }
+    m_metrics.queuedBytes->add(-connection->reportedQueuedBytes);
+    m_connections.remove(handle);
+    m_metrics.connections->add(-1);
+
+    NETLOG_DEBUG(NetLogCategory::Debug, "Reactor %d current connected clients count: %d",
+                 m_index, m_connections.size());
+
+    client->deleteLater();
+}
+
+void ReactorWorker::handleIdleTick() {
+    const qint64 now = m_clock.elapsed();
+    m_expiredTimers.clear();
+    if (m_idleWheel.advance(now, &m_expiredTimers) == 0) {
+        return;
+    }
+
+    for (ConnectionHandle handle : m_expiredTimers) {
+        ConnectionState *connection = m_connections.find(handle);
+        if (!connection) {
+            continue;
+        }
+        connection->idleTimer = IdleWheel::kInvalidTimer;
+
+        // 定时器到期时才检查活动时间：期间有数据到达的连接只是被重新挂回时间轮
+        const qint64 idle = now - connection->lastActivityMs;
+        const IdleAction action = idleActionFor(m_idleConfig, idle);
+        if (action == IdleAction::Disconnect) {
+            NETLOG_WARNING(NetLogCategory::Connection, "客户端 %d 空闲 %d 毫秒，断开连接", connection->id, idle);
+            m_metrics.idleDisconnects->increment();
+            connection->outbound.clear();
+            updateQueueGauge(connection);
+            connection->socket->abort();    // 清理由handleDisconnected完成
+            continue;
+        }
+
+        if (action == IdleAction::SendHeartbeat) {
+            if (!connection->heartbeatPending) {
+                connection->heartbeatPending = true;
+                m_metrics.nearTimeout->add(1);
+            }
+            sendHeartbeat(handle);
+            connection = m_connections.find(handle);
+        }
+
+        connection->idleTimer = m_idleWheel.arm(nextIdleDeadline(*connection, now), handle);
+    }
+}
+
+void ReactorWorker::sendHeartbeat(ConnectionHandle handle) {
+    ConnectionState *connection = m_connections.find(handle);
+    NETLOG_DEBUG(NetLogCategory::Debug, "发送心跳给客户端 %d", connection->id);
+    m_metrics.heartbeats->increment();
+
+    BackpressureAction action = connection->outbound.enqueue(heartbeatMessage(m_framingMode));
+    if (action != BackpressureAction::Disconnect) {
+        const BackpressureAction flushAction = connection->outbound.flush(connection->socket);
+        if (flushAction != BackpressureAction::None) {
+            action = flushAction;
+        }
+    }
+    applyBackpressure(handle, action);
+}
+
+static const char *socketErrorText(QAbstractSocket::SocketError error) {
+    switch (error) {
+    case QAbstractSocket::ConnectionRefusedError:
+        return "连接被拒绝";
+    case QAbstractSocket::RemoteHostClosedError:
+        return "远程主机关闭连接";
+    case QAbstractSocket::HostNotFoundError:
+        return "主机未找到";
+    case QAbstractSocket::SocketTimeoutError:
+        return "连接超时";
+    case QAbstractSocket::NetworkError:
+        return "网络错误";
+    default:
+        return nullptr;     // 只有socket->errorString()能说明原因
+    }
+}
+
+void ReactorWorker::handleSocketError(ConnectionHandle handle, QAbstractSocket::SocketError error) {
+    ConnectionState *connection = m_connections.find(handle);
+    if (!connection) {
+        NETLOG_DEBUG(NetLogCategory::Debug, "handleSocketError() called for an unknown connection");
+        return;
+    }
+
+    const char *kind = QMetaEnum::fromType<QAbstractSocket::SocketError>().valueToKey(error);
+    m_metrics.socketError(kind ? kind : "UnknownSocketError")->increment();
+
+    // 常见错误的描述是静态字面量，日志记录中只保存指针
+    if (const char *text = socketErrorText(error)) {
+        NETLOG_ERROR(NetLogCategory::Error, "客户端 %d 发生错误: %s (SocketError %d)",
+                     connection->id, reinterpret_cast<qintptr>(text), static_cast<int>(error));
+        return;
+    }
+    // ❌ 原来：其他错误只记录"其他套接字错误"，丢掉了errorString()中的具体原因
+    // ✅ 现在：errorString()是动态字符串，不能交给只存指针的异步日志；这类错误少见，同步输出
+    qCritical() << "[ERROR] 客户端" << connection->id << "发生错误: 其他套接字错误:"
+                << connection->socket->errorString() << "(SocketError" << static_cast<int>(error) << ")";
+}
+
+void ReactorWorker::printClientInfo() {
+    if (m_connections.isEmpty()) {
+        return;
+    }
+
+    qDebug() << "[DEBUG] Reactor" << m_index << "客户端详细信息 (线程:" << QThread::currentThread() << "):";
+    // 稠密数组顺序遍历，不经过任何查找
+    for (const ConnectionState &connection : m_connections) {
+        qDebug() << "[DEBUG]   客户端" << connection.id << ":"
+                 << connection.peerAddress.toString()
+                 << ":" << connection.peerPort
+                 << "状态:" << connection.socket->state()
+                 << "收/发字节:" << connection.bytesIn << "/" << connection.outbound.flushedBytes()
+                 << "待发送:" << connection.outbound.queuedBytes() + connection.socket->bytesToWrite()
+                 << "丢弃消息:" << connection.outbound.droppedMessages()
+                 << "帧:" << connection.framesIn;
+    }
+}
+
+// ===== DebuggableNetworkServer =====
+
 DebuggableNetworkServer::DebuggableNetworkServer(QObject *parent)
-    : QTcpServer(parent), m_nextClientId(1), m_droneId(0) {
+    : QTcpServer(parent)
+    , m_inlineReactor(new ReactorWorker(0, this))
+    , m_ioBackend(IoBackend::Qt)
+    , m_reactorThreadCount(0)
+    , m_placement(ReactorPlacement::RoundRobin)
+    , m_nextReactor(0)
+    , m_framingMode(FramingMode::LineDelimited)
+    , m_metricsPort(0)
+    , m_nextClientId(1)
+    , m_droneId(0) {
 
     qDebug() << "[DEBUG] DebuggableNetworkServer constructor called";
     qDebug() << "[DEBUG] Server thread:" << QThread::currentThread();
 
-    // 设置调试定时器，每5秒打印一次状态信息
-    m_debugTimer.setInterval(5000);
+    // 调试定时器默认不启动，监控请使用指标端点
+    m_debugTimer.setInterval(0);
     connect(&m_debugTimer, &QTimer::timeout, this, &DebuggableNetworkServer::printDebugInfo);
+
+    MetricsRegistry::instance().gaugeFunction("netdebug_log_dropped_records",
+                                              "Async log records dropped because a ring was full", QByteArray(),
+                                              []() { return static_cast<double>(AsyncLogger::instance().droppedCount()); });
+}
+
+DebuggableNetworkServer::~DebuggableNetworkServer() {
+    stopReactorThreads();
+}
+
+void DebuggableNetworkServer::setReactorThreads(int threadCount, ReactorPlacement placement) {
+    if (isListening()) {
+        qWarning() << "[WARNING] setReactorThreads() must be called before startServer()";
+        return;
+    }
+
+    m_reactorThreadCount = qMax(0, threadCount);
+    m_placement = placement;
+}
+
+void DebuggableNetworkServer::setFramingMode(FramingMode mode) {
+    if (isListening()) {
+        qWarning() << "[WARNING] setFramingMode() must be called before startServer()";
+        return;
+    }
+
+    m_framingMode = mode;
+    m_inlineReactor->setFramingMode(mode);
+}
+
+void DebuggableNetworkServer::setOutboundConfig(const OutboundQueueConfig &config) {
+    if (isListening()) {
+        qWarning() << "[WARNING] setOutboundConfig() must be called before startServer()";
+        return;
+    }
+
+    m_outboundConfig = config;
+    m_inlineReactor->setOutboundConfig(config);
+}
+
+void DebuggableNetworkServer::setMetricsPort(quint16 port) {
+    m_metricsPort = port;
+}
+
+void DebuggableNetworkServer::setDebugDumpInterval(int intervalMs) {
+    m_debugTimer.setInterval(qMax(0, intervalMs));
+}
+
+void DebuggableNetworkServer::setIdleConfig(const IdleTimeoutConfig &config) {
+    if (isListening()) {
+        qWarning() << "[WARNING] setIdleConfig() must be called before startServer()";
+        return;
+    }
+
+    m_idleConfig = config;
+    m_inlineReactor->setIdleConfig(config);
+}
+
+void DebuggableNetworkServer::setIoBackend(IoBackend backend) {
+    if (isListening()) {
+        qWarning() << "[WARNING] setIoBackend() must be called before startServer()";
+        return;
+    }
+
+    m_ioBackend = backend;
 }
 
 bool DebuggableNetworkServer::startServer(quint16 port, int droneId) {
@@ -62,197 +688,256 @@ bool DebuggableNetworkServer::startServer(quint16 port, int droneId) {
 
     logConnectionInfo("信号槽连接已建立，准备监听");
 
+    // ✅ Reactor线程必须在listen()之前就绪，否则第一个连接可能无处分发
+    startReactorThreads();
+
     // 开始监听
     if (!listen(QHostAddress::Any, port)) {
         logConnectionInfo(QString("监听失败: %1").arg(errorString()));
         qCritical() << "[ERROR] Failed to start server on port" << port << ":" << errorString();
+        stopReactorThreads();
         return false;
     }
 
-    logConnectionInfo(QString("服务器成功启动，监听地址: %1:%2")
+    logConnectionInfo(QString("服务器成功启动，监听地址: %1:%2，Reactor线程数: %3")
                      .arg(serverAddress().toString())
-                     .arg(serverPort()));
+                     .arg(serverPort())
+                     .arg(m_reactors.size()));
+#ifdef Q_OS_LINUX
+    if (!m_nativeReactors.empty()) {
+        logConnectionInfo(QString("I/O后端: %1，原生Reactor线程数: %2")
+                         .arg(m_nativeReactors.front()->backendName())
+                         .arg(m_nativeReactors.size()));
+    }
+#endif
 
-    // 启动调试定时器
-    m_debugTimer.start();
+    if (m_metricsPort != 0) {
+        m_metricsEndpoint.reset(new MetricsEndpoint());
+        if (m_metricsEndpoint->listen(QHostAddress::LocalHost, m_metricsPort)) {
+            logConnectionInfo(QString("指标端点: http://127.0.0.1:%1/metrics").arg(m_metricsPort));
+        } else {
+            // 指标端点失败不影响业务端口
+            qWarning() << "[WARNING] Failed to start metrics endpoint on port" << m_metricsPort
+                       << ":" << m_metricsEndpoint->errorString();
+            m_metricsEndpoint.reset();
+        }
+    }
+
+    // 启动调试定时器（仅在显式开启时）
+    if (m_debugTimer.interval() > 0) {
+        m_debugTimer.start();
+    }
 
     return true;
 }
 
-void DebuggableNetworkServer::handleNewConnection() {
-    qDebug() << "[DEBUG] handleNewConnection() called!";
-    qDebug() << "[DEBUG] Current thread:" << QThread::currentThread();
-    qDebug() << "[DEBUG] Pending connections count:" << hasPendingConnections();
-
-    while (hasPendingConnections()) {
-        QTcpSocket *socket = nextPendingConnection();
-        if (!socket) {
-            qDebug() << "[DEBUG] nextPendingConnection returned null";
-            continue;
+void DebuggableNetworkServer::startReactorThreads() {
+    if (m_ioBackend != IoBackend::Qt) {
+        if (startNativeReactors()) {
+            return;
         }
+        qWarning() << "[WARNING] Native I/O backend unavailable, falling back to Qt sockets";
+        m_ioBackend = IoBackend::Qt;
+    }
 
-        quint32 clientId = m_nextClientId++;
-        m_clients.append(socket);
-        m_clientIds[socket] = clientId;
-
-        // 连接客户端信号
-        connect(socket, &QTcpSocket::readyRead,
-                this, &DebuggableNetworkServer::handleReadyRead, Qt::QueuedConnection);
-        connect(socket, &QTcpSocket::disconnected,
-                this, &DebuggableNetworkServer::handleDisconnected, Qt::QueuedConnection);
-        connect(socket, QOverload<QAbstractSocket::SocketError>::of(&QAbstractSocket::errorOccurred),
-                this, &DebuggableNetworkServer::handleSocketError);
-
-        logConnectionInfo(QString("新的客户端连接，客户端ID: %1").arg(clientId), socket);
+    for (int i = 0; i < m_reactorThreadCount; ++i) {
+        QThread *thread = new QThread();
+        thread->setObjectName(QString("reactor-%1").arg(i + 1));
 
-        // 发送欢迎消息
-        QString welcomeMsg = QString("欢迎使用网络服务器！客户端ID: %1\\n").arg(clientId);
-        socket->write(welcomeMsg.toUtf8());
+        // ✅ 工作对象不能有父对象，否则无法moveToThread
+        ReactorWorker *worker = new ReactorWorker(i + 1);
+        worker->setFramingMode(m_framingMode);
+        worker->setOutboundConfig(m_outboundConfig);
+        worker->setIdleConfig(m_idleConfig);
+        worker->moveToThread(thread);
+        connect(thread, &QThread::finished, worker, &QObject::deleteLater);
+        ThreadPlacement::instance().attach(thread, thread->objectName().toUtf8());
 
-        qDebug() << "[DEBUG] 已发送欢迎消息给客户端" << clientId;
+        m_reactorThreads.push_back(thread);
+        m_reactors.push_back(worker);
+        thread->start();
     }
 }
 
-void DebuggableNetworkServer::handleReadyRead() {
-    QTcpSocket *client = qobject_cast<QTcpSocket*>(sender());
-    if (!client) {
-        qDebug() << "[DEBUG] handleReadyRead() called but sender is not QTcpSocket";
-        return;
+// 原生后端没有单事件循环模式：线程数为0时也启动一个Reactor线程
+bool DebuggableNetworkServer::startNativeReactors() {
+#ifdef Q_OS_LINUX
+    const NativeBackend backend = m_ioBackend == IoBackend::IoUring ? NativeBackend::IoUring : NativeBackend::Epoll;
+    const FramingMode mode = m_framingMode;
+
+    // ✅ 与ReactorWorker共用同一组帧处理函数，两种后端的线上协议完全一致
+    NativeHandlers handlers;
+    handlers.onFrame = [mode](const FrameView &frame, int clockMs, QByteArray *response) {
+        appendFrameResponse(mode, frame, clockMs, response);
+    };
+    if (mode == FramingMode::LineDelimited) {
+        handlers.greeting = welcomeMessage;
     }
+    handlers.heartbeat = heartbeatMessage(mode);
 
-    quint32 clientId = m_clientIds.value(client, 0);
-    qDebug() << "[DEBUG] handleReadyRead() called for client" << clientId;
+    const int count = qMax(1, m_reactorThreadCount);
+    for (int i = 0; i < count; ++i) {
+        // 与Qt后端的Reactor线程同名，共用同一套放置规则
+        const QByteArray threadName = "reactor-" + QByteArray::number(i + 1);
+        handlers.threadStarted = [threadName]() { ThreadPlacement::instance().applyToCurrentThread(threadName); };
+        handlers.threadFinished = [threadName]() { ThreadPlacement::instance().threadFinished(threadName); };
+        std::unique_ptr<NativeReactor> reactor(
+            new NativeReactor(i + 1, backend, mode, m_outboundConfig, m_idleConfig, handlers));
+        QString errorMessage;
+        if (!reactor->start(&errorMessage)) {
+            qWarning() << "[WARNING] Failed to start" << reactor->backendName() << "reactor:" << errorMessage;
+            stopReactorThreads();
+            return false;
+        }
+        m_nativeReactors.push_back(std::move(reactor));
+    }
+    return true;
+#else
+    qWarning() << "[WARNING] Native I/O backends require Linux";
+    return false;
+#endif
+}
 
-    QByteArray data = client->readAll();
-    if (data.isEmpty()) {
-        qDebug() << "[DEBUG] No data available for client" << clientId;
-        return;
+void DebuggableNetworkServer::stopReactorThreads() {
+#ifdef Q_OS_LINUX
+    // stop()关闭其持有的所有描述符
+    for (const std::unique_ptr<NativeReactor> &reactor : m_nativeReactors) {
+        reactor->stop();
     }
+    m_nativeReactors.clear();
+#endif
 
-    logDataInfo(QString("接收数据，客户端ID: %1").arg(clientId), data);
+    for (QThread *thread : m_reactorThreads) {
+        thread->quit();
+        thread->wait();
+        delete thread;
+    }
 
-    // 处理数据（简单的回显）
-    QString response = QString("收到数据 [%1]: %2\\n")
-                      .arg(QDateTime::currentDateTime().toString("hh:mm:ss.zzz"))
-                      .arg(QString::fromUtf8(data).trimmed());
+    m_reactorThreads.clear();
+    m_reactors.clear();
+}
 
-    client->write(response.toUtf8());
+// Reactors为ReactorWorker*或unique_ptr<NativeReactor>的容器，两者都提供connectionCount()
+template <typename Reactors>
+auto DebuggableNetworkServer::selectReactor(const Reactors &reactors) -> decltype(&*reactors.front()) {
+    if (m_placement == ReactorPlacement::LeastLoaded) {
+        auto best = &*reactors.front();
+        for (const auto &reactor : reactors) {
+            if (reactor->connectionCount() < best->connectionCount()) {
+                best = &*reactor;
+            }
+        }
+        return best;
+    }
 
-    logDataInfo(QString("发送响应，客户端ID: %1").arg(clientId), response.toUtf8());
+    auto reactor = &*reactors[m_nextReactor % reactors.size()];
+    m_nextReactor = (m_nextReactor + 1) % reactors.size();
+    return reactor;
 }
 
-void DebuggableNetworkServer::handleDisconnected() {
-    QTcpSocket *client = qobject_cast<QTcpSocket*>(sender());
-    if (!client) {
-        qDebug() << "[DEBUG] handleDisconnected() called but sender is not QTcpSocket";
+void DebuggableNetworkServer::incomingConnection(qintptr socketDescriptor) {
+#ifdef Q_OS_LINUX
+    // 原生后端：描述符直接交给NativeReactor线程，不经过Qt事件循环
+    if (!m_nativeReactors.empty()) {
+        NativeReactor *reactor = selectReactor(m_nativeReactors);
+        reactor->reserveConnection();
+        reactor->adopt(socketDescriptor, m_nextClientId++);
         return;
     }
+#endif
 
-    quint32 clientId = m_clientIds.value(client, 0);
-    logConnectionInfo(QString("客户端断开连接，客户端ID: %1").arg(clientId), client);
-
-    m_clients.removeAll(client);
-    m_clientIds.remove(client);
+    // 单事件循环模式：走QTcpServer默认路径（pendingConnections + newConnection信号）
+    if (m_reactors.empty()) {
+        QTcpServer::incomingConnection(socketDescriptor);
+        return;
+    }
 
-    qDebug() << "[DEBUG] Current connected clients count:" << m_clients.size();
+    // 多Reactor模式：不在接受线程上创建QTcpSocket，直接把描述符交给目标线程
+    ReactorWorker *worker = selectReactor(m_reactors);
+    quint32 clientId = m_nextClientId++;
+    worker->reserveConnection();
 
-    client->deleteLater();
+    QMetaObject::invokeMethod(worker, [worker, socketDescriptor, clientId]() {
+        worker->adoptDescriptor(socketDescriptor, clientId);
+    }, Qt::QueuedConnection);
 }
 
-void DebuggableNetworkServer::handleSocketError(QAbstractSocket::SocketError error) {
-    QTcpSocket *client = qobject_cast<QTcpSocket*>(sender());
-    if (!client) {
-        qDebug() << "[DEBUG] handleSocketError() called but sender is not QTcpSocket";
-        return;
-    }
+void DebuggableNetworkServer::handleNewConnection() {
+    NETLOG_DEBUG(NetLogCategory::Debug, "handleNewConnection() called, pending connections: %d",
+                 hasPendingConnections());
 
-    quint32 clientId = m_clientIds.value(client, 0);
+    while (hasPendingConnections()) {
+        QTcpSocket *socket = nextPendingConnection();
+        if (!socket) {
+            NETLOG_DEBUG(NetLogCategory::Debug, "nextPendingConnection returned null");
+            continue;
+        }
 
-    QString errorString;
-    switch (error) {
-    case QAbstractSocket::ConnectionRefusedError:
-        errorString = "连接被拒绝";
-        break;
-    case QAbstractSocket::RemoteHostClosedError:
-        errorString = "远程主机关闭连接";
-        break;
-    case QAbstractSocket::HostNotFoundError:
-        errorString = "主机未找到";
-        break;
-    case QAbstractSocket::SocketTimeoutError:
-        errorString = "连接超时";
-        break;
-    case QAbstractSocket::NetworkError:
-        errorString = "网络错误";
-        break;
-    default:
-        errorString = client->errorString();
-        break;
+        m_inlineReactor->reserveConnection();
+        m_inlineReactor->adoptSocket(socket, m_nextClientId++);
     }
-
-    qCritical() << "[ERROR] 客户端" << clientId << "发生错误:" << errorString;
-    logConnectionInfo(QString("客户端错误: %1").arg(errorString), client);
 }
 
 void DebuggableNetworkServer::printDebugInfo() {
+    int totalClients = m_inlineReactor->connectionCount();
+    int nearTimeout = m_inlineReactor->nearTimeoutCount();
+    quint64 idleDisconnects = m_inlineReactor->idleDisconnects();
+    for (ReactorWorker *worker : m_reactors) {
+        totalClients += worker->connectionCount();
+        nearTimeout += worker->nearTimeoutCount();
+        idleDisconnects += worker->idleDisconnects();
+    }
+#ifdef Q_OS_LINUX
+    for (const std::unique_ptr<NativeReactor> &reactor : m_nativeReactors) {
+        totalClients += reactor->connectionCount();
+        nearTimeout += reactor->nearTimeoutCount();
+        idleDisconnects += reactor->idleDisconnects();
+    }
+#endif
+
     qDebug() << "[DEBUG] === 服务器状态信息 ===";
     qDebug() << "[DEBUG] 服务器运行状态:" << (isListening() ? "运行中" : "已停止");
     qDebug() << "[DEBUG] 监听端口:" << serverPort();
-    qDebug() << "[DEBUG] 连接的客户端数量:" << m_clients.size();
-
-    if (!m_clients.isEmpty()) {
-        qDebug() << "[DEBUG] 客户端详细信息:";
-        for (int i = 0; i < m_clients.size(); ++i) {
-            QTcpSocket *client = m_clients[i];
-            quint32 clientId = m_clientIds.value(client, 0);
-            qDebug() << "[DEBUG]   客户端" << clientId << ":"
-                     << client->peerAddress().toString()
-                     << ":" << client->peerPort()
-                     << "状态:" << client->state();
+    qDebug() << "[DEBUG] 连接的客户端数量:" << totalClients;
+    qDebug() << "[DEBUG] 接近超时(心跳未回应)的客户端:" << nearTimeout
+             << "空闲断开累计:" << idleDisconnects;
+
+#ifdef Q_OS_LINUX
+    // 原生Reactor的连接状态只属于其线程，这里只打印原子计数
+    for (const std::unique_ptr<NativeReactor> &reactor : m_nativeReactors) {
+        qDebug() << "[DEBUG]  " << reactor->backendName() << "Reactor" << reactor->index() << ":"
+                 << reactor->connectionCount() << "个连接,"
+                 << reactor->nearTimeoutCount() << "个接近超时,"
+                 << "已发心跳" << reactor->heartbeatsSent();
+    }
+#endif
+
+    if (m_reactors.empty()) {
+        m_inlineReactor->printClientInfo();
+    } else {
+        qDebug() << "[DEBUG] 分发策略:"
+                 << (m_placement == ReactorPlacement::LeastLoaded ? "最少连接" : "轮询");
+        for (ReactorWorker *worker : m_reactors) {
+            qDebug() << "[DEBUG]   Reactor线程" << worker->index() << ":"
+                     << worker->connectionCount() << "个连接,"
+                     << worker->nearTimeoutCount() << "个接近超时,"
+                     << "已发心跳" << worker->heartbeatsSent();
+
+            // ✅ 套接字详情必须在其所属线程中读取
+            QMetaObject::invokeMethod(worker, &ReactorWorker::printClientInfo, Qt::QueuedConnection);
         }
     }
 
+    qDebug() << "[DEBUG] 日志丢弃记录数:" << AsyncLogger::instance().droppedCount();
     qDebug() << "[DEBUG] 线程信息:" << QThread::currentThread();
     qDebug() << "[DEBUG] 当前时间:" << QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss.zzz");
     qDebug() << "[DEBUG] ========================";
 }
 
-void DebuggableNetworkServer::logConnectionInfo(const QString &message, QTcpSocket *socket) {
+// 仅用于启动/停止等冷路径消息（包含errorString()等动态文本）；热路径使用NETLOG_*宏
+void DebuggableNetworkServer::logConnectionInfo(const QString &message) {
     QString timestamp = QDateTime::currentDateTime().toString("hh:mm:ss.zzz");
-    QString logMessage;
-
-    if (socket) {
-        logMessage = QString("[%1] [CONNECTION] %2 - 客户端 %3:%4 (ID:%5)")
-                    .arg(timestamp)
-                    .arg(message)
-                    .arg(socket->peerAddress().toString())
-                    .arg(socket->peerPort())
-                    .arg(m_clientIds.value(socket, 0));
-    } else {
-        logMessage = QString("[%1] [CONNECTION] %2").arg(timestamp).arg(message);
-    }
-
-    qDebug() << logMessage;
-}
-
-void DebuggableNetworkServer::logDataInfo(const QString &message, const QByteArray &data) {
-    QString timestamp = QDateTime::currentDateTime().toString("hh:mm:ss.zzz");
-
-    if (!data.isEmpty()) {
-        // 创建数据的可读表示
-        QString dataStr;
-        if (data.size() > 64) {
-            dataStr = QString("数据大小: %1 字节 (前64字节: %2)")
-                     .arg(data.size())
-                     .arg(QString::fromUtf8(data.left(64)).toHex());
-        } else {
-            dataStr = QString("数据: %1").arg(QString::fromUtf8(data).toHex());
-        }
-
-        qDebug() << QString("[%1] [DATA] %2 - %3").arg(timestamp).arg(message).arg(dataStr);
-    } else {
-        qDebug() << QString("[%1] [DATA] %2 - (无数据)").arg(timestamp).arg(message);
-    }
+    qDebug() << QString("[%1] [CONNECTION] %2").arg(timestamp).arg(message);
 }
 
 // 使用示例
@@ -262,20 +947,98 @@ int main(int argc, char *argv[]) {
     // 设置调试输出格式
     qSetMessagePattern("[%{time yyyy-MM-dd hh:mm:ss.zzz}] [%{type}] %{function}(): %{message}");
 
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption reactorsOption("reactor-threads",
+                                      "Reactor工作线程数，0表示单事件循环 (默认0)", "count", "0");
+    QCommandLineOption placementOption("placement",
+                                       "连接分发策略: round-robin | least-loaded", "policy", "round-robin");
+    QCommandLineOption framingOption("framing",
+                                     "分帧方式: line | length (4字节大端长度前缀)", "mode", "line");
+    parser.addOption(reactorsOption);
+    parser.addOption(placementOption);
+    QCommandLineOption slowPolicyOption("slow-client",
+                                        "慢客户端策略: pause | drop-oldest | disconnect", "policy", "pause");
+    QCommandLineOption highWaterOption("high-water", "发送队列高水位(KB)", "kb", "256");
+    QCommandLineOption heartbeatOption("heartbeat", "空闲多少秒后发送心跳，0表示关闭", "seconds", "15");
+    QCommandLineOption idleTimeoutOption("idle-timeout", "空闲多少秒后断开，0表示关闭", "seconds", "60");
+    QCommandLineOption metricsPortOption("metrics-port", "Prometheus指标端口(仅本机)，0表示关闭", "port", "9464");
+    QCommandLineOption ioBackendOption("io-backend",
+                                       "已接受连接的I/O后端: qt | epoll | io_uring (后两者仅Linux)", "backend", "qt");
+    QCommandLineOption threadPlacementOption("thread-placement",
+                                             "线程放置配置(JSON)，覆盖环境变量中的同名规则", "file");
+    QCommandLineOption debugDumpOption("debug-dump", "每隔多少秒用qDebug打印状态，0表示关闭", "seconds", "0");
+    parser.addOption(framingOption);
+    parser.addOption(slowPolicyOption);
+    parser.addOption(highWaterOption);
+    parser.addOption(heartbeatOption);
+    parser.addOption(idleTimeoutOption);
+    parser.addOption(metricsPortOption);
+    parser.addOption(debugDumpOption);
+    parser.addOption(ioBackendOption);
+    parser.addOption(threadPlacementOption);
+    parser.process(app);
+
+    // ✅ 主线程（GUI应用中即GUI线程）也按名称放置，避免与网络线程争用同一核心
+    if (parser.isSet(threadPlacementOption)) {
+        QString placementError;
+        if (!ThreadPlacement::instance().loadFile(parser.value(threadPlacementOption), &placementError)) {
+            qCritical().noquote() << "[MAIN]" << placementError;
+            return 1;
+        }
+    }
+    ThreadPlacement::instance().applyToCurrentThread("gui");
+
     qDebug() << "[MAIN] 应用程序启动";
 
+    // ✅ 热路径日志由后台线程格式化输出
+    AsyncLogger::instance().start();
+
     DebuggableNetworkServer server;
 
+    int reactorThreads = parser.value(reactorsOption).toInt();
+    ReactorPlacement placement = parser.value(placementOption) == "least-loaded"
+                                 ? ReactorPlacement::LeastLoaded
+                                 : ReactorPlacement::RoundRobin;
+    server.setReactorThreads(reactorThreads, placement);
+    server.setFramingMode(parser.value(framingOption) == "length"
+                          ? FramingMode::LengthPrefixed
+                          : FramingMode::LineDelimited);
+
+    OutboundQueueConfig outboundConfig;
+    outboundConfig.highWaterMark = parser.value(highWaterOption).toLongLong() * 1024;
+    outboundConfig.lowWaterMark = outboundConfig.highWaterMark / 4;
+    const QString slowPolicy = parser.value(slowPolicyOption);
+    outboundConfig.policy = slowPolicy == "drop-oldest" ? SlowConsumerPolicy::DropOldest
+                          : slowPolicy == "disconnect"  ? SlowConsumerPolicy::Disconnect
+                                                        : SlowConsumerPolicy::PauseReads;
+    server.setOutboundConfig(outboundConfig);
+
+    IdleTimeoutConfig idleConfig;
+    idleConfig.heartbeatMs = parser.value(heartbeatOption).toLongLong() * 1000;
+    idleConfig.idleTimeoutMs = parser.value(idleTimeoutOption).toLongLong() * 1000;
+    server.setIdleConfig(idleConfig);
+    server.setMetricsPort(static_cast<quint16>(parser.value(metricsPortOption).toUInt()));
+    server.setDebugDumpInterval(parser.value(debugDumpOption).toInt() * 1000);
+
+    const QString ioBackend = parser.value(ioBackendOption);
+    server.setIoBackend(ioBackend == "epoll"    ? IoBackend::Epoll
+                      : ioBackend == "io_uring" ? IoBackend::IoUring
+                                                : IoBackend::Qt);
+
     // 尝试启动服务器
     quint16 port = 50001;
     if (!server.startServer(port, 1)) {
         qCritical() << "[MAIN] 服务器启动失败，退出应用程序";
+        AsyncLogger::instance().stop();
         return 1;
     }
 
     qDebug() << "[MAIN] 服务器启动成功，应用程序运行中...";
 
-    return app.exec();
+    const int exitCode = app.exec();
+    AsyncLogger::instance().stop();
+    return exitCode;
 }
 
-#include "network_debug_example.moc"
\ No newline at end of file
+#include "network_debug_example.moc"
@@ -0,0 +1,327 @@
+/**
+ * @file coroutine_sessions.cpp
+ * @brief 每个客户端一个C++20协程的网络服务器示例
+ *
+ * GoodNetworkServer和DebuggableNetworkServer把一个连接的处理拆散在readyRead、
+ * disconnected、errorOccurred等槽中，连接状态放在以套接字或句柄为键的表里。
+ * 这里每个会话是一个协程：读帧、回复、心跳和空闲断开按顺序写在一个循环中，
+ * 解码器、发送队列和计时状态都在协程帧上，服务器不持有任何按连接查找的映射表。
+ *
+ * 协程帧从固定大小的SessionFramePool分配，会话数有上限；
+ * 帧大小、峰值会话数和拒绝次数通过MetricsRegistry导出（--metrics-port）。
+ * 解码器缓冲区和发送队列不在池中，按会话汇总的字节数另外导出；每个会话的QTimer不计入。
+ *
+ * 需要以C++20编译（-std=c++20），否则只输出提示并退出。
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QHostAddress>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTime>
+#include <QDebug>
+#include <memory>
+
+#include "../network-performance/coroutine_session.h"
+#include "../network-performance/frame_decoder.h"
+#include "../network-performance/metrics.h"
+#include "../network-performance/outbound_queue.h"
+#include "../network-performance/reactor_metrics.h"
+#include "../network-performance/timing_wheel.h"
+
+#ifdef NETDEBUG_HAVE_COROUTINES
+
+/**
+ * @brief 协程会话服务器：在创建它的线程的事件循环上运行全部会话
+ *
+ * 会话协程是成员函数，协程帧通过sessionFramePool()分配。
+ */
+class CoroutineNetworkServer {
+public:
+    CoroutineNetworkServer(size_t maxSessions, size_t frameBlockSize)
+        : m_framePool(maxSessions, frameBlockSize)
+        , m_server(new QTcpServer())
+        , m_metrics("coroutine") {
+        m_clock.start();
+        QObject::connect(m_server, &QTcpServer::newConnection, m_server, [this]() { acceptPending(); });
+
+        // 抓取端点与会话在同一线程，直接读取池统计即可
+        MetricsRegistry &metrics = MetricsRegistry::instance();
+        metrics.gaugeFunction("netdebug_session_frame_bytes", "Coroutine frame size of one client session",
+                              m_metrics.labels, [this]() { return double(m_framePool.stats().frameBytes); });
+        metrics.gaugeFunction("netdebug_session_frames_live", "Session frames currently allocated",
+                              m_metrics.labels, [this]() { return double(m_framePool.stats().live); });
+        metrics.gaugeFunction("netdebug_session_frames_high_water", "Peak concurrently allocated session frames",
+                              m_metrics.labels, [this]() { return double(m_framePool.stats().highWater); });
+        metrics.gaugeFunction("netdebug_session_rejections", "Sessions not started because the frame pool was full",
+                              m_metrics.labels, [this]() { return double(m_framePool.stats().rejected); });
+        metrics.gaugeFunction("netdebug_session_buffer_bytes",
+                              "Decoder and outbound queue bytes held by live sessions outside the frame pool",
+                              m_metrics.labels, [this]() { return double(m_sessionBufferBytes); });
+        metrics.gaugeFunction("netdebug_session_buffer_bytes_high_water",
+                              "Peak decoder and outbound queue bytes held by live sessions",
+                              m_metrics.labels, [this]() { return double(m_sessionBufferHighWater); });
+    }
+
+    ~CoroutineNetworkServer() {
+        // ✅ 先删除服务器：已接受的套接字是它的子对象，销毁时每个等待中的会话被恢复并结束，
+        //    协程帧在池析构之前全部归还
+        delete m_server;
+        m_server = nullptr;
+
+        const SessionFrameStats &stats = m_framePool.stats();
+        qDebug() << "[DEBUG] Coroutine sessions: started" << stats.started << "finished" << stats.finished
+                 << "rejected" << stats.rejected << "peak" << stats.highWater
+                 << "frame bytes" << stats.frameBytes << "/" << stats.blockBytes
+                 << "peak buffer bytes" << m_sessionBufferHighWater;
+    }
+
+    CoroutineNetworkServer(const CoroutineNetworkServer &) = delete;
+    CoroutineNetworkServer &operator=(const CoroutineNetworkServer &) = delete;
+
+    void setFramingMode(FramingMode mode) { m_framingMode = mode; }
+    void setOutboundConfig(const OutboundQueueConfig &config) { m_outboundConfig = config; }
+    void setIdleConfig(const IdleTimeoutConfig &config) { m_idleConfig = config; }
+
+    bool startServer(quint16 port) {
+        if (!m_server->listen(QHostAddress::Any, port)) {
+            qCritical() << "[ERROR] Failed to start coroutine server:" << m_server->errorString();
+            return false;
+        }
+        qDebug() << "[DEBUG] Coroutine server listening on port" << m_server->serverPort()
+                 << "max sessions" << m_framePool.maxSessions();
+        return true;
+    }
+
+    SessionFramePool &sessionFramePool() { return m_framePool; }
+
+private:
+    void acceptPending() {
+        while (QTcpSocket *client = m_server->nextPendingConnection()) {
+            m_metrics.accepted->increment();
+            if (runSession(client, ++m_nextClientId).started()) {
+                continue;
+            }
+
+            // 协程帧分配失败时协程体不会执行，套接字仍归这里处理
+            m_metrics.acceptFailures->increment();
+            if (m_framePool.stats().oversized > 0) {
+                qCritical() << "[ERROR] Session frame of" << m_framePool.stats().frameBytes
+                            << "bytes does not fit in" << m_framePool.stats().blockBytes << "byte blocks";
+            } else {
+                qWarning() << "[WARNING] Session limit reached, rejecting client" << m_nextClientId;
+            }
+            client->abort();
+            client->deleteLater();
+        }
+    }
+
+    // 把会话当前的缓冲区字节数计入汇总；*accounted是该会话上次计入的值
+    void accountSessionBuffers(qint64 current, qint64 *accounted) {
+        m_sessionBufferBytes += current - *accounted;
+        m_sessionBufferHighWater = qMax(m_sessionBufferHighWater, m_sessionBufferBytes);
+        *accounted = current;
+    }
+
+    // ❌ 原来：状态在ConnectionState/ClientProcessingContext中，按句柄或套接字查表，分散在多个槽里
+    // ✅ 现在：一个连接的全部逻辑按顺序写在一个协程中
+    SessionTask runSession(QTcpSocket *client, quint32 clientId) {
+        // 接受时缓存对端地址，套接字关闭后日志仍然可用
+        const QString peer = client->peerAddress().toString() + QLatin1Char(':') + QString::number(client->peerPort());
+        AsyncSocket socket(client, m_framingMode, m_outboundConfig);
+        m_metrics.connections->add(1);
+        qDebug() << "[DEBUG] Session" << clientId << "started for" << peer;
+
+        const char *endReason = "closed by peer";
+        qint64 accountedBytes = 0;
+
+        // ❌ 原来：忽略欢迎消息的写入结果，对端已经关闭时仍去读一个死套接字
+        // ✅ 现在：写入失败就不进入读循环，和循环中的写入失败一样经过下面的收尾统计
+        IoStatus welcomeStatus = IoStatus::Ok;
+        if (m_framingMode == FramingMode::LineDelimited) {
+            welcomeStatus = socket.write(QString("欢迎使用网络服务器！客户端ID: %1\n").arg(clientId).toUtf8());
+            accountSessionBuffers(socket.bufferedBytes(), &accountedBytes);
+            if (welcomeStatus != IoStatus::Ok) {
+                endReason = writeFailure(welcomeStatus);
+            }
+        }
+
+        qint64 lastActivityMs = m_clock.elapsed();
+        bool heartbeatPending = false;
+        QByteArray response;
+
+        while (welcomeStatus == IoStatus::Ok) {
+            int timeoutMs = -1;
+            if (m_idleConfig.enabled()) {
+                const qint64 now = m_clock.elapsed();
+                const qint64 deadline = nextIdleDeadline(m_idleConfig, lastActivityMs, heartbeatPending, now);
+                timeoutMs = static_cast<int>(qBound<qint64>(0, deadline - now, 24 * 3600 * 1000));
+            }
+
+            const ReadResult result = co_await socket.readFrame(timeoutMs);
+            accountSessionBuffers(socket.bufferedBytes(), &accountedBytes);
+
+            if (result.status == IoStatus::Timeout) {
+                const IdleAction action = idleActionFor(m_idleConfig, m_clock.elapsed() - lastActivityMs);
+                if (action == IdleAction::Disconnect) {
+                    m_metrics.idleDisconnects->increment();
+                    endReason = "idle timeout";
+                    socket.close();
+                    break;
+                }
+                if (action == IdleAction::SendHeartbeat) {
+                    if (!heartbeatPending) {
+                        heartbeatPending = true;
+                        m_metrics.nearTimeout->add(1);
+                    }
+                    m_metrics.heartbeats->increment();
+                    const IoStatus status = socket.write(m_framingMode == FramingMode::LengthPrefixed
+                                                             ? QByteArray(FrameDecoder::kLengthPrefixSize, '\0')
+                                                             : QByteArray("PING\n"));
+                    if (status != IoStatus::Ok) {
+                        endReason = writeFailure(status);
+                        break;
+                    }
+                }
+                continue;
+            }
+
+            if (result.status == IoStatus::ProtocolError) {
+                qWarning() << "[WARNING] Session" << clientId << "sent an oversized frame, disconnecting";
+                endReason = "protocol error";
+                if (socket.socket()) {
+                    socket.socket()->abort();
+                }
+                break;
+            }
+            if (result.status == IoStatus::Closed) {
+                break;
+            }
+
+            lastActivityMs = m_clock.elapsed();
+            if (heartbeatPending) {
+                heartbeatPending = false;
+                m_metrics.nearTimeout->add(-1);
+            }
+            m_metrics.framesIn->increment();
+            m_metrics.bytesIn->increment(static_cast<quint64>(result.frame.size));
+
+            response.clear();
+            if (m_framingMode == FramingMode::LengthPrefixed) {
+                appendLengthPrefixedFrame(response, result.frame.data, result.frame.size);
+            } else {
+                const FrameView text = trimmedFrame(result.frame);
+                response.append("收到数据 [");
+                appendClockTime(response, QTime::currentTime().msecsSinceStartOfDay());
+                response.append("]: ");
+                response.append(text.data, text.size);
+                response.append('\n');
+            }
+            m_metrics.framesOut->increment();
+            const IoStatus status = socket.write(response);
+            accountSessionBuffers(socket.bufferedBytes(), &accountedBytes);
+            if (status != IoStatus::Ok) {
+                endReason = writeFailure(status);
+                break;
+            }
+        }
+        accountSessionBuffers(0, &accountedBytes);
+
+        if (heartbeatPending) {
+            m_metrics.nearTimeout->add(-1);
+        }
+        m_metrics.bytesOut->increment(static_cast<quint64>(socket.outbound().flushedBytes()));
+        m_metrics.connections->add(-1);
+        qDebug() << "[DEBUG] Session" << clientId << "(" << peer << ") ended:" << endReason;
+    }
+
+    // 只有发送队列真正溢出才计为慢消费者，连接已关闭时写入失败不计
+    const char *writeFailure(IoStatus status) {
+        if (status == IoStatus::SlowConsumer) {
+            m_metrics.slowConsumerDisconnects->increment();
+            return "slow consumer";
+        }
+        return "write failed";
+    }
+
+    SessionFramePool m_framePool;       // 必须先于m_server构造、后于会话析构
+    QTcpServer *m_server;
+    ReactorMetrics m_metrics;
+    QElapsedTimer m_clock;
+    quint32 m_nextClientId = 0;
+    qint64 m_sessionBufferBytes = 0;        // 所有会话的AsyncSocket::bufferedBytes()之和
+    qint64 m_sessionBufferHighWater = 0;
+
+    FramingMode m_framingMode = FramingMode::LineDelimited;
+    OutboundQueueConfig m_outboundConfig;
+    IdleTimeoutConfig m_idleConfig;
+};
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption portOption("port", "监听端口 (默认50002)", "port", "50002");
+    QCommandLineOption framingOption("framing",
+                                     "分帧方式: line | length (4字节大端长度前缀)", "mode", "line");
+    QCommandLineOption maxSessionsOption("max-sessions", "同时存在的会话上限", "count", "10000");
+    QCommandLineOption frameBlockOption("frame-block", "每个会话协程帧的块大小(字节)", "bytes", "2048");
+    QCommandLineOption highWaterOption("high-water", "发送队列高水位(KB)，超过后暂停读取该客户端", "kb", "256");
+    QCommandLineOption heartbeatOption("heartbeat", "空闲多少秒后发送心跳，0表示关闭", "seconds", "15");
+    QCommandLineOption idleTimeoutOption("idle-timeout", "空闲多少秒后断开，0表示关闭", "seconds", "60");
+    QCommandLineOption metricsPortOption("metrics-port", "Prometheus指标端口(仅本机)，0表示关闭", "port", "9465");
+    parser.addOption(portOption);
+    parser.addOption(framingOption);
+    parser.addOption(maxSessionsOption);
+    parser.addOption(frameBlockOption);
+    parser.addOption(highWaterOption);
+    parser.addOption(heartbeatOption);
+    parser.addOption(idleTimeoutOption);
+    parser.addOption(metricsPortOption);
+    parser.process(app);
+
+    CoroutineNetworkServer server(parser.value(maxSessionsOption).toULongLong(),
+                                  parser.value(frameBlockOption).toULongLong());
+    server.setFramingMode(parser.value(framingOption) == "length"
+                          ? FramingMode::LengthPrefixed
+                          : FramingMode::LineDelimited);
+
+    OutboundQueueConfig outboundConfig;
+    outboundConfig.highWaterMark = parser.value(highWaterOption).toLongLong() * 1024;
+    outboundConfig.lowWaterMark = outboundConfig.highWaterMark / 4;
+    server.setOutboundConfig(outboundConfig);
+
+    IdleTimeoutConfig idleConfig;
+    idleConfig.heartbeatMs = parser.value(heartbeatOption).toLongLong() * 1000;
+    idleConfig.idleTimeoutMs = parser.value(idleTimeoutOption).toLongLong() * 1000;
+    server.setIdleConfig(idleConfig);
+
+    std::unique_ptr<MetricsEndpoint> metricsEndpoint;
+    const quint16 metricsPort = static_cast<quint16>(parser.value(metricsPortOption).toUInt());
+    if (metricsPort != 0) {
+        metricsEndpoint.reset(new MetricsEndpoint());
+        if (!metricsEndpoint->listen(QHostAddress::LocalHost, metricsPort)) {
+            qWarning() << "[WARNING] Metrics endpoint failed on port" << metricsPort
+                       << ":" << metricsEndpoint->errorString();
+            metricsEndpoint.reset();
+        }
+    }
+
+    if (!server.startServer(static_cast<quint16>(parser.value(portOption).toUInt()))) {
+        return 1;
+    }
+    return app.exec();
+}
+
+#else // !NETDEBUG_HAVE_COROUTINES
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    qCritical() << "[ERROR] coroutine_sessions需要C++20协程支持，请以-std=c++20编译";
+    return 1;
+}
+
+#endif // NETDEBUG_HAVE_COROUTINES
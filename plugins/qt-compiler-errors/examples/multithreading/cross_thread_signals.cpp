@@ -6,11 +6,35 @@
  */
 
 #include <QObject>
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QFutureInterface>
+#include <QFutureWatcher>
 #include <QThread>
 #include <QTcpServer>
 #include <QTcpSocket>
 #include <QTimer>
 #include <QDebug>
+#include <QHash>
+#include <QMetaMethod>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "../network-performance/buffer_pool.h"
+#include "../network-performance/copy_trace.h"
+#include "../network-performance/frame_decoder.h"
+#include "../network-performance/metrics.h"
+#include "../network-performance/outbound_queue.h"
+#include "../network-performance/thread_placement.h"
+#include "../network-performance/work_stealing_pool.h"
+
+// clientDataReady在复制统计构建中经排队连接送达界面线程，参数要能作为元类型复制
+NETDEBUG_DECLARE_TRACED_METATYPE(QByteArray)
+// 排队参数由Qt的元类型代码在堆上构造，分配次数要靠全局operator new钩子统计；整个程序只展开这一处
+NETDEBUG_DEFINE_COPY_TRACE_ALLOCATOR
 
 // 错误示例：跨线程信号槽连接问题
 class BadNetworkServer : public QObject {
@@ -67,46 +91,219 @@ void BadNetworkServer::handleNewConnection() {
     }
 }
 
+// 服务器启动结果：listening为false时error说明原因
+struct ServerStartup {
+    bool listening = false;
+    quint16 port = 0;
+    QString error;
+    qint64 latencyNs = 0;       // 从请求启动到listen()返回
+};
+
+// 启动耗时与结果计数，经MetricsRegistry以Prometheus格式暴露
+struct StartupMetrics {
+    Histogram *latency;
+    Counter *listening;
+    Counter *failed;
+    Counter *timedOut;
+    Counter *canceled;
+
+    static StartupMetrics &instance() {
+        static StartupMetrics metrics;
+        return metrics;
+    }
+
+private:
+    StartupMetrics() {
+        MetricsRegistry &metrics = MetricsRegistry::instance();
+        // 10us ~ 10s，按2倍递增
+        latency = metrics.histogram("netdebug_server_startup_seconds",
+                                    "Time from start request until the server is listening", QByteArray(),
+                                    Histogram::exponentialBounds(10000, 21), 1e-9);
+        const QByteArray help = "Server startup attempts by outcome";
+        listening = metrics.counter("netdebug_server_startups_total", help, metricLabel("result", "listening"));
+        failed = metrics.counter("netdebug_server_startups_total", help, metricLabel("result", "failed"));
+        timedOut = metrics.counter("netdebug_server_startups_total", help, metricLabel("result", "timeout"));
+        canceled = metrics.counter("netdebug_server_startups_total", help, metricLabel("result", "canceled"));
+    }
+};
+
+// 每客户端的处理状态：解码器只在该客户端的串行队列中访问，不需要加锁
+struct ClientProcessingContext {
+    quint64 id = 0;
+    std::shared_ptr<SerialQueue> queue;
+    FrameDecoder decoder;
+    std::atomic<int> inFlight{0};       // 已提交、工作线程尚未处理完的数据块
+    bool readsHeld = false;             // 处理积压时暂停读取，只在服务器线程中访问
+};
+
+// 每条解码出的消息在工作线程中调用一次，把回复追加到reply末尾（不追加表示不回复）；必须线程安全
+using ClientMessageHandler = std::function<void(const QByteArray &message, QByteArray *reply)>;
+
+// 一个数据块的处理结果，每个提交的数据块恰好产生一个
+struct ProcessedChunk {
+    quint64 clientId = 0;
+    int messages = 0;
+    QByteArray replies;                 // 按消息顺序首尾相接的回复
+    std::vector<int> replyEnds;         // 每条非空回复在replies中的结束位置
+    bool protocolError = false;
+
+    // resize而不是clear()：节点复用时保留回复缓冲区的容量
+    void reset(quint64 id) {
+        clientId = id;
+        messages = 0;
+        replies.resize(0);
+        replyEnds.clear();
+        protocolError = false;
+    }
+};
+
+// 一次读取交给工作线程的任务：挂在客户端的串行队列上解码，然后整个节点经ResultBatcher
+// 回到服务器线程，发送完回复后回到服务器的空闲链表。块链、回复缓冲区都随节点复用
+struct ChunkTask : SerialQueue::Node {
+    void run() override;
+
+    std::shared_ptr<ClientProcessingContext> context;
+    std::shared_ptr<const ClientMessageHandler> handler;
+    std::shared_ptr<ResultBatcher<ChunkTask *>> results;
+    PooledBuffer data;
+    ProcessedChunk result;
+};
+
 // 正确示例：使用Qt::QueuedConnection进行跨线程通信
+// 每个客户端一个协程、不需要按套接字查表的写法见coroutine_sessions.cpp（需要C++20）
 class GoodNetworkServer : public QObject {
     Q_OBJECT
 
 public:
     explicit GoodNetworkServer(QObject *parent = nullptr);
+    ~GoodNetworkServer() override;
+
+    const BufferPoolStats &bufferPoolStats() const { return m_bufferPool.stats(); }
+
+    // 只影响之后接受的连接；在startServer()之前调用
+    void setOutboundConfig(const OutboundQueueConfig &config) { m_outboundConfig = config; }
+
+    // 在服务器线程中调用；listen()返回后才完成promise，调用方已取消时不监听
+    void startServer(QFutureInterface<ServerStartup> promise, QElapsedTimer sinceRequest);
+
+    using MessageHandler = ClientMessageHandler;
+    void setMessageHandler(MessageHandler handler);
+    WorkStealingPoolStats processingStats() const { return m_processingPool->stats(); }
 
 public slots:
-    void startServer();
     void handleNewConnection();
     void handleClientDisconnected();
-    void processClientData();
+    // ✅ 所有发送都经过发送队列，不直接调用socket->write()
+    void sendToClient(QTcpSocket *client, const QByteArray &data);
 
 signals:
     void clientConnected(QTcpSocket *client);
-    void clientDataReady(QTcpSocket *client, QByteArray data);
+    // Traced<T>只在定义NETDEBUG_TRACE_COPIES的调试构建中统计参数复制，否则就是QByteArray
+    void clientDataReady(QTcpSocket *client, Traced<QByteArray> data);
 
 private:
+    void readClient(QTcpSocket *client);
+    void submitForProcessing(const std::shared_ptr<ClientProcessingContext> &context, PooledBuffer &&data);
+    // sendToClient的按字节区间版本：回复直接从节点的缓冲区拷入发送队列
+    void sendBytesToClient(QTcpSocket *client, const char *data, qint64 size);
+    void resumeBufferStarvedReads();
+    void processClientData(std::vector<ChunkTask *> &batch);
+    void processChunk(const ProcessedChunk &chunk);
+    void applyBackpressure(QTcpSocket *client, BackpressureAction action);
+
+    // 单个客户端最多积压的未处理数据块，超过后暂停读取
+    static constexpr int kMaxInFlightChunks = 64;
+
     QTcpServer *m_server;
     QList<QTcpSocket*> m_clients;
-    QMap<QTcpSocket*, QByteArray> m_clientBuffers;
+    // ✅ 接收缓冲区来自固定大小块的缓冲池，块链随复用的ChunkTask节点交给工作线程，解码后在那里归还，
+    //    稳态读取和提交都不分配内存，结果回送只有每批一个Qt排队事件
+    //    （缓冲池和节点必须先于m_processingPool声明，工作线程结束后才析构）
+    BufferPool m_bufferPool;
+    std::vector<std::unique_ptr<ChunkTask>> m_chunkTasks;
+    std::vector<ChunkTask *> m_freeChunkTasks;      // 只在服务器线程中取出和归还
+    QByteArray m_payload;           // 复用容量，clientDataReady的参数；只在信号有接收方时填充
+    qint64 m_reportedSlabs;
+    std::vector<quint64> m_bufferStarvedClients;    // 缓冲池耗尽时未读完的客户端
+    QMap<QTcpSocket*, OutboundQueue> m_outboundQueues;
+    OutboundQueueConfig m_outboundConfig;
+
+    // ✅ 解码和消息处理在工作窃取线程池中执行，网络线程只负责收发
+    std::unique_ptr<WorkStealingPool> m_processingPool;
+    std::shared_ptr<ResultBatcher<ChunkTask *>> m_processedChunks;
+    std::shared_ptr<const MessageHandler> m_messageHandler;
+    std::unordered_map<QTcpSocket*, std::shared_ptr<ClientProcessingContext>> m_processingContexts;
+    QHash<quint64, QTcpSocket*> m_clientsById;
+    quint64 m_nextClientId;
+    quint64 m_processedMessages;
 };
 
 GoodNetworkServer::GoodNetworkServer(QObject *parent)
-    : QObject(parent), m_server(new QTcpServer(this)) {
+    : QObject(parent)
+    , m_server(new QTcpServer(this))
+    , m_bufferPool(4096, 64, 16 * 1024)     // 4KB块，最多64MB
+    , m_reportedSlabs(0)
+    , m_processingPool(new WorkStealingPool())
+    , m_nextClientId(1)
+    , m_processedMessages(0) {
 
     // ✅ 正确：使用Qt::QueuedConnection确保跨线程安全
     connect(m_server, &QTcpServer::newConnection,
             this, &GoodNetworkServer::handleNewConnection, Qt::QueuedConnection);
+
+    // 工作线程的结果按批回到服务器线程
+    m_processedChunks = std::make_shared<ResultBatcher<ChunkTask *>>(
+        this, [this](std::vector<ChunkTask *> &batch) { processClientData(batch); });
+
+    // 默认逐行回显
+    setMessageHandler([](const QByteArray &message, QByteArray *reply) {
+        reply->append(message);
+        reply->append('\n');
+    });
+}
+
+GoodNetworkServer::~GoodNetworkServer() {
+    // 成员析构时线程池还要执行完已提交的任务，它们送回的结果不能再投递给正在销毁的服务器
+    m_processedChunks->cancel();
+}
+
+void GoodNetworkServer::setMessageHandler(MessageHandler handler) {
+    // 已提交的任务继续使用旧的处理函数
+    m_messageHandler = std::make_shared<const MessageHandler>(std::move(handler));
 }
 
-void GoodNetworkServer::startServer() {
+void GoodNetworkServer::startServer(QFutureInterface<ServerStartup> promise, QElapsedTimer sinceRequest) {
     qDebug() << "[DEBUG] Starting server in thread:" << QThread::currentThread();
 
+    // 超时或取消发生在线程启动之前：不再监听
+    if (promise.isCanceled()) {
+        qDebug() << "[DEBUG] Server start canceled before listen()";
+        promise.reportFinished();
+        return;
+    }
+
+    ServerStartup startup;
     if (!m_server->listen(QHostAddress::Any, 50001)) {
-        qCritical() << "Failed to start server:" << m_server->errorString();
+        startup.error = m_server->errorString();
+        qCritical() << "Failed to start server:" << startup.error;
+        StartupMetrics::instance().failed->increment();
+    } else if (promise.isCanceled()) {
+        // 调用方在listen()期间放弃了等待，不保留无人使用的监听端口
+        m_server->close();
+        qDebug() << "[DEBUG] Server start canceled during listen(), closed listener";
+        promise.reportFinished();
         return;
+    } else {
+        startup.listening = true;
+        startup.port = m_server->serverPort();
+        startup.latencyNs = sinceRequest.nsecsElapsed();
+        StartupMetrics::instance().latency->observe(startup.latencyNs);
+        StartupMetrics::instance().listening->increment();
+        qDebug() << "Server started on port" << startup.port;
     }
 
-    qDebug() << "Server started on port 50001";
+    promise.reportResult(startup);
+    promise.reportFinished();
 }
 
 void GoodNetworkServer::handleNewConnection() {
@@ -119,7 +316,15 @@ void GoodNetworkServer::handleNewConnection() {
         }
 
         m_clients.append(client);
-        m_clientBuffers[client] = QByteArray();
+        m_outboundQueues.insert(client, OutboundQueue(m_outboundConfig));
+        // 读缓冲区有上限，暂停读取时Qt停止从内核读取，TCP流控才能把压力传回对端
+        client->setReadBufferSize(m_outboundConfig.highWaterMark);
+
+        auto context = std::make_shared<ClientProcessingContext>();
+        context->id = m_nextClientId++;
+        context->queue = std::make_shared<SerialQueue>(m_processingPool.get());
+        m_processingContexts.emplace(client, context);
+        m_clientsById.insert(context->id, client);
 
         qDebug() << "[DEBUG] Client connected from:"
                  << client->peerAddress().toString()
@@ -127,10 +332,16 @@ void GoodNetworkServer::handleNewConnection() {
 
         // ✅ 正确：使用Qt::QueuedConnection确保跨线程安全
         connect(client, &QTcpSocket::readyRead,
-                this, [this, client]() {
-                    QByteArray data = client->readAll();
-                    emit clientDataReady(client, data);
-                }, Qt::QueuedConnection);
+                this, [this, client]() { readClient(client); }, Qt::QueuedConnection);
+
+        // 由bytesWritten驱动继续发送排队数据
+        connect(client, &QTcpSocket::bytesWritten,
+                this, [this, client](qint64) {
+                    auto it = m_outboundQueues.find(client);
+                    if (it != m_outboundQueues.end()) {
+                        applyBackpressure(client, it->flush(client));
+                    }
+                });
 
         connect(client, &QTcpSocket::disconnected,
                 this, &GoodNetworkServer::handleClientDisconnected, Qt::QueuedConnection);
@@ -149,46 +360,291 @@ void GoodNetworkServer::handleClientDisconnected() {
     qDebug() << "[DEBUG] Client disconnected:" << client->peerAddress().toString();
 
     m_clients.removeAll(client);
-    m_clientBuffers.remove(client);
+    m_outboundQueues.remove(client);
+    // 已提交的数据块仍会处理完，结果到达时按客户端id找不到连接而被丢弃
+    auto context = m_processingContexts.find(client);
+    if (context != m_processingContexts.end()) {
+        m_clientsById.remove(context->second->id);
+        m_processingContexts.erase(context);
+    }
     client->deleteLater();
+
+    const BufferPoolStats &stats = m_bufferPool.stats();
+    qDebug() << "[DEBUG] Processed" << m_processedMessages << "messages, pool stolen tasks:"
+             << m_processingPool->stats().stolen;
+    qDebug() << "[DEBUG] Receive buffer pool: in use" << stats.chunksInUse << "/" << stats.totalChunks
+             << "chunks, high water" << stats.highWaterChunks;
 }
 
-void GoodNetworkServer::processClientData() {
-    qDebug() << "[DEBUG] Processing client data in thread:" << QThread::currentThread();
+void GoodNetworkServer::readClient(QTcpSocket *client) {
+    auto it = m_outboundQueues.find(client);
+    if (it == m_outboundQueues.end() || it->readsPaused()) {
+        // 暂停读取期间数据积在读缓冲区，达到setReadBufferSize()上限后由TCP流控限制对端
+        return;
+    }
+
+    auto processing = m_processingContexts.find(client);
+    if (processing == m_processingContexts.end() || processing->second->readsHeld) {
+        return;
+    }
+    std::shared_ptr<ClientProcessingContext> context = processing->second;     // 直接连接的接收方可能断开客户端
+    static const QMetaMethod dataReadySignal = QMetaMethod::fromSignal(&GoodNetworkServer::clientDataReady);
+
+    // ❌ 原来：client->readAll()每次readyRead都分配一个新的QByteArray
+    // ✅ 现在：读入缓冲池块链（大数据跨块串联），整条块链交给工作线程逐段解码，不再复制成连续内存
+    do {
+        PooledBuffer chain(&m_bufferPool);
+        if (chain.readFrom(client) < 0) {
+            qWarning() << "[WARNING] Read failed:" << client->errorString();
+            return;
+        }
+        if (chain.isEmpty()) {
+            // 缓冲池耗尽：剩余数据留在读缓冲区，工作线程归还块后再读
+            if (client->bytesAvailable() > 0) {
+                m_bufferStarvedClients.push_back(context->id);
+            }
+            break;
+        }
+
+        // 只有信号有接收方时才复制成连续的QByteArray
+        if (isSignalConnected(dataReadySignal)) {
+            chain.copyTo(&m_payload);
+            emit clientDataReady(client, NETDEBUG_TRACED(m_payload, "GoodNetworkServer::clientDataReady"));
+        }
+        submitForProcessing(context, std::move(chain));
+    } while (client->bytesAvailable() > 0 && !it->readsPaused() && !context->readsHeld);
+
+    const BufferPoolStats &stats = m_bufferPool.stats();
+    if (stats.slabAllocations != m_reportedSlabs) {
+        m_reportedSlabs = stats.slabAllocations;
+        qDebug() << "[DEBUG] Receive buffer pool grew to" << stats.totalChunks << "chunks of"
+                 << stats.chunkSize << "bytes, high water" << stats.highWaterChunks;
+    }
+}
 
-    // 这个槽可以在不同线程中安全地处理数据
+void GoodNetworkServer::sendToClient(QTcpSocket *client, const QByteArray &data) {
+    sendBytesToClient(client, data.constData(), data.size());
 }
 
-// 线程管理的正确示例
-class NetworkThread : public QThread {
-    Q_OBJECT
+void GoodNetworkServer::sendBytesToClient(QTcpSocket *client, const char *data, qint64 size) {
+    auto it = m_outboundQueues.find(client);
+    if (it == m_outboundQueues.end()) {
+        qWarning() << "[WARNING] sendToClient() called for an unknown client";
+        return;
+    }
 
-public:
-    explicit NetworkThread(QObject *parent = nullptr)
-        : QThread(parent) {}
+    BackpressureAction action = it->enqueue(data, size);
+    if (action != BackpressureAction::Disconnect) {
+        const BackpressureAction flushAction = it->flush(client);
+        if (flushAction != BackpressureAction::None) {
+            action = flushAction;
+        }
+    }
+    applyBackpressure(client, action);
+}
+
+void GoodNetworkServer::applyBackpressure(QTcpSocket *client, BackpressureAction action) {
+    switch (action) {
+    case BackpressureAction::None:
+        break;
+    case BackpressureAction::PauseReads:
+        qDebug() << "[DEBUG] Client send queue above high water mark, pausing reads:"
+                 << client->peerAddress().toString();
+        break;
+    case BackpressureAction::ResumeReads:
+        qDebug() << "[DEBUG] Client send queue drained, resuming reads:" << client->peerAddress().toString();
+        if (client->bytesAvailable() > 0) {
+            QMetaObject::invokeMethod(client, [this, client]() { readClient(client); }, Qt::QueuedConnection);
+        }
+        break;
+    case BackpressureAction::Disconnect:
+        qWarning() << "[WARNING] Client cannot keep up, disconnecting:" << client->peerAddress().toString();
+        m_outboundQueues[client].clear();
+        client->abort();
+        break;
+    }
+}
 
-protected:
-    void run() override {
-        qDebug() << "[DEBUG] Network thread started:" << QThread::currentThread();
+// 在客户端的串行队列中执行：块链逐段送入该客户端的解码器，对每条完整消息调用handler。
+// 读完的块立即归还缓冲池（跨线程归还，由网络线程下次申请时回收）
+static void decodeMessages(FrameDecoder &decoder, PooledBuffer &data,
+                           const GoodNetworkServer::MessageHandler &handler, ProcessedChunk *chunk) {
+    const char *segment = nullptr;
+    qint64 segmentSize = 0;
+    while (data.peekFront(&segment, &segmentSize)) {
+        qint64 contiguous = 0;
+        char *target = decoder.writePointer(&contiguous);
+        const qint64 bytes = qMin(contiguous, segmentSize);
+        std::memcpy(target, segment, static_cast<size_t>(bytes));
+        decoder.commit(bytes);
+        data.consume(bytes);
+
+        FrameView frame;
+        while (decoder.next(&frame)) {
+            // fromRawData不复制：消息只在handler调用期间有效
+            handler(QByteArray::fromRawData(frame.data, frame.size), &chunk->replies);
+            ++chunk->messages;
+            if (chunk->replies.size() > (chunk->replyEnds.empty() ? 0 : chunk->replyEnds.back())) {
+                chunk->replyEnds.push_back(chunk->replies.size());
+            }
+        }
+        if (decoder.hasError()) {
+            chunk->protocolError = true;    // 缓冲区已满仍没有完整消息
+            return;
+        }
+    }
+}
 
-        // 在这个线程中创建网络服务器
-        GoodNetworkServer *server = new GoodNetworkServer();
+void ChunkTask::run() {
+    decodeMessages(context->decoder, data, *handler, &result);
+    data.clear();       // 协议错误时剩余的块也在这里归还
+    context->inFlight.fetch_sub(1, std::memory_order_relaxed);
+    results->push(this);
+}
 
-        // 将服务器移动到这个线程
-        server->moveToThread(this);
+void GoodNetworkServer::submitForProcessing(const std::shared_ptr<ClientProcessingContext> &context,
+                                            PooledBuffer &&data) {
+    // ❌ 原来：解码和处理都在网络线程中，一个大消息就会推迟所有套接字的读写
+    // ✅ 现在：交给该客户端的串行队列，在线程池中执行；块链的所有权随任务转移，
+    //    网络线程之后的读取使用新的块，不会覆盖工作线程正在解码的数据
+    // ❌ 原来：每次读取make_shared一份块链，再构造捕获四个shared_ptr的std::function，都要分配
+    // ✅ 现在：从空闲链表取一个节点，只复制shared_ptr（引用计数）；节点数随积压增长，上限约为
+    //    客户端数×kMaxInFlightChunks，之后不再分配
+    ChunkTask *task;
+    if (m_freeChunkTasks.empty()) {
+        m_chunkTasks.emplace_back(new ChunkTask());
+        task = m_chunkTasks.back().get();
+    } else {
+        task = m_freeChunkTasks.back();
+        m_freeChunkTasks.pop_back();
+    }
+    task->context = context;
+    task->handler = m_messageHandler;
+    task->results = m_processedChunks;
+    task->data = std::move(data);
+    task->result.reset(context->id);
+
+    context->inFlight.fetch_add(1, std::memory_order_relaxed);
+    context->queue->post(task);
+
+    if (context->inFlight.load(std::memory_order_relaxed) >= kMaxInFlightChunks) {
+        // 积压期间新数据停在读缓冲区；缓冲区到上限后Qt不再读内核，对端受TCP窗口限制
+        context->readsHeld = true;
+        qDebug() << "[DEBUG] Processing backlog for client" << context->id << ", pausing reads";
+    }
+}
 
-        // 连接信号
-        connect(this, &NetworkThread::startServerRequested, server, &GoodNetworkServer::startServer);
+void GoodNetworkServer::processClientData(std::vector<ChunkTask *> &batch) {
+    // 在服务器线程中执行：一次处理工作线程送回的整批结果，每个客户端的结果保持提交顺序
+    for (ChunkTask *task : batch) {
+        processChunk(task->result);
 
-        // 启动事件循环
-        exec();
+        // 放回空闲链表；释放对客户端上下文的引用，已断开客户端的解码器不必等节点复用才析构
+        task->context.reset();
+        task->handler.reset();
+        task->results.reset();
+        m_freeChunkTasks.push_back(task);
+    }
+
+    // 这批结果对应的块已在工作线程中归还
+    resumeBufferStarvedReads();
+}
+
+void GoodNetworkServer::processChunk(const ProcessedChunk &chunk) {
+    QTcpSocket *client = m_clientsById.value(chunk.clientId);
+    if (!client) {
+        return;         // 结果到达前客户端已断开
+    }
 
-        qDebug() << "[DEBUG] Network thread ended";
-        server->deleteLater();
+    if (chunk.protocolError) {
+        qWarning() << "[WARNING] Undecodable client data, disconnecting:" << client->peerAddress().toString();
+        m_clientsById.remove(chunk.clientId);   // 同一批中该客户端后续的结果一并丢弃
+        client->abort();
+        return;
     }
 
-signals:
-    void startServerRequested();
+    m_processedMessages += chunk.messages;
+    int begin = 0;
+    for (int end : chunk.replyEnds) {
+        sendBytesToClient(client, chunk.replies.constData() + begin, end - begin);
+        begin = end;
+    }
+
+    auto processing = m_processingContexts.find(client);
+    if (processing != m_processingContexts.end() && processing->second->readsHeld
+        && processing->second->inFlight.load(std::memory_order_relaxed) <= kMaxInFlightChunks / 2) {
+        processing->second->readsHeld = false;
+        qDebug() << "[DEBUG] Processing backlog drained for client" << chunk.clientId << ", resuming reads";
+        if (client->bytesAvailable() > 0) {
+            QMetaObject::invokeMethod(client, [this, client]() { readClient(client); }, Qt::QueuedConnection);
+        }
+    }
+}
+
+void GoodNetworkServer::resumeBufferStarvedReads() {
+    std::vector<quint64> starved;
+    starved.swap(m_bufferStarvedClients);
+    for (quint64 clientId : starved) {
+        QTcpSocket *client = m_clientsById.value(clientId);
+        if (client && client->bytesAvailable() > 0) {
+            QMetaObject::invokeMethod(client, [this, client]() { readClient(client); }, Qt::QueuedConnection);
+        }
+    }
+}
+
+// 线程管理的正确示例
+class NetworkThread : public QThread {
+    Q_OBJECT
+
+public:
+    // ❌ 原来：服务器在run()中创建，启动线程的一方拿不到它，只能靠延时猜测何时就绪
+    // ✅ 现在：服务器在构造线程中创建并移入本线程，run()只运行默认事件循环
+    explicit NetworkThread(QObject *parent = nullptr)
+        : QThread(parent)
+        , m_server(new GoodNetworkServer()) {
+        m_server->moveToThread(this);
+        connect(this, &QThread::finished, m_server, &QObject::deleteLater);
+
+        // ❌ 原来：网络线程在各核心之间浮动，与渲染线程挤在相邻核心上时延迟抖动明显
+        // ✅ 现在：按名称"network"应用线程放置配置（CPU集合、调度策略），启动时报告实际位置
+        setObjectName("network");
+        ThreadPlacement::instance().attach(this, "network");
+    }
+
+    GoodNetworkServer *server() const { return m_server; }
+
+    /**
+     * @brief 请求服务器开始监听，返回在监听成功（或失败）时完成的future
+     *
+     * 可以在start()之前或之后调用：启动请求排队到服务器线程的事件循环中执行。
+     * timeoutMs > 0 时超时取消future；调用方也可以随时cancel()。
+     */
+    QFuture<ServerStartup> startServer(int timeoutMs) {
+        QFutureInterface<ServerStartup> promise;
+        promise.reportStarted();
+        QElapsedTimer sinceRequest;
+        sinceRequest.start();
+
+        GoodNetworkServer *server = m_server;
+        QMetaObject::invokeMethod(server, [server, promise, sinceRequest]() {
+            server->startServer(promise, sinceRequest);
+        }, Qt::QueuedConnection);
+
+        QFuture<ServerStartup> future = promise.future();
+        if (timeoutMs > 0) {
+            QTimer::singleShot(timeoutMs, this, [future]() mutable {
+                if (!future.isFinished() && !future.isCanceled()) {
+                    qCritical() << "[DEBUG] Network startup timeout";
+                    StartupMetrics::instance().timedOut->increment();
+                    future.cancel();
+                }
+            });
+        }
+        return future;
+    }
+
+private:
+    GoodNetworkServer *m_server;
 };
 
 // 线程启动同步的正确示例
@@ -198,9 +654,12 @@ class ThreadSynchronizationExample : public QObject {
 public:
     explicit ThreadSynchronizationExample(QObject *parent = nullptr);
 
+    // ✅ 调用方通过future（或networkStarted/networkError信号）得知就绪，不阻塞、不嵌套事件循环
+    QFuture<ServerStartup> networkReady() const { return m_startupWatcher.future(); }
+
 public slots:
-    void startNetworkService();
-    bool waitForNetworkCompletion(int timeoutMs = 5000);
+    void startNetworkService(int timeoutMs = 5000);
+    void cancelNetworkStartup();
 
 signals:
     void networkStarted();
@@ -208,19 +667,27 @@ signals:
     void componentsInitialized();
 
 private slots:
-    void onNetworkThreadStarted();
+    void onServerStartupFinished();
+    void onServerStartupCanceled();
     void onNetworkThreadFinished();
+    void onClientDataObserved(QTcpSocket *client, const Traced<QByteArray> &data);
 
 private:
     NetworkThread *m_networkThread;
+    QFutureWatcher<ServerStartup> m_startupWatcher;
     bool m_isInitialized;
+    qint64 m_observedBytes;
 };
 
 ThreadSynchronizationExample::ThreadSynchronizationExample(QObject *parent)
-    : QObject(parent), m_networkThread(nullptr), m_isInitialized(false) {
+    : QObject(parent), m_networkThread(nullptr), m_isInitialized(false), m_observedBytes(0) {
+    connect(&m_startupWatcher, &QFutureWatcher<ServerStartup>::finished,
+            this, &ThreadSynchronizationExample::onServerStartupFinished);
+    connect(&m_startupWatcher, &QFutureWatcher<ServerStartup>::canceled,
+            this, &ThreadSynchronizationExample::onServerStartupCanceled);
 }
 
-void ThreadSynchronizationExample::startNetworkService() {
+void ThreadSynchronizationExample::startNetworkService(int timeoutMs) {
     qDebug() << "[DEBUG] Starting network service...";
 
     if (m_networkThread) {
@@ -232,58 +699,71 @@ void ThreadSynchronizationExample::startNetworkService() {
     m_networkThread = new NetworkThread(this);
 
     // ✅ 正确：连接线程生命周期信号
-    connect(m_networkThread, &QThread::started, this, &ThreadSynchronizationExample::onNetworkThreadStarted);
     connect(m_networkThread, &QThread::finished, this, &ThreadSynchronizationExample::onNetworkThreadFinished);
 
+#ifdef NETDEBUG_COPY_TRACE_ENABLED
+    // 复制统计构建：把收到的数据排队送到本线程，统计覆盖排队事件中的参数复制；
+    // 发布构建不连接，服务器也就不为clientDataReady复制块链
+    NETDEBUG_REGISTER_TRACED_METATYPE(QByteArray);
+    connect(m_networkThread->server(), &GoodNetworkServer::clientDataReady,
+            this, &ThreadSynchronizationExample::onClientDataObserved, Qt::QueuedConnection);
+#endif
+
     // 启动线程
     m_networkThread->start();
+
+    // ❌ 原来：线程started后再等固定的1000ms才宣布就绪，冷启动白白多付一秒
+    // ✅ 现在：服务器listen()成功就完成future，就绪时间只取决于实际启动耗时
+    m_startupWatcher.setFuture(m_networkThread->startServer(timeoutMs));
 }
 
-void ThreadSynchronizationExample::onNetworkThreadStarted() {
-    qDebug() << "[DEBUG] Network thread started successfully";
+void ThreadSynchronizationExample::cancelNetworkStartup() {
+    QFuture<ServerStartup> future = m_startupWatcher.future();
+    if (future.isFinished() || future.isCanceled()) {
+        return;
+    }
+
+    qDebug() << "[DEBUG] Canceling network startup";
+    StartupMetrics::instance().canceled->increment();
+    future.cancel();
+}
 
-    // 发射启动服务器信号
-    emit m_networkThread->startServerRequested();
+void ThreadSynchronizationExample::onServerStartupFinished() {
+    const QFuture<ServerStartup> future = m_startupWatcher.future();
+    if (future.isCanceled() || future.resultCount() == 0) {
+        return;     // 已由onServerStartupCanceled()处理
+    }
 
-    // 模拟组件初始化完成
-    QTimer::singleShot(1000, [this]() {
-        m_isInitialized = true;
-        emit componentsInitialized();
-        emit networkStarted();
-    });
+    const ServerStartup startup = future.result();
+    if (!startup.listening) {
+        emit networkError(startup.error);
+        return;
+    }
+
+    m_isInitialized = true;
+    qDebug() << "[DEBUG] Network components initialized successfully, listening on port" << startup.port
+             << "after" << startup.latencyNs / 1000000.0 << "ms";
+    emit componentsInitialized();
+    emit networkStarted();
+}
+
+void ThreadSynchronizationExample::onServerStartupCanceled() {
+    emit networkError(QStringLiteral("Network startup canceled or timed out"));
+}
+
+void ThreadSynchronizationExample::onClientDataObserved(QTcpSocket *client, const Traced<QByteArray> &data) {
+    Q_UNUSED(client);   // 属于网络线程，这里只作标识
+    NETDEBUG_TRACE_DELIVERY(data, "ThreadSynchronizationExample::onClientDataObserved");
+    m_observedBytes += tracedValue(data).size();
 }
 
 void ThreadSynchronizationExample::onNetworkThreadFinished() {
     qDebug() << "[DEBUG] Network thread finished";
+    if (m_observedBytes > 0) {
+        qDebug() << "[DEBUG] Observed" << m_observedBytes << "bytes via clientDataReady";
+    }
+    cancelNetworkStartup();
     m_networkThread->deleteLater();
     m_networkThread = nullptr;
     m_isInitialized = false;
 }
-
-bool ThreadSynchronizationExample::waitForNetworkCompletion(int timeoutMs) {
-    qDebug() << "[DEBUG] Waiting for network completion...";
-
-    QEventLoop loop;
-    QTimer timer;
-    bool success = false;
-
-    // ✅ 正确：等待实际的初始化信号，而不是客户端连接
-    connect(this, &ThreadSynchronizationExample::networkError, &loop, &QEventLoop::quit);
-    connect(this, &ThreadSynchronizationExample::componentsInitialized, &loop, &QEventLoop::quit);
-
-    timer.setSingleShot(true);
-    timer.setInterval(timeoutMs);
-    connect(&timer, &QTimer::timeout, &loop, &QEventLoop::quit);
-
-    timer.start();
-    loop.exec();
-
-    if (timer.isActive()) {
-        success = true;
-        qDebug() << "[DEBUG] Network components initialized successfully";
-    } else {
-        qCritical() << "[DEBUG] Network initialization timeout";
-    }
-
-    return success;
-}
\ No newline at end of file
@@ -0,0 +1,350 @@
+/**
+ * @file async_logger.h
+ * @brief 异步二进制日志后端
+ *
+ * I/O线程只把定长二进制记录写入本线程的无锁SPSC环形缓冲区，
+ * 时间戳格式化、十六进制转储和输出全部由后台线程完成。
+ *
+ * 格式字符串必须是字符串字面量（只保存指针），支持的占位符：
+ *   %d  有符号整数参数
+ *   %a  IPv4地址参数（QHostAddress::toIPv4Address()的结果，0显示为"-"）
+ *   %s  静态字符串参数（以reinterpret_cast<qintptr>传入，必须指向字面量）
+ *   %x  附带数据的大小和前16字节十六进制
+ *   %%  百分号
+ *
+ * 用法：NETLOG_INFO(category, format, 参数...)、NETLOG_DATA(format, data, size, 参数...)。
+ * 宏把格式串和参数一起作为__VA_ARGS__转发，不依赖GNU的##__VA_ARGS__扩展（C++17下没有__VA_OPT__）。
+ *
+ * 编译期日志级别由NETLOG_MIN_LEVEL控制，低于该级别的NETLOG_*调用在预处理阶段即被删除，
+ * 参数表达式也不会求值。
+ */
+
+#ifndef ASYNC_LOGGER_H
+#define ASYNC_LOGGER_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QtGlobal>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define NETLOG_LEVEL_DEBUG   0
+#define NETLOG_LEVEL_INFO    1
+#define NETLOG_LEVEL_WARNING 2
+#define NETLOG_LEVEL_ERROR   3
+#define NETLOG_LEVEL_NONE    4
+
+#ifndef NETLOG_MIN_LEVEL
+#  ifdef QT_NO_DEBUG
+#    define NETLOG_MIN_LEVEL NETLOG_LEVEL_INFO
+#  else
+#    define NETLOG_MIN_LEVEL NETLOG_LEVEL_DEBUG
+#  endif
+#endif
+
+enum class NetLogCategory : quint8 {
+    Debug,
+    Connection,
+    Data,
+    Error
+};
+
+// 一条记录恰好占一个缓存行
+struct LogRecord {
+    qint64 timestampNs;
+    const char *format;
+    qint64 args[3];
+    quint32 dataSize;
+    quint8 level;
+    NetLogCategory category;
+    quint8 payloadSize;
+    quint8 argCount;
+    char payload[16];
+};
+static_assert(sizeof(LogRecord) == 64, "LogRecord must stay one cache line");
+
+/**
+ * @brief 单生产者（所属I/O线程）/单消费者（后台线程）环形缓冲区
+ *
+ * 满时不阻塞生产者，直接丢弃并计数。
+ */
+class LogRing {
+public:
+    static constexpr size_t kCapacity = 4096;   // 必须是2的幂
+    static_assert((kCapacity & (kCapacity - 1)) == 0, "capacity must be a power of two");
+
+    LogRecord *claim() {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_cachedTail >= kCapacity) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head - m_cachedTail >= kCapacity) {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+        }
+        return &m_records[head & (kCapacity - 1)];
+    }
+
+    void publish() {
+        m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    template <typename Fn>
+    size_t drain(Fn &&consume) {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        const size_t head = m_head.load(std::memory_order_acquire);
+        for (size_t i = tail; i != head; ++i) {
+            consume(m_records[i & (kCapacity - 1)]);
+        }
+        m_tail.store(head, std::memory_order_release);
+        return head - tail;
+    }
+
+    quint64 takeDropped() { return m_dropped.exchange(0, std::memory_order_relaxed); }
+
+    std::atomic<bool> retired{false};
+
+private:
+    alignas(64) std::atomic<size_t> m_head{0};
+    size_t m_cachedTail = 0;                    // 仅生产者访问
+    alignas(64) std::atomic<size_t> m_tail{0};
+    alignas(64) std::atomic<quint64> m_dropped{0};
+    LogRecord m_records[kCapacity];
+};
+
+class AsyncLogger {
+public:
+    static AsyncLogger &instance() {
+        static AsyncLogger logger;
+        return logger;
+    }
+
+    void start(std::chrono::milliseconds flushInterval = std::chrono::milliseconds(5)) {
+        if (m_running.exchange(true)) {
+            return;
+        }
+        m_flushInterval = flushInterval;
+        m_thread = std::thread([this]() { run(); });
+    }
+
+    // 停止后台线程并输出所有剩余记录
+    void stop() {
+        if (!m_running.exchange(false)) {
+            return;
+        }
+        m_thread.join();
+        flushOnce();
+    }
+
+    quint64 droppedCount() const { return m_totalDropped.load(std::memory_order_relaxed); }
+
+    // 没有附带数据的记录
+    template <typename... Args>
+    static void log(int level, NetLogCategory category, const char *format, Args... args) {
+        write(level, category, format, nullptr, 0, args...);
+    }
+
+    template <typename... Args>
+    static void write(int level, NetLogCategory category, const char *format,
+                      const char *data, qint64 dataSize, Args... args) {
+        static_assert(sizeof...(Args) <= 3, "at most three integer arguments per record");
+
+        LogRing &ring = threadRing();
+        LogRecord *record = ring.claim();
+        if (!record) {
+            return;
+        }
+
+        record->timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        record->format = format;
+        const qint64 values[] = {static_cast<qint64>(args)..., 0};
+        std::memcpy(record->args, values, sizeof(qint64) * sizeof...(Args));
+        record->argCount = static_cast<quint8>(sizeof...(Args));
+        record->level = static_cast<quint8>(level);
+        record->category = category;
+        record->dataSize = static_cast<quint32>(qMax<qint64>(0, dataSize));
+        record->payloadSize = static_cast<quint8>(qMin<qint64>(record->dataSize, sizeof(record->payload)));
+        if (data && record->payloadSize > 0) {
+            std::memcpy(record->payload, data, record->payloadSize);
+        }
+
+        ring.publish();
+    }
+
+private:
+    AsyncLogger() = default;
+    ~AsyncLogger() { stop(); }
+
+    // 线程退出时把自己的环标记为退役，由后台线程排空后释放
+    struct RingHolder {
+        std::shared_ptr<LogRing> ring;
+        ~RingHolder() {
+            if (ring) {
+                ring->retired.store(true, std::memory_order_release);
+            }
+        }
+    };
+
+    static LogRing &threadRing() {
+        thread_local RingHolder holder;
+        if (Q_UNLIKELY(!holder.ring)) {
+            holder.ring = std::make_shared<LogRing>();
+            AsyncLogger &logger = instance();
+            std::lock_guard<std::mutex> lock(logger.m_ringsMutex);
+            logger.m_rings.push_back(holder.ring);
+        }
+        return *holder.ring;
+    }
+
+    void run() {
+        while (m_running.load(std::memory_order_relaxed)) {
+            if (flushOnce() == 0) {
+                std::this_thread::sleep_for(m_flushInterval);
+            }
+        }
+    }
+
+    size_t flushOnce() {
+        std::vector<std::shared_ptr<LogRing>> rings;
+        {
+            std::lock_guard<std::mutex> lock(m_ringsMutex);
+            rings = m_rings;
+        }
+
+        size_t drained = 0;
+        quint64 dropped = 0;
+        m_output.clear();
+        for (const std::shared_ptr<LogRing> &ring : rings) {
+            // 先读退役标志再排空，保证退役前写入的记录不会丢失
+            const bool retired = ring->retired.load(std::memory_order_acquire);
+            drained += ring->drain([this](const LogRecord &record) { format(record); });
+            dropped += ring->takeDropped();
+            if (retired) {
+                std::lock_guard<std::mutex> lock(m_ringsMutex);
+                m_rings.erase(std::remove(m_rings.begin(), m_rings.end(), ring), m_rings.end());
+            }
+        }
+
+        if (dropped > 0) {
+            m_totalDropped.fetch_add(dropped, std::memory_order_relaxed);
+            m_output += "[LOG] 日志缓冲区溢出，丢弃 " + QByteArray::number(dropped)
+                        + " 条记录 (累计 " + QByteArray::number(droppedCount()) + ")\n";
+        }
+
+        if (!m_output.isEmpty()) {
+            std::fwrite(m_output.constData(), 1, static_cast<size_t>(m_output.size()), stderr);
+            std::fflush(stderr);
+        }
+        return drained;
+    }
+
+    void format(const LogRecord &record) {
+        static const char *const kCategoryNames[] = {"DEBUG", "CONNECTION", "DATA", "ERROR"};
+
+        const QDateTime time = QDateTime::fromMSecsSinceEpoch(record.timestampNs / 1000000);
+        m_output += '[';
+        m_output += time.toString("hh:mm:ss.zzz").toLatin1();
+        m_output += "] [";
+        m_output += kCategoryNames[static_cast<int>(record.category)];
+        m_output += "] ";
+
+        int argIndex = 0;
+        for (const char *p = record.format; *p; ++p) {
+            if (*p != '%' || !p[1]) {
+                m_output += *p;
+                continue;
+            }
+
+            const char directive = *++p;
+            const qint64 value = argIndex < record.argCount ? record.args[argIndex] : 0;
+            switch (directive) {
+            case 'd':
+                m_output += QByteArray::number(value);
+                ++argIndex;
+                break;
+            case 'a': {
+                const quint32 ip = static_cast<quint32>(value);
+                if (ip == 0) {
+                    m_output += '-';
+                } else {
+                    m_output += QByteArray::number(ip >> 24) + '.' + QByteArray::number((ip >> 16) & 0xFF) + '.'
+                                + QByteArray::number((ip >> 8) & 0xFF) + '.' + QByteArray::number(ip & 0xFF);
+                }
+                ++argIndex;
+                break;
+            }
+            case 's':
+                m_output += reinterpret_cast<const char *>(static_cast<qintptr>(value));
+                ++argIndex;
+                break;
+            case 'x':
+                if (record.dataSize == 0) {
+                    m_output += "(无数据)";
+                } else {
+                    m_output += "数据大小: " + QByteArray::number(record.dataSize) + " 字节 (前"
+                                + QByteArray::number(record.payloadSize) + "字节: "
+                                + QByteArray(record.payload, record.payloadSize).toHex() + ')';
+                }
+                break;
+            default:
+                m_output += directive;
+                break;
+            }
+        }
+        m_output += '\n';
+    }
+
+    std::atomic<bool> m_running{false};
+    std::chrono::milliseconds m_flushInterval{5};
+    std::thread m_thread;
+
+    std::mutex m_ringsMutex;                    // 只在线程注册和退役时加锁
+    std::vector<std::shared_ptr<LogRing>> m_rings;
+    std::atomic<quint64> m_totalDropped{0};
+    QByteArray m_output;                        // 仅后台线程访问
+};
+
+// 可变部分至少包含格式串，空参数表也是合法的标准C++
+#define NETLOG_WRITE_(level, category, ...) \
+    AsyncLogger::log(level, category, __VA_ARGS__)
+
+#if NETLOG_MIN_LEVEL <= NETLOG_LEVEL_DEBUG
+#  define NETLOG_DEBUG(category, ...) \
+    NETLOG_WRITE_(NETLOG_LEVEL_DEBUG, category, __VA_ARGS__)
+#  define NETLOG_DATA(format, ...) \
+    AsyncLogger::write(NETLOG_LEVEL_DEBUG, NetLogCategory::Data, format, __VA_ARGS__)
+#else
+#  define NETLOG_DEBUG(category, ...) ((void)0)
+#  define NETLOG_DATA(format, ...) ((void)0)
+#endif
+
+#if NETLOG_MIN_LEVEL <= NETLOG_LEVEL_INFO
+#  define NETLOG_INFO(category, ...) \
+    NETLOG_WRITE_(NETLOG_LEVEL_INFO, category, __VA_ARGS__)
+#else
+#  define NETLOG_INFO(category, ...) ((void)0)
+#endif
+
+#if NETLOG_MIN_LEVEL <= NETLOG_LEVEL_WARNING
+#  define NETLOG_WARNING(category, ...) \
+    NETLOG_WRITE_(NETLOG_LEVEL_WARNING, category, __VA_ARGS__)
+#else
+#  define NETLOG_WARNING(category, ...) ((void)0)
+#endif
+
+#if NETLOG_MIN_LEVEL <= NETLOG_LEVEL_ERROR
+#  define NETLOG_ERROR(category, ...) \
+    NETLOG_WRITE_(NETLOG_LEVEL_ERROR, category, __VA_ARGS__)
+#else
+#  define NETLOG_ERROR(category, ...) ((void)0)
+#endif
+
+#endif // ASYNC_LOGGER_H
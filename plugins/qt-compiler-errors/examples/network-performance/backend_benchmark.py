@@ -0,0 +1,154 @@
+#!/usr/bin/env python3
+"""
+I/O后端对比基准
+依次以 qt / epoll / io_uring 后端启动 network_debug_example，
+用 load_generator 施加相同的负载，最后并排打印吞吐量和延迟百分位
+
+用法示例:
+  backend_benchmark.py --server ./network_debug_example --load ./load_generator \\
+      --reactor-threads 4 --connections 1000 --threads 4 --rate 0 --pipeline 4 --duration 20
+"""
+
+import argparse
+import json
+import socket
+import subprocess
+import sys
+import tempfile
+import time
+from pathlib import Path
+
+SERVER_PORT = 50001     # network_debug_example固定监听此端口
+
+
+def wait_for_port(port, timeout_s):
+    """等待服务器开始监听"""
+    deadline = time.monotonic() + timeout_s
+    while time.monotonic() < deadline:
+        try:
+            with socket.create_connection(("127.0.0.1", port), timeout=0.2):
+                return True
+        except OSError:
+            time.sleep(0.1)
+    return False
+
+
+def run_backend(backend, args):
+    """启动一个后端并运行一次负载，返回load_generator的JSON报告；失败返回None"""
+    server_cmd = [
+        args.server,
+        f"--io-backend={backend}",
+        f"--reactor-threads={args.reactor_threads}",
+        "--framing=length",
+        "--heartbeat=0",
+        "--idle-timeout=0",
+        "--metrics-port=0",
+    ]
+    print(f"🚀 启动服务器: {' '.join(server_cmd)}")
+    # 服务器日志写入临时文件：管道不被读取时会写满并阻塞服务器
+    server_log = tempfile.TemporaryFile(mode="w+")
+    server = subprocess.Popen(server_cmd, stdout=server_log, stderr=subprocess.STDOUT, text=True)
+
+    try:
+        if not wait_for_port(SERVER_PORT, 10):
+            print(f"❌ {backend}: 服务器未能在端口 {SERVER_PORT} 上启动")
+            return None
+
+        with tempfile.NamedTemporaryFile(suffix=".json", delete=False) as output:
+            output_path = Path(output.name)
+
+        load_cmd = [
+            args.load,
+            f"--port={SERVER_PORT}",
+            f"--connections={args.connections}",
+            f"--threads={args.threads}",
+            f"--message-size={args.message_size}",
+            f"--rate={args.rate}",
+            f"--pipeline={args.pipeline}",
+            f"--duration={args.duration}",
+            f"--warmup={args.warmup}",
+            f"--label={backend}",
+            f"--output={output_path}",
+        ]
+        print(f"📈 运行负载: {' '.join(load_cmd)}")
+        result = subprocess.run(load_cmd)
+        if result.returncode != 0 or not output_path.exists():
+            print(f"❌ {backend}: load_generator 退出码 {result.returncode}")
+            return None
+
+        report = json.loads(output_path.read_text())
+        output_path.unlink()
+        return report
+    finally:
+        server.terminate()
+        try:
+            server.wait(timeout=10)
+        except subprocess.TimeoutExpired:
+            server.kill()
+            server.wait()
+
+        # 原生后端不可用时服务器会回退到Qt并打印警告，结果表中需要标明
+        server_log.seek(0)
+        if "falling back to Qt" in server_log.read():
+            print(f"⚠️  {backend}: 原生后端不可用，本轮实际使用的是Qt后端")
+        server_log.close()
+
+
+def print_table(reports):
+    """并排打印各后端结果"""
+    rows = [
+        ("connected", lambda r: r["connected"]),
+        ("socket errors", lambda r: r["socket_errors"]),
+        ("recv msgs/s", lambda r: f"{r['throughput']['received_msgs_per_s']:.0f}"),
+        ("recv MB/s", lambda r: f"{r['throughput']['received_mb_per_s']:.2f}"),
+        ("p50 (us)", lambda r: f"{r['latency']['p50']:.1f}"),
+        ("p90 (us)", lambda r: f"{r['latency']['p90']:.1f}"),
+        ("p99 (us)", lambda r: f"{r['latency']['p99']:.1f}"),
+        ("p99.9 (us)", lambda r: f"{r['latency']['p999']:.1f}"),
+        ("max (us)", lambda r: f"{r['latency']['max']:.1f}"),
+    ]
+
+    backends = list(reports.keys())
+    width = max(12, *(len(b) + 2 for b in backends))
+    print()
+    print("metric".ljust(16) + "".join(b.rjust(width) for b in backends))
+    print("-" * (16 + width * len(backends)))
+    for name, value in rows:
+        cells = []
+        for backend in backends:
+            report = reports[backend]
+            cells.append(("-" if report is None else str(value(report))).rjust(width))
+        print(name.ljust(16) + "".join(cells))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="对比 network_debug_example 的各I/O后端")
+    parser.add_argument("--server", default="./network_debug_example", help="服务器可执行文件")
+    parser.add_argument("--load", default="./load_generator", help="负载生成器可执行文件")
+    parser.add_argument("--backends", default="qt,epoll,io_uring", help="逗号分隔的后端列表")
+    parser.add_argument("--reactor-threads", type=int, default=4)
+    parser.add_argument("--connections", type=int, default=1000)
+    parser.add_argument("--threads", type=int, default=4)
+    parser.add_argument("--message-size", type=int, default=128)
+    parser.add_argument("--rate", type=int, default=0, help="每连接每秒消息数，0为闭环")
+    parser.add_argument("--pipeline", type=int, default=4)
+    parser.add_argument("--duration", type=int, default=20)
+    parser.add_argument("--warmup", type=int, default=3)
+    parser.add_argument("--json", help="把所有报告合并写入此文件")
+    args = parser.parse_args()
+
+    reports = {}
+    for backend in args.backends.split(","):
+        reports[backend] = run_backend(backend.strip(), args)
+
+    print_table(reports)
+
+    if args.json:
+        Path(args.json).write_text(json.dumps(reports, indent=2, ensure_ascii=False))
+        print(f"\n✅ 报告已写入 {args.json}")
+
+    return 0 if all(reports.values()) else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,314 @@
+/**
+ * @file buffer_pool.h
+ * @brief 固定大小块的接收缓冲池
+ *
+ * BufferPool按slab（一次分配chunksPerSlab个块）向堆申请内存，块释放后进入空闲链表，
+ * 之后的申请直接从空闲链表取出：稳态下读取不再触发任何堆分配。
+ * PooledBuffer把多个块串成链表，大消息跨块存放，clear()时全部归还缓冲池，
+ * 空闲连接不占用任何块。peekFront()/consume()逐段读取块链，不需要先复制成连续内存。
+ *
+ * maxChunks限制缓冲池总块数；耗尽时readFrom()停止读取，数据留在套接字的读缓冲区中。
+ * 只有读缓冲区有上限（QAbstractSocket::setReadBufferSize()）时，TCP流控才会限制对端，
+ * 否则Qt会继续把内核中的数据读进读缓冲区。
+ *
+ * 块只能在一个线程（第一次acquire()的线程）中申请。PooledBuffer可以整体移交给其他线程，
+ * 在那里读取和释放：其他线程归还的块先进入无锁归还栈，所属线程下次申请时一并回收。
+ */
+
+#ifndef BUFFER_POOL_H
+#define BUFFER_POOL_H
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QtGlobal>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+struct BufferPoolStats {
+    qint32 chunkSize = 0;
+    qint64 totalChunks = 0;         // 已从堆分配的块数
+    qint64 chunksInUse = 0;         // 含其他线程已归还、所属线程尚未回收的块
+    qint64 highWaterChunks = 0;     // chunksInUse的历史峰值
+    qint64 slabAllocations = 0;     // 堆分配次数；稳态下不再增长
+    qint64 exhaustedCount = 0;      // 因达到maxChunks而申请失败的次数
+};
+
+class BufferPool {
+public:
+    struct Chunk {
+        char *data = nullptr;
+        Chunk *next = nullptr;      // 空闲链表 / PooledBuffer块链
+        qint32 begin = 0;           // 未读数据 [begin, end)
+        qint32 end = 0;
+    };
+
+    // maxChunks为0表示不限制
+    explicit BufferPool(qint32 chunkSize = 4096, qint32 chunksPerSlab = 64, qint64 maxChunks = 0)
+        : m_chunksPerSlab(qMax(chunksPerSlab, 1)), m_maxChunks(maxChunks) {
+        m_stats.chunkSize = qMax(chunkSize, 64);
+    }
+
+    BufferPool(const BufferPool &) = delete;
+    BufferPool &operator=(const BufferPool &) = delete;
+
+    qint32 chunkSize() const { return m_stats.chunkSize; }
+    const BufferPoolStats &stats() const { return m_stats; }
+
+    // 只在所属线程调用；池已耗尽时返回nullptr
+    Chunk *acquire() {
+        if (m_owner == std::thread::id()) {
+            m_owner = std::this_thread::get_id();
+        }
+        if (!m_freeList && !reclaimReturned() && !grow()) {
+            ++m_stats.exhaustedCount;
+            return nullptr;
+        }
+
+        Chunk *chunk = m_freeList;
+        m_freeList = chunk->next;
+        chunk->next = nullptr;
+        chunk->begin = chunk->end = 0;
+
+        ++m_stats.chunksInUse;
+        if (m_stats.chunksInUse > m_stats.highWaterChunks) {
+            m_stats.highWaterChunks = m_stats.chunksInUse;
+        }
+        return chunk;
+    }
+
+    // 任意线程调用
+    void release(Chunk *chunk) {
+        if (std::this_thread::get_id() == m_owner) {
+            chunk->next = m_freeList;
+            m_freeList = chunk;
+            --m_stats.chunksInUse;
+            return;
+        }
+
+        // 多个线程可能同时归还；所属线程一次取走整个栈，不存在ABA问题
+        Chunk *head = m_returned.load(std::memory_order_relaxed);
+        do {
+            chunk->next = head;
+        } while (!m_returned.compare_exchange_weak(head, chunk, std::memory_order_release,
+                                                   std::memory_order_relaxed));
+    }
+
+private:
+    // 把其他线程归还的块并入空闲链表；没有可回收的块时返回false
+    bool reclaimReturned() {
+        Chunk *chunk = m_returned.exchange(nullptr, std::memory_order_acquire);
+        if (!chunk) {
+            return false;
+        }
+        while (chunk) {
+            Chunk *next = chunk->next;
+            chunk->next = m_freeList;
+            m_freeList = chunk;
+            --m_stats.chunksInUse;
+            chunk = next;
+        }
+        return true;
+    }
+
+    bool grow() {
+        if (m_maxChunks > 0 && m_stats.totalChunks >= m_maxChunks) {
+            return false;
+        }
+
+        const qint32 count = m_maxChunks > 0
+                             ? static_cast<qint32>(qMin<qint64>(m_chunksPerSlab, m_maxChunks - m_stats.totalChunks))
+                             : m_chunksPerSlab;
+        Slab slab;
+        slab.memory.reset(new char[static_cast<size_t>(count) * static_cast<size_t>(m_stats.chunkSize)]);
+        slab.chunks.reset(new Chunk[static_cast<size_t>(count)]);
+        for (qint32 i = count - 1; i >= 0; --i) {
+            Chunk &chunk = slab.chunks[static_cast<size_t>(i)];
+            chunk.data = slab.memory.get() + static_cast<size_t>(i) * static_cast<size_t>(m_stats.chunkSize);
+            chunk.next = m_freeList;
+            m_freeList = &chunk;
+        }
+        m_slabs.push_back(std::move(slab));
+
+        m_stats.totalChunks += count;
+        ++m_stats.slabAllocations;
+        return true;
+    }
+
+    struct Slab {
+        std::unique_ptr<char[]> memory;
+        std::unique_ptr<Chunk[]> chunks;
+    };
+
+    qint32 m_chunksPerSlab;
+    qint64 m_maxChunks;
+    std::vector<Slab> m_slabs;
+    Chunk *m_freeList = nullptr;
+    std::atomic<Chunk *> m_returned{nullptr};   // 其他线程归还、尚未回收的块
+    std::thread::id m_owner;
+    BufferPoolStats m_stats;
+};
+
+/**
+ * @brief 由缓冲池块组成的链式缓冲区
+ *
+ * 只能移动不能复制；析构时归还所有块。必须先于其缓冲池销毁。
+ */
+class PooledBuffer {
+public:
+    explicit PooledBuffer(BufferPool *pool = nullptr) : m_pool(pool) {}
+    ~PooledBuffer() { clear(); }
+
+    PooledBuffer(PooledBuffer &&other) noexcept
+        : m_pool(other.m_pool), m_head(other.m_head), m_tail(other.m_tail), m_size(other.m_size) {
+        other.m_head = other.m_tail = nullptr;
+        other.m_size = 0;
+    }
+
+    PooledBuffer &operator=(PooledBuffer &&other) noexcept {
+        if (this != &other) {
+            clear();
+            m_pool = other.m_pool;
+            m_head = other.m_head;
+            m_tail = other.m_tail;
+            m_size = other.m_size;
+            other.m_head = other.m_tail = nullptr;
+            other.m_size = 0;
+        }
+        return *this;
+    }
+
+    PooledBuffer(const PooledBuffer &) = delete;
+    PooledBuffer &operator=(const PooledBuffer &) = delete;
+
+    qint64 size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+
+    // 尾块剩余空间；尾块已满时追加新块，池耗尽时返回nullptr
+    char *writePointer(qint64 *contiguous) {
+        if (!m_tail || m_tail->end == m_pool->chunkSize()) {
+            BufferPool::Chunk *chunk = m_pool->acquire();
+            if (!chunk) {
+                *contiguous = 0;
+                return nullptr;
+            }
+            if (m_tail) {
+                m_tail->next = chunk;
+            } else {
+                m_head = chunk;
+            }
+            m_tail = chunk;
+        }
+        *contiguous = m_pool->chunkSize() - m_tail->end;
+        return m_tail->data + m_tail->end;
+    }
+
+    void commit(qint64 bytes) {
+        m_tail->end += static_cast<qint32>(bytes);
+        m_size += bytes;
+    }
+
+    void append(const char *data, qint64 size) {
+        while (size > 0) {
+            qint64 contiguous = 0;
+            char *target = writePointer(&contiguous);
+            if (!target) {
+                return;
+            }
+            const qint64 n = qMin(size, contiguous);
+            std::memcpy(target, data, static_cast<size_t>(n));
+            commit(n);
+            data += n;
+            size -= n;
+        }
+    }
+
+    // 读取设备中当前可用的全部数据；返回读取的字节数，出错返回-1
+    qint64 readFrom(QIODevice *device) {
+        qint64 total = 0;
+        while (device->bytesAvailable() > 0) {
+            qint64 contiguous = 0;
+            char *target = writePointer(&contiguous);
+            if (!target) {
+                break;      // 缓冲池耗尽，剩余数据留在套接字的读缓冲区中
+            }
+            const qint64 bytes = device->read(target, contiguous);
+            if (bytes < 0) {
+                return -1;
+            }
+            if (bytes == 0) {
+                break;
+            }
+            commit(bytes);
+            total += bytes;
+        }
+        return total;
+    }
+
+    // 头部第一段连续的未读数据（不消费）；缓冲区为空时返回false
+    bool peekFront(const char **data, qint64 *size) const {
+        if (!m_head) {
+            return false;
+        }
+        *data = m_head->data + m_head->begin;
+        *size = m_head->end - m_head->begin;
+        return true;
+    }
+
+    // 从头部复制最多maxSize字节到target（不消费），返回复制的字节数
+    qint64 peek(char *target, qint64 maxSize) const {
+        qint64 copied = 0;
+        for (BufferPool::Chunk *chunk = m_head; chunk && copied < maxSize; chunk = chunk->next) {
+            const qint64 n = qMin<qint64>(chunk->end - chunk->begin, maxSize - copied);
+            std::memcpy(target + copied, chunk->data + chunk->begin, static_cast<size_t>(n));
+            copied += n;
+        }
+        return copied;
+    }
+
+    // 丢弃头部bytes字节，读空的块立即归还缓冲池
+    void consume(qint64 bytes) {
+        bytes = qMin(bytes, m_size);
+        m_size -= bytes;
+        while (bytes > 0) {
+            const qint64 n = qMin<qint64>(m_head->end - m_head->begin, bytes);
+            m_head->begin += static_cast<qint32>(n);
+            bytes -= n;
+            if (m_head->begin == m_head->end) {
+                popHead();
+            }
+        }
+    }
+
+    // 复制全部内容到out，复用out已有容量（out未被共享时不分配）
+    void copyTo(QByteArray *out) const {
+        out->resize(static_cast<int>(m_size));
+        peek(out->data(), m_size);
+    }
+
+    void clear() {
+        while (m_head) {
+            popHead();
+        }
+        m_size = 0;
+    }
+
+private:
+    void popHead() {
+        BufferPool::Chunk *chunk = m_head;
+        m_head = chunk->next;
+        if (!m_head) {
+            m_tail = nullptr;
+        }
+        m_pool->release(chunk);
+    }
+
+    BufferPool *m_pool;
+    BufferPool::Chunk *m_head = nullptr;
+    BufferPool::Chunk *m_tail = nullptr;
+    qint64 m_size = 0;
+};
+
+#endif // BUFFER_POOL_H
@@ -0,0 +1,315 @@
+/**
+ * @file channel.h
+ * @brief 单生产者/单消费者无锁通道，用于跨线程传递POD消息
+ *
+ * 有界环形缓冲区，生产者和消费者的索引各占一个缓存行，并各自缓存对方索引，
+ * 稳态下push/drain不触碰对方的缓存行。消息按值存放在环中：不需要注册QMetaType，
+ * 也不为每条消息分配事件。
+ *
+ * 唤醒按批次而不是按条：只有消费者处于“已排空”状态时，push才通知一次，
+ * 消费者醒来后一次性排空所有消息。Linux上通过eventfd + QSocketNotifier唤醒
+ * （完全不经过事件队列），其他平台每批投递一次排队调用。
+ *
+ * 环满时的处理由ChannelOverflow决定：Drop丢弃新消息并计入dropped；Spill把消息转入
+ * 加锁的溢出队列，在环中已有消息之后按原顺序交付，不丢消息，代价是溢出期间每条消息一次加锁。
+ *
+ * 约束：T必须可平凡复制；同一时刻只能有一个线程push、一个线程drain；
+ * 通道必须在接收线程结束后（或在接收线程中）销毁。
+ */
+
+#ifndef CHANNEL_H
+#define CHANNEL_H
+
+#include <QObject>
+#include <QtGlobal>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+#ifdef Q_OS_LINUX
+#include <QSocketNotifier>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#else
+#include <QMetaObject>
+#endif
+
+struct ChannelStats {
+    quint64 pushed = 0;         // 写入环的消息
+    quint64 dropped = 0;        // 通道满时被拒绝的消息（ChannelOverflow::Drop）
+    quint64 spilled = 0;        // 通道满时转入溢出队列的消息（ChannelOverflow::Spill）
+    quint64 wakeups = 0;        // 通知消费者的次数（即批次数上限）
+    quint64 delivered = 0;
+    quint64 maxBatch = 0;       // 单次唤醒排空的最大消息数
+};
+
+// 环满时的处理方式
+enum class ChannelOverflow {
+    Drop,       // 丢弃新消息：只适合可以容忍丢失的高频数据
+    Spill       // 转入溢出队列：不丢消息、保持顺序，溢出期间生产者每条消息加锁一次
+};
+
+template <typename T>
+class Channel {
+    static_assert(std::is_trivially_copyable<T>::value, "Channel<T> requires a trivially copyable T");
+
+public:
+    // capacity向上取整为2的幂
+    explicit Channel(size_t capacity = 1024, ChannelOverflow overflow = ChannelOverflow::Drop)
+        : m_overflow(overflow) {
+        size_t rounded = 2;
+        while (rounded < capacity) {
+            rounded <<= 1;
+        }
+        m_capacity = rounded;
+        m_mask = rounded - 1;
+        m_slots.reset(new T[rounded]);
+    }
+
+    ~Channel() {
+#ifdef Q_OS_LINUX
+        m_notifier.reset();
+        if (m_eventFd >= 0) {
+            ::close(m_eventFd);
+        }
+#endif
+    }
+
+    Channel(const Channel &) = delete;
+    Channel &operator=(const Channel &) = delete;
+
+    size_t capacity() const { return m_capacity; }
+    ChannelOverflow overflow() const { return m_overflow; }
+
+    /**
+     * @brief 设置消费端：handler在receiver所在线程中对每条消息调用
+     *
+     * 必须在第一次push()之前调用一次。
+     */
+    void attach(QObject *receiver, std::function<void(const T &)> handler) {
+        m_receiver = receiver;
+        m_handler = std::move(handler);
+#ifdef Q_OS_LINUX
+        m_eventFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        m_notifier.reset(new QSocketNotifier(m_eventFd, QSocketNotifier::Read));
+        // ✅ 通知器必须属于接收线程，activated才会在该线程中触发
+        m_notifier->moveToThread(receiver->thread());
+        QObject::connect(m_notifier.get(), &QSocketNotifier::activated, receiver, [this]() { onWake(); });
+#endif
+    }
+
+    // 生产者线程调用；Drop模式下通道满时返回false并计入dropped，Spill模式总是返回true
+    bool push(const T &value) {
+        if (!write(value)) {
+            bump(m_dropped);
+            return false;
+        }
+        notify();
+        return true;
+    }
+
+    // 批量写入，只通知一次；返回实际写入条数
+    size_t pushBatch(const T *values, size_t count) {
+        size_t written = 0;
+        while (written < count && write(values[written])) {
+            ++written;
+        }
+        bump(m_dropped, count - written);
+        if (written > 0) {
+            notify();
+        }
+        return written;
+    }
+
+    // 消费者线程调用：最多取出maxCount条，对每条调用f；返回取出条数
+    template <typename F>
+    size_t drain(F &&f, size_t maxCount = static_cast<size_t>(-1)) {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cachedTail) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+        }
+
+        size_t count = 0;
+        while (head != m_cachedTail && count < maxCount) {
+            f(m_slots[head & m_mask]);
+            ++head;
+            ++count;
+            // 每处理一段就释放槽位，生产者不必等整批处理完
+            if ((count & 63) == 0) {
+                m_head.store(head, std::memory_order_release);
+            }
+        }
+        m_head.store(head, std::memory_order_release);
+        bump(m_delivered, count);
+        return count;
+    }
+
+    // 可在任意线程读取
+    ChannelStats stats() const {
+        ChannelStats stats;
+        stats.pushed = m_pushed.load(std::memory_order_relaxed);
+        stats.dropped = m_dropped.load(std::memory_order_relaxed);
+        stats.spilled = m_spilled.load(std::memory_order_relaxed);
+        stats.wakeups = m_wakeups.load(std::memory_order_relaxed);
+        stats.delivered = m_delivered.load(std::memory_order_relaxed);
+        stats.maxBatch = m_maxBatch.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+private:
+    // 每个计数器只有一个写入线程，不需要原子读-改-写
+    static void bump(std::atomic<quint64> &counter, quint64 n = 1) {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    // 溢出队列非空时新消息也必须排在它后面，否则会越过先溢出的消息
+    bool write(const T &value) {
+        if (m_overflow == ChannelOverflow::Drop) {
+            return tryWrite(value);
+        }
+        if (m_spilling.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> lock(m_spillMutex);
+            if (m_spilling.load(std::memory_order_relaxed)) {
+                spill(value);
+                return true;
+            }
+            // 消费者刚取走溢出队列，后续消息回到环中
+        }
+        if (tryWrite(value)) {
+            return true;
+        }
+        std::lock_guard<std::mutex> lock(m_spillMutex);
+        m_spilling.store(true, std::memory_order_release);
+        spill(value);
+        return true;
+    }
+
+    // 调用方持有m_spillMutex
+    void spill(const T &value) {
+        m_spillQueue.push_back(value);
+        bump(m_spilled);
+    }
+
+    bool tryWrite(const T &value) {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead == m_capacity) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead == m_capacity) {
+                return false;
+            }
+        }
+        m_slots[tail & m_mask] = value;
+        m_tail.store(tail + 1, std::memory_order_release);
+        bump(m_pushed);
+        return true;
+    }
+
+    // 与onWake()中的栅栏配对：要么消费者看到新消息，要么生产者看到需要唤醒
+    void notify() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_wakePending.load(std::memory_order_relaxed) || m_wakePending.exchange(true)) {
+            return;
+        }
+        bump(m_wakeups);
+#ifdef Q_OS_LINUX
+        const quint64 one = 1;
+        const ssize_t written = ::write(m_eventFd, &one, sizeof(one));
+        Q_UNUSED(written);
+#else
+        QMetaObject::invokeMethod(m_receiver, [this]() { onWake(); }, Qt::QueuedConnection);
+#endif
+    }
+
+    void onWake() {
+#ifdef Q_OS_LINUX
+        quint64 counter = 0;
+        const ssize_t bytes = ::read(m_eventFd, &counter, sizeof(counter));
+        Q_UNUSED(bytes);
+#endif
+        // 先清除标志再排空：排空期间到达的消息会触发下一次唤醒
+        m_wakePending.store(false, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        size_t count = drain(m_handler);
+        if (m_spilling.load(std::memory_order_acquire)) {
+            // 溢出期间生产者只写溢出队列（只有生产者自己会置位m_spilling），
+            // 加锁后再排空一次环，交付完溢出开始前的消息，再交付溢出队列，顺序不变
+            std::vector<T> spilled;
+            {
+                std::lock_guard<std::mutex> lock(m_spillMutex);
+                count += drain(m_handler);
+                spilled.swap(m_spillQueue);
+                m_spilling.store(false, std::memory_order_release);
+            }
+            for (const T &value : spilled) {
+                m_handler(value);
+            }
+            count += spilled.size();
+            bump(m_delivered, spilled.size());
+        }
+        if (count > m_maxBatch.load(std::memory_order_relaxed)) {
+            m_maxBatch.store(count, std::memory_order_relaxed);
+        }
+    }
+
+    // 生产者写、消费者读；生产者统计放在同一缓存行
+    alignas(64) std::atomic<size_t> m_tail{0};
+    size_t m_cachedHead = 0;                // 生产者缓存的消费位置
+    std::atomic<quint64> m_pushed{0};
+    std::atomic<quint64> m_dropped{0};
+    std::atomic<quint64> m_spilled{0};
+    std::atomic<quint64> m_wakeups{0};
+
+    // 消费者写、生产者读；消费者统计放在同一缓存行
+    alignas(64) std::atomic<size_t> m_head{0};
+    size_t m_cachedTail = 0;                // 消费者缓存的生产位置
+    std::atomic<quint64> m_delivered{0};
+    std::atomic<quint64> m_maxBatch{0};
+
+    alignas(64) std::atomic<bool> m_wakePending{false};
+
+    // ChannelOverflow::Spill：环满后生产者置位m_spilling，消费者取走溢出队列后清除
+    std::atomic<bool> m_spilling{false};
+    std::mutex m_spillMutex;
+    std::vector<T> m_spillQueue;
+
+    // 构造/attach后只读
+    alignas(64) size_t m_capacity = 0;
+    size_t m_mask = 0;
+    ChannelOverflow m_overflow;
+    std::unique_ptr<T[]> m_slots;
+    QObject *m_receiver = nullptr;
+    std::function<void(const T &)> m_handler;
+#ifdef Q_OS_LINUX
+    int m_eventFd = -1;
+    std::unique_ptr<QSocketNotifier> m_notifier;
+#endif
+};
+
+/**
+ * @brief 用Channel代替Qt::QueuedConnection连接单参数信号和槽
+ *
+ * 信号在发送线程中直接写入通道，槽在receiver所在线程中按批调用。
+ * 通道满时按overflow处理：Drop丢弃并计入dropped；每条消息都必须送达时用Spill。
+ * 返回的通道必须比sender和receiver活得久。
+ */
+template <typename Sender, typename Receiver, typename SignalArg, typename SlotArg>
+std::unique_ptr<Channel<typename std::decay<SignalArg>::type>>
+connectChannel(Sender *sender, void (Sender::*signal)(SignalArg),
+               Receiver *receiver, void (Receiver::*slot)(SlotArg), size_t capacity = 1024,
+               ChannelOverflow overflow = ChannelOverflow::Drop) {
+    using Value = typename std::decay<SignalArg>::type;
+    std::unique_ptr<Channel<Value>> channel(new Channel<Value>(capacity, overflow));
+    channel->attach(receiver, [receiver, slot](const Value &value) { (receiver->*slot)(value); });
+
+    Channel<Value> *target = channel.get();
+    QObject::connect(sender, signal, receiver, [target](SignalArg value) { target->push(value); },
+                     Qt::DirectConnection);
+    return channel;
+}
+
+#endif // CHANNEL_H
@@ -0,0 +1,204 @@
+/**
+ * @file channel_benchmark.cpp
+ * @brief Channel<T>与Qt::QueuedConnection跨线程传递POD消息的对比基准
+ *
+ * 发送端在主线程，接收端是运行事件循环的QThread。每条消息携带发送时刻
+ * （steady_clock纳秒），接收端用HDR直方图记录端到端延迟。两个场景：
+ *   burst  尽快发送N条，测量吞吐量（通道满时发送端自旋等待，不丢消息）
+ *   paced  按固定速率发送，测量不饱和时的尾延迟
+ *
+ * 用法: channel_benchmark [消息数=1000000] [paced速率msgs/s=100000]
+ */
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QMetaType>
+#include <QObject>
+#include <QThread>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+#include "channel.h"
+#include "hdr_histogram.h"
+
+// 与SelfcheckReply同量级的POD消息
+struct BenchMessage {
+    qint64 sentNs = 0;
+    qint32 sequence = 0;
+    qint32 payload[5] = {};
+};
+Q_DECLARE_METATYPE(BenchMessage)
+
+static qint64 steadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+class BenchSender : public QObject {
+    Q_OBJECT
+
+signals:
+    void message(const BenchMessage &message);
+};
+
+class BenchReceiver : public QObject {
+    Q_OBJECT
+
+public:
+    void reset(qint64 expected) {
+        m_latencyNs.reset();
+        m_expected = expected;
+        m_received.store(0, std::memory_order_relaxed);
+        m_outOfOrder = 0;
+        m_lastSequence = -1;
+    }
+
+    bool finished() const { return m_received.load(std::memory_order_acquire) >= m_expected; }
+    const HdrHistogram &latency() const { return m_latencyNs; }
+    qint64 outOfOrder() const { return m_outOfOrder; }
+
+public slots:
+    void onMessage(const BenchMessage &message) {
+        m_latencyNs.record(qMax<qint64>(steadyNowNs() - message.sentNs, 1));
+        if (message.sequence <= m_lastSequence) {
+            ++m_outOfOrder;
+        }
+        m_lastSequence = message.sequence;
+        m_received.store(m_received.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+private:
+    HdrHistogram m_latencyNs;
+    qint64 m_expected = 0;
+    std::atomic<qint64> m_received{0};
+    qint64 m_outOfOrder = 0;
+    qint32 m_lastSequence = -1;
+};
+
+enum class Transport {
+    QueuedSignal,
+    Channel
+};
+
+struct RunResult {
+    double seconds = 0;
+    qint64 messages = 0;
+};
+
+static void waitUntilFinished(const BenchReceiver &receiver) {
+    while (!receiver.finished()) {
+        QThread::yieldCurrentThread();
+    }
+}
+
+// rate为0表示尽快发送
+static RunResult runScenario(Transport transport, BenchSender *sender, Channel<BenchMessage> *channel,
+                             BenchReceiver *receiver, qint64 count, qint64 rate) {
+    receiver->reset(count);
+    const qint64 intervalNs = rate > 0 ? 1000000000LL / rate : 0;
+
+    QElapsedTimer timer;
+    timer.start();
+    const qint64 startNs = steadyNowNs();
+
+    BenchMessage message;
+    for (qint64 i = 0; i < count; ++i) {
+        if (intervalNs > 0) {
+            const qint64 due = startNs + i * intervalNs;
+            while (steadyNowNs() < due) {
+            }
+        }
+        message.sequence = static_cast<qint32>(i);
+        message.sentNs = steadyNowNs();
+        if (transport == Transport::QueuedSignal) {
+            emit sender->message(message);
+        } else {
+            while (!channel->push(message)) {
+                QThread::yieldCurrentThread();      // 通道满：等待接收端排空
+            }
+        }
+    }
+
+    waitUntilFinished(*receiver);
+
+    RunResult result;
+    result.seconds = timer.nsecsElapsed() / 1e9;
+    result.messages = count;
+    return result;
+}
+
+static void printResult(const char *transport, const char *scenario, const RunResult &result,
+                        const BenchReceiver &receiver, const ChannelStats *stats) {
+    const HdrHistogram &latency = receiver.latency();
+    auto micros = [](qint64 ns) { return ns / 1000.0; };
+    std::printf("%-14s %-6s %12.0f msgs/s  p50 %8.2f us  p99 %8.2f us  p999 %9.2f us  max %10.2f us",
+                transport, scenario, result.messages / result.seconds,
+                micros(latency.valueAtPercentile(50.0)), micros(latency.valueAtPercentile(99.0)),
+                micros(latency.valueAtPercentile(99.9)), micros(latency.max()));
+    if (stats) {
+        std::printf("  wakeups %llu  max batch %llu", static_cast<unsigned long long>(stats->wakeups),
+                    static_cast<unsigned long long>(stats->maxBatch));
+    }
+    if (receiver.outOfOrder() > 0) {
+        std::printf("  OUT OF ORDER %lld", static_cast<long long>(receiver.outOfOrder()));
+    }
+    std::printf("\n");
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    const qint64 count = argc > 1 ? std::atoll(argv[1]) : 1000000;
+    const qint64 pacedRate = argc > 2 ? std::atoll(argv[2]) : 100000;
+
+    qRegisterMetaType<BenchMessage>();
+
+    QThread receiverThread;
+    receiverThread.setObjectName("receiver");
+    BenchReceiver *receiver = new BenchReceiver();
+    receiver->moveToThread(&receiverThread);
+    QObject::connect(&receiverThread, &QThread::finished, receiver, &QObject::deleteLater);
+
+    BenchSender sender;
+    QObject::connect(&sender, &BenchSender::message, receiver, &BenchReceiver::onMessage, Qt::QueuedConnection);
+
+    // 通道与排队信号共用同一个接收槽，只替换传输方式
+    Channel<BenchMessage> channel(4096);
+    channel.attach(receiver, [receiver](const BenchMessage &message) { receiver->onMessage(message); });
+
+    receiverThread.start();
+
+    std::printf("Cross-thread POD messages: %lld messages, %zu bytes each, paced rate %lld msgs/s\n",
+                static_cast<long long>(count), sizeof(BenchMessage), static_cast<long long>(pacedRate));
+
+    // 预热：让两条路径的分配器和通知器进入稳态
+    runScenario(Transport::QueuedSignal, &sender, &channel, receiver, count / 10, 0);
+    runScenario(Transport::Channel, &sender, &channel, receiver, count / 10, 0);
+
+    RunResult result = runScenario(Transport::QueuedSignal, &sender, &channel, receiver, count, 0);
+    printResult("QueuedSignal", "burst", result, *receiver, nullptr);
+
+    ChannelStats before = channel.stats();
+    result = runScenario(Transport::Channel, &sender, &channel, receiver, count, 0);
+    ChannelStats stats = channel.stats();
+    stats.wakeups -= before.wakeups;
+    printResult("Channel<T>", "burst", result, *receiver, &stats);
+
+    const qint64 pacedCount = qMin(count, pacedRate * 5);
+    result = runScenario(Transport::QueuedSignal, &sender, &channel, receiver, pacedCount, pacedRate);
+    printResult("QueuedSignal", "paced", result, *receiver, nullptr);
+
+    before = channel.stats();
+    result = runScenario(Transport::Channel, &sender, &channel, receiver, pacedCount, pacedRate);
+    stats = channel.stats();
+    stats.wakeups -= before.wakeups;
+    printResult("Channel<T>", "paced", result, *receiver, &stats);
+
+    receiverThread.quit();
+    receiverThread.wait();
+    return 0;
+}
+
+#include "channel_benchmark.moc"
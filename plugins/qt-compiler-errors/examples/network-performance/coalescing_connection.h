@@ -0,0 +1,118 @@
+/**
+ * @file coalescing_connection.h
+ * @brief 只保留最新值的跨线程信号连接
+ *
+ * Qt::QueuedConnection对每次emit都复制一次参数并投递一个事件。对于状态类数据
+ * （只有最新值有意义），高频发送时接收线程会被过期事件淹没。
+ *
+ * connectCoalesced()在发送线程中把参数写入一个单值邮箱（覆盖尚未取走的旧值），
+ * 只有邮箱从空变为非空时才向接收者线程投递一次唤醒；接收线程取出时拿到的总是最新值。
+ * 因此无论发送多快，每个事件循环周期最多只有一个待处理事件。
+ *
+ * 被覆盖的中间值计入superseded，可用于确认合并确实发生以及评估发送频率是否过高。
+ */
+
+#ifndef COALESCING_CONNECTION_H
+#define COALESCING_CONNECTION_H
+
+#include <QMetaObject>
+#include <QObject>
+#include <QtGlobal>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+struct CoalescingStats {
+    quint64 published = 0;      // 发送端emit次数
+    quint64 delivered = 0;      // 实际调用槽函数次数
+    quint64 superseded = 0;     // 未送达就被新值覆盖的次数
+    quint64 wakeups = 0;        // 投递到接收线程的事件数
+};
+
+template <typename T>
+class LatestValueMailbox {
+public:
+    // 写入最新值；返回true表示调用方需要投递一次唤醒
+    bool publish(const T &value) {
+        m_published.fetch_add(1, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_hasValue) {
+            m_superseded.fetch_add(1, std::memory_order_relaxed);
+        }
+        m_value = value;
+        m_hasValue = true;
+        if (m_wakePending) {
+            return false;
+        }
+        m_wakePending = true;
+        m_wakeups.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // 接收线程取出最新值；取出后再到达的值会重新投递唤醒
+    bool take(T *out) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_wakePending = false;
+        if (!m_hasValue) {
+            return false;
+        }
+        *out = std::move(m_value);
+        m_hasValue = false;
+        m_delivered.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // 可在任意线程读取
+    CoalescingStats stats() const {
+        CoalescingStats stats;
+        stats.published = m_published.load(std::memory_order_relaxed);
+        stats.delivered = m_delivered.load(std::memory_order_relaxed);
+        stats.superseded = m_superseded.load(std::memory_order_relaxed);
+        stats.wakeups = m_wakeups.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+private:
+    std::mutex m_mutex;         // 只保护一次赋值，临界区极短
+    T m_value{};
+    bool m_hasValue = false;
+    bool m_wakePending = false;
+
+    std::atomic<quint64> m_published{0};
+    std::atomic<quint64> m_delivered{0};
+    std::atomic<quint64> m_superseded{0};
+    std::atomic<quint64> m_wakeups{0};
+};
+
+/**
+ * @brief 以“最新值”语义连接单参数信号和槽
+ *
+ * 槽函数在receiver所在线程执行。参数类型无需注册元类型（不经过QVariant排队）。
+ * 返回的邮箱用于读取统计；连接随sender或receiver销毁自动断开。
+ */
+template <typename Sender, typename Receiver, typename SignalArg, typename SlotArg>
+std::shared_ptr<LatestValueMailbox<typename std::decay<SignalArg>::type>>
+connectCoalesced(Sender *sender, void (Sender::*signal)(SignalArg),
+                 Receiver *receiver, void (Receiver::*slot)(SlotArg)) {
+    using Value = typename std::decay<SignalArg>::type;
+    auto mailbox = std::make_shared<LatestValueMailbox<Value>>();
+
+    // 发送线程中直接执行：只写邮箱，必要时投递一次唤醒
+    QObject::connect(sender, signal, receiver, [mailbox, receiver, slot](SignalArg value) {
+        if (!mailbox->publish(value)) {
+            return;
+        }
+        QMetaObject::invokeMethod(receiver, [mailbox, receiver, slot]() {
+            Value latest;
+            if (mailbox->take(&latest)) {
+                (receiver->*slot)(latest);
+            }
+        }, Qt::QueuedConnection);
+    }, Qt::DirectConnection);
+
+    return mailbox;
+}
+
+#endif // COALESCING_CONNECTION_H
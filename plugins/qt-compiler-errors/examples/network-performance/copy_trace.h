@@ -0,0 +1,256 @@
+/**
+ * @file copy_trace.h
+ * @brief 信号参数的复制/移动/分配计数（可选调试工具）
+ *
+ * 把信号参数类型写成Traced<T>，发射时用NETDEBUG_TRACED(value, "类::信号")包装，
+ * 之后该值在Qt内部（排队事件、连接适配、邮箱等）的每一次复制、移动和new分配
+ * 都计入该信号名下；槽函数中用NETDEBUG_TRACE_DELIVERY(value, "类::槽")记录送达，
+ * 得到每条连接的送达次数，从而算出每次送达平均付出了几次复制。
+ * 排队连接的参数要经过元类型复制：在文件作用域写NETDEBUG_DECLARE_TRACED_METATYPE(T)，
+ * 并在connect()之前调用NETDEBUG_REGISTER_TRACED_METATYPE(T)。
+ *
+ * 分配次数来自全局operator new的钩子：每个程序在某一个源文件的文件作用域写一次
+ * NETDEBUG_DEFINE_COPY_TRACE_ALLOCATOR。Qt的元类型代码先operator new再placement new构造参数，
+ * 类作用域的operator new既看不到这次分配，又会遮蔽placement new，所以不能用。
+ * 没有定义钩子时分配次数恒为0。
+ *
+ * 只有同时定义NETDEBUG_TRACE_COPIES且为调试构建时才启用；否则Traced<T>就是T，
+ * 宏展开为原值或空语句，发布构建中没有任何开销。
+ *
+ * 报告在QCoreApplication销毁时自动输出一次，也可随时调用CopyTraceRegistry::instance().report()。
+ */
+
+#ifndef COPY_TRACE_H
+#define COPY_TRACE_H
+
+#include <QtGlobal>
+
+#if defined(NETDEBUG_TRACE_COPIES) && !defined(QT_NO_DEBUG)
+#define NETDEBUG_COPY_TRACE_ENABLED 1
+#endif
+
+#ifdef NETDEBUG_COPY_TRACE_ENABLED
+
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QMetaType>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// 每个信号一个统计点
+struct CopyTraceSite {
+    const char *signal = nullptr;
+    std::atomic<quint64> emissions{0};
+    std::atomic<quint64> copies{0};
+    std::atomic<quint64> moves{0};
+    std::atomic<quint64> allocations{0};
+};
+
+// 每条连接（接收槽）一个统计点
+struct CopyTraceConnection {
+    const char *connection = nullptr;
+    std::atomic<CopyTraceSite *> site{nullptr};     // 第一次送达时记录所属信号；各接收线程可能同时写入
+    std::atomic<quint64> deliveries{0};
+};
+
+// 本线程最近一次全局operator new返回的内存块，由NETDEBUG_DEFINE_COPY_TRACE_ALLOCATOR记录
+struct CopyTraceAllocation {
+    std::uintptr_t begin = 0;
+    std::size_t size = 0;
+};
+
+inline CopyTraceAllocation &copyTraceLastAllocation() {
+    static thread_local CopyTraceAllocation allocation;
+    return allocation;
+}
+
+class CopyTraceRegistry {
+public:
+    static CopyTraceRegistry &instance() {
+        static CopyTraceRegistry registry;
+        return registry;
+    }
+
+    // name必须是字符串字面量；返回的指针在进程生命周期内有效
+    CopyTraceSite *site(const char *signal) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (CopyTraceSite &site : m_sites) {
+            if (std::strcmp(site.signal, signal) == 0) {
+                return &site;
+            }
+        }
+        m_sites.emplace_back();
+        m_sites.back().signal = signal;
+        return &m_sites.back();
+    }
+
+    CopyTraceConnection *connection(const char *name) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (CopyTraceConnection &connection : m_connections) {
+            if (std::strcmp(connection.connection, name) == 0) {
+                return &connection;
+            }
+        }
+        m_connections.emplace_back();
+        m_connections.back().connection = name;
+        return &m_connections.back();
+    }
+
+    QByteArray report() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        QByteArray out = "=== 信号参数复制统计 ===\n";
+        for (const CopyTraceSite &site : m_sites) {
+            const quint64 emissions = site.emissions.load(std::memory_order_relaxed);
+            const quint64 copies = site.copies.load(std::memory_order_relaxed);
+            out += QByteArray(site.signal) + ": 发射 " + QByteArray::number(emissions)
+                 + ", 复制 " + QByteArray::number(copies)
+                 + ", 移动 " + QByteArray::number(site.moves.load(std::memory_order_relaxed))
+                 + ", 分配 " + QByteArray::number(site.allocations.load(std::memory_order_relaxed))
+                 + ", 每次发射复制 " + QByteArray::number(emissions ? double(copies) / emissions : 0.0, 'f', 2)
+                 + '\n';
+        }
+        for (const CopyTraceConnection &connection : m_connections) {
+            const quint64 deliveries = connection.deliveries.load(std::memory_order_relaxed);
+            const CopyTraceSite *site = connection.site.load(std::memory_order_acquire);
+            const quint64 copies = site ? site->copies.load(std::memory_order_relaxed) : 0;
+            out += QByteArray("  -> ") + connection.connection
+                 + (site ? QByteArray(" (") + site->signal + ')' : QByteArray())
+                 + ": 送达 " + QByteArray::number(deliveries)
+                 + ", 每次送达复制 " + QByteArray::number(deliveries ? double(copies) / deliveries : 0.0, 'f', 2)
+                 + '\n';
+        }
+        return out;
+    }
+
+private:
+    CopyTraceRegistry() {
+        qAddPostRoutine([]() { qDebug().noquote() << CopyTraceRegistry::instance().report(); });
+    }
+
+    mutable std::mutex m_mutex;
+    std::deque<CopyTraceSite> m_sites;              // deque保证已返回的指针有效
+    std::deque<CopyTraceConnection> m_connections;
+};
+
+template <typename T>
+class Traced {
+public:
+    Traced() = default;
+    Traced(T value, CopyTraceSite *site) : m_site(site), m_value(std::move(value)) {
+        m_site->emissions.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // m_site先于m_value初始化：复制m_value本身可能分配，必须在那之前认领本次分配
+    Traced(const Traced &other) : m_site(claimAllocation(other.m_site)), m_value(other.m_value) {
+        count(&CopyTraceSite::copies);
+    }
+
+    Traced(Traced &&other) noexcept : m_site(other.m_site), m_value(std::move(other.m_value)) {
+        count(&CopyTraceSite::moves);
+    }
+
+    Traced &operator=(const Traced &other) {
+        m_value = other.m_value;
+        m_site = other.m_site;
+        count(&CopyTraceSite::copies);
+        return *this;
+    }
+
+    Traced &operator=(Traced &&other) noexcept {
+        m_value = std::move(other.m_value);
+        m_site = other.m_site;
+        count(&CopyTraceSite::moves);
+        return *this;
+    }
+
+    const T &get() const { return m_value; }
+    operator const T &() const { return m_value; }
+    CopyTraceSite *site() const { return m_site; }
+
+private:
+    // this落在本线程最近一次operator new返回的块内：这次复制构造在刚分配的堆内存上
+    // （new T(copy)，或Qt的operator new + placement new）
+    CopyTraceSite *claimAllocation(CopyTraceSite *site) {
+        CopyTraceAllocation &last = copyTraceLastAllocation();
+        const std::uintptr_t self = reinterpret_cast<std::uintptr_t>(this);
+        if (site && last.size && self >= last.begin && self - last.begin < last.size) {
+            last = CopyTraceAllocation{};
+            site->allocations.fetch_add(1, std::memory_order_relaxed);
+        }
+        return site;
+    }
+
+    void count(std::atomic<quint64> CopyTraceSite::*counter) {
+        if (m_site) {
+            (m_site->*counter).fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    CopyTraceSite *m_site = nullptr;
+    T m_value{};
+};
+
+template <typename T>
+const T &tracedValue(const Traced<T> &value) { return value.get(); }
+
+// 统计点在每个调用位置只查找一次
+#define NETDEBUG_TRACED(value, signalName) \
+    Traced<typename std::decay<decltype(value)>::type>((value), []() { \
+        static CopyTraceSite *site = CopyTraceRegistry::instance().site(signalName); \
+        return site; \
+    }())
+
+#define NETDEBUG_TRACE_DELIVERY(traced, connectionName) \
+    do { \
+        static CopyTraceConnection *traceConnection = CopyTraceRegistry::instance().connection(connectionName); \
+        CopyTraceSite *expectedSite = nullptr; \
+        traceConnection->site.compare_exchange_strong(expectedSite, (traced).site(), std::memory_order_release, \
+                                                      std::memory_order_relaxed); \
+        traceConnection->deliveries.fetch_add(1, std::memory_order_relaxed); \
+    } while (0)
+
+// 排队连接需要为包装类型注册元类型：DECLARE写在文件作用域，REGISTER在connect()之前调用
+#define NETDEBUG_DECLARE_TRACED_METATYPE(Type) Q_DECLARE_METATYPE(Traced<Type>)
+#define NETDEBUG_REGISTER_TRACED_METATYPE(Type) qRegisterMetaType<Traced<Type>>("Traced<" #Type ">")
+
+// 替换全局operator new/delete，记录本线程最近一次分配；每个程序只能展开一次。
+// 对齐分配（operator new(size, align_val_t)）不记录，超对齐的参数类型分配次数为0
+#define NETDEBUG_DEFINE_COPY_TRACE_ALLOCATOR \
+    void *operator new(std::size_t size) { \
+        void *memory = std::malloc(size ? size : 1); \
+        if (!memory) { \
+            throw std::bad_alloc(); \
+        } \
+        copyTraceLastAllocation() = CopyTraceAllocation{reinterpret_cast<std::uintptr_t>(memory), size}; \
+        return memory; \
+    } \
+    void operator delete(void *memory) noexcept { std::free(memory); } \
+    void operator delete(void *memory, std::size_t) noexcept { std::free(memory); }
+
+#else // !NETDEBUG_COPY_TRACE_ENABLED
+
+// 发布构建：包装类型就是原类型，宏不产生任何代码
+template <typename T>
+using Traced = T;
+
+template <typename T>
+const T &tracedValue(const T &value) { return value; }
+
+#define NETDEBUG_TRACED(value, signalName) (value)
+#define NETDEBUG_TRACE_DELIVERY(traced, connectionName) do { } while (0)
+#define NETDEBUG_DECLARE_TRACED_METATYPE(Type)
+#define NETDEBUG_REGISTER_TRACED_METATYPE(Type) do { } while (0)
+#define NETDEBUG_DEFINE_COPY_TRACE_ALLOCATOR
+
+#endif // NETDEBUG_COPY_TRACE_ENABLED
+
+#endif // COPY_TRACE_H
@@ -0,0 +1,374 @@
+/**
+ * @file coroutine_session.h
+ * @brief 在Qt事件循环上运行的C++20协程客户端会话
+ *
+ * 每个客户端一个协程，连接状态（解码器、发送队列、空闲计时）都在协程帧上，
+ * 不再需要以QTcpSocket*为键的旁路映射表：
+ *
+ *     SessionTask Server::runSession(QTcpSocket *client) {
+ *         AsyncSocket socket(client, FramingMode::LineDelimited, m_outboundConfig);
+ *         for (;;) {
+ *             ReadResult result = co_await socket.readFrame(15000);
+ *             if (result.status != IoStatus::Ok) break;
+ *             if (socket.write(reply(result.frame)) != IoStatus::Ok) break;
+ *         }
+ *     }
+ *
+ * 等待中的协程由套接字信号（readyRead/bytesWritten/disconnected/destroyed）或超时定时器
+ * 在事件循环中直接恢复，不经过额外的事件队列。
+ *
+ * 协程帧从SessionFramePool分配：固定大小的块，数量有上限，达到上限时会话不会启动
+ * （SessionTask::started()为false），帧大小和峰值会话数记录在SessionFrameStats中。
+ * 会话协程必须是成员函数，所属对象提供sessionFramePool()。
+ * 池只覆盖协程帧本身：解码器的环形缓冲区（第一次读取时分配）、发送队列中的数据和每个会话的
+ * 超时QTimer仍从堆分配，前两者由AsyncSocket::bufferedBytes()报告，QTimer不计入。
+ *
+ * 需要C++20协程支持（编译器定义__cpp_impl_coroutine）；否则本文件为空，
+ * NETDEBUG_HAVE_COROUTINES未定义。
+ */
+
+#ifndef COROUTINE_SESSION_H
+#define COROUTINE_SESSION_H
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#define NETDEBUG_HAVE_COROUTINES 1
+
+#include <QDebug>
+#include <QPointer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QtGlobal>
+#include <coroutine>
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "frame_decoder.h"
+#include "outbound_queue.h"
+
+struct SessionFrameStats {
+    quint64 started = 0;
+    quint64 finished = 0;
+    quint64 rejected = 0;       // 达到会话上限
+    quint64 oversized = 0;      // 协程帧加块头大于块大小：需要调大blockSize，否则所有会话都无法启动
+    qint64 live = 0;
+    qint64 highWater = 0;
+    size_t frameBytes = 0;      // 实际协程帧大小（编译期确定，不含块头）
+    size_t blockBytes = 0;
+};
+
+class SessionFramePool {
+public:
+    SessionFramePool(size_t maxSessions, size_t blockSize = 2048)
+        : m_maxSessions(maxSessions) {
+        m_stats.blockBytes = blockSize;
+    }
+
+    ~SessionFramePool() {
+        Q_ASSERT(m_stats.live == 0);    // 所有会话必须在池之前结束
+        for (void *block : m_freeBlocks) {
+            ::operator delete(block);
+        }
+    }
+
+    SessionFramePool(const SessionFramePool &) = delete;
+    SessionFramePool &operator=(const SessionFramePool &) = delete;
+
+    void *allocate(size_t frameSize) noexcept {
+        m_stats.frameBytes = frameSize;
+        if (frameSize + kHeaderSize > m_stats.blockBytes) {
+            ++m_stats.oversized;
+            return nullptr;
+        }
+        if (static_cast<size_t>(m_stats.live) >= m_maxSessions) {
+            ++m_stats.rejected;
+            return nullptr;
+        }
+
+        void *block = nullptr;
+        if (!m_freeBlocks.empty()) {
+            block = m_freeBlocks.back();
+            m_freeBlocks.pop_back();
+        } else {
+            block = ::operator new(m_stats.blockBytes, std::nothrow);
+            if (!block) {
+                ++m_stats.rejected;
+                return nullptr;
+            }
+        }
+
+        *static_cast<SessionFramePool **>(block) = this;
+        ++m_stats.started;
+        m_stats.highWater = qMax(m_stats.highWater, ++m_stats.live);
+        return static_cast<char *>(block) + kHeaderSize;
+    }
+
+    // 块头记录所属的池，operator delete不需要额外参数
+    static void release(void *frame) noexcept {
+        void *block = static_cast<char *>(frame) - kHeaderSize;
+        SessionFramePool *pool = *static_cast<SessionFramePool **>(block);
+        --pool->m_stats.live;
+        ++pool->m_stats.finished;
+        pool->m_freeBlocks.push_back(block);
+    }
+
+    const SessionFrameStats &stats() const { return m_stats; }
+    size_t maxSessions() const { return m_maxSessions; }
+
+private:
+    static constexpr size_t kHeaderSize = alignof(std::max_align_t);
+
+    size_t m_maxSessions;
+    std::vector<void *> m_freeBlocks;
+    SessionFrameStats m_stats;
+};
+
+// 立即开始执行、结束时自行释放帧的会话协程
+class SessionTask {
+public:
+    struct promise_type {
+        template <typename Owner, typename... Args>
+        static void *operator new(size_t size, Owner &owner, Args &&...) noexcept {
+            return owner.sessionFramePool().allocate(size);
+        }
+        static void operator delete(void *frame) noexcept { SessionFramePool::release(frame); }
+
+        static SessionTask get_return_object_on_allocation_failure() noexcept { return SessionTask(false); }
+        SessionTask get_return_object() noexcept { return SessionTask(true); }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { qCritical() << "[ERROR] Unhandled exception in client session"; }
+    };
+
+    bool started() const { return m_started; }
+
+private:
+    explicit SessionTask(bool started) : m_started(started) {}
+    bool m_started;
+};
+
+enum class IoStatus {
+    Ok,
+    Timeout,
+    Closed,
+    ProtocolError,      // 解码器缓冲区已满仍没有完整帧
+    SlowConsumer        // write()：发送队列超过上限，已按背压策略断开
+};
+
+struct ReadResult {
+    IoStatus status = IoStatus::Ok;
+    FrameView frame;    // 在下一次readFrame()之前有效
+};
+
+/**
+ * @brief 可等待的套接字：在协程帧上持有解码器与发送队列
+ *
+ * 接管socket的生命周期，析构时deleteLater()。同一时刻只能有一个co_await。
+ */
+class AsyncSocket {
+public:
+    AsyncSocket(QTcpSocket *socket, FramingMode mode, const OutboundQueueConfig &config)
+        : m_socket(socket)
+        , m_timer(new QTimer(socket))
+        , m_decoder(mode)
+        , m_outbound(config) {
+        m_timer->setSingleShot(true);
+        // pull()暂停期间读缓冲区涨到上限后，Qt不再从内核搬运数据，对端的TCP窗口随之关闭
+        socket->setReadBufferSize(config.highWaterMark);
+        m_connections[0] = QObject::connect(socket, &QTcpSocket::readyRead, [this]() { onReadable(); });
+        m_connections[1] = QObject::connect(socket, &QTcpSocket::bytesWritten, [this](qint64) { onBytesWritten(); });
+        m_connections[2] = QObject::connect(socket, &QTcpSocket::disconnected, [this]() { onClosed(); });
+        m_connections[3] = QObject::connect(socket, &QObject::destroyed, [this]() { onClosed(); });
+        m_connections[4] = QObject::connect(m_timer, &QTimer::timeout, [this]() { wake(IoStatus::Timeout); });
+    }
+
+    ~AsyncSocket() {
+        for (const QMetaObject::Connection &connection : m_connections) {
+            QObject::disconnect(connection);
+        }
+        // 定时器是套接字的子对象，随套接字一起释放
+        if (m_socket) {
+            m_timer->stop();
+            m_socket->deleteLater();
+        }
+    }
+
+    AsyncSocket(const AsyncSocket &) = delete;
+    AsyncSocket &operator=(const AsyncSocket &) = delete;
+
+    struct FrameAwaiter {
+        AsyncSocket *socket;
+        int timeoutMs;
+
+        bool await_ready() { return socket->frameReady(); }
+        void await_suspend(std::coroutine_handle<> handle) { socket->suspend(handle, Wait::Frame, timeoutMs); }
+        ReadResult await_resume() { return ReadResult{socket->m_status, socket->m_frame}; }
+    };
+
+    struct DrainAwaiter {
+        AsyncSocket *socket;
+        int timeoutMs;
+
+        bool await_ready() { return socket->drainReady(); }
+        void await_suspend(std::coroutine_handle<> handle) { socket->suspend(handle, Wait::Drain, timeoutMs); }
+        IoStatus await_resume() { return socket->m_status; }
+    };
+
+    // 等待下一个完整帧；timeoutMs < 0表示不超时
+    FrameAwaiter readFrame(int timeoutMs = -1) { return FrameAwaiter{this, timeoutMs}; }
+
+    // 等待发送队列和套接字缓冲区都清空
+    DrainAwaiter drain(int timeoutMs = -1) { return DrainAwaiter{this, timeoutMs}; }
+
+    /**
+     * @brief 写入发送队列
+     * @return Ok；连接已关闭或写入套接字失败时为Closed；
+     *         发送队列超过上限、按背压策略断开时为SlowConsumer
+     */
+    IoStatus write(const QByteArray &data) {
+        if (m_closed || !m_socket) {
+            return IoStatus::Closed;
+        }
+        // ❌ 原来：队列溢出和连接已关闭都返回false，调用方把对端正常关闭也计为慢消费者
+        // ✅ 现在：只有enqueue()判定超过高水位才是SlowConsumer，flush()失败是连接已不可写
+        IoStatus status = IoStatus::Ok;
+        if (m_outbound.enqueue(data) == BackpressureAction::Disconnect) {
+            status = IoStatus::SlowConsumer;
+        } else if (m_outbound.flush(m_socket) == BackpressureAction::Disconnect) {
+            status = IoStatus::Closed;
+        }
+        if (status != IoStatus::Ok) {
+            m_outbound.clear();
+            m_closed = true;
+            m_socket->abort();
+        }
+        return status;
+    }
+
+    void close() {
+        if (m_socket && !m_closed) {
+            m_socket->disconnectFromHost();
+        }
+    }
+
+    bool isOpen() const { return !m_closed && m_socket; }
+    // 协程帧之外按会话持有的缓冲区字节数（解码器与发送队列）
+    qint64 bufferedBytes() const { return m_decoder.allocatedBytes() + m_outbound.queuedBytes(); }
+    QTcpSocket *socket() const { return m_socket; }
+    const OutboundQueue &outbound() const { return m_outbound; }
+
+private:
+    enum class Wait {
+        None,
+        Frame,
+        Drain
+    };
+
+    // 先交付已缓冲的帧，再报告关闭
+    bool frameReady() {
+        pull();
+        if (m_decoder.next(&m_frame)) {
+            m_status = IoStatus::Ok;
+            return true;
+        }
+        if (m_decoder.hasError()) {
+            m_status = IoStatus::ProtocolError;
+            return true;
+        }
+        if (m_closed || !m_socket) {
+            m_status = IoStatus::Closed;
+            return true;
+        }
+        return false;
+    }
+
+    bool drainReady() {
+        if (m_closed || !m_socket) {
+            m_status = IoStatus::Closed;
+            return true;
+        }
+        if (m_outbound.queuedBytes() == 0 && m_socket->bytesToWrite() == 0) {
+            m_status = IoStatus::Ok;
+            return true;
+        }
+        return false;
+    }
+
+    // 发送队列超过高水位时不读，数据积在读缓冲区，达到setReadBufferSize()上限后由TCP流控限制对端
+    void pull() {
+        if (m_socket && !m_outbound.readsPaused() && m_socket->bytesAvailable() > 0) {
+            m_decoder.readFrom(m_socket);
+        }
+    }
+
+    void suspend(std::coroutine_handle<> handle, Wait wait, int timeoutMs) {
+        m_waiter = handle;
+        m_wait = wait;
+        if (timeoutMs >= 0) {
+            m_timer->start(timeoutMs);
+        }
+    }
+
+    // 必须是每个信号处理函数的最后一步：恢复的协程可能结束并销毁本对象
+    void wake(IoStatus status) {
+        if (!m_waiter) {
+            return;
+        }
+        m_status = status;
+        m_wait = Wait::None;
+        if (m_socket) {
+            m_timer->stop();
+        }
+        std::exchange(m_waiter, {}).resume();
+    }
+
+    void onReadable() {
+        if (m_wait == Wait::Frame && frameReady()) {
+            wake(m_status);
+        }
+    }
+
+    void onBytesWritten() {
+        if (m_closed || !m_socket) {
+            return;
+        }
+        const BackpressureAction action = m_outbound.flush(m_socket);
+        if (action == BackpressureAction::Disconnect) {
+            m_outbound.clear();
+            m_closed = true;
+            m_socket->abort();
+            return;     // abort()发出disconnected，由onClosed()恢复等待者
+        }
+        if ((m_wait == Wait::Frame && frameReady()) || (m_wait == Wait::Drain && drainReady())) {
+            wake(m_status);
+        }
+    }
+
+    void onClosed() {
+        m_closed = true;
+        if (m_wait == Wait::Frame) {
+            frameReady();       // 仍可能交付已缓冲的帧
+            wake(m_status);
+        } else {
+            wake(IoStatus::Closed);
+        }
+    }
+
+    QPointer<QTcpSocket> m_socket;
+    QTimer *m_timer;
+    FrameDecoder m_decoder;
+    OutboundQueue m_outbound;
+    QMetaObject::Connection m_connections[5];
+
+    std::coroutine_handle<> m_waiter;
+    Wait m_wait = Wait::None;
+    IoStatus m_status = IoStatus::Ok;
+    FrameView m_frame;
+    bool m_closed = false;
+};
+
+#endif // __cpp_impl_coroutine
+
+#endif // COROUTINE_SESSION_H
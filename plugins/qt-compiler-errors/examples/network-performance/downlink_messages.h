@@ -0,0 +1,51 @@
+/**
+ * @file downlink_messages.h
+ * @brief 下行状态消息及其线上格式
+ *
+ * StatusReply/SelfcheckReply既作为进程内信号参数，也通过WireLayout定长编码下发。
+ * 新增字段时同时追加到对应的Wire布局末尾，并更新下面的长度断言。
+ */
+
+#ifndef DOWNLINK_MESSAGES_H
+#define DOWNLINK_MESSAGES_H
+
+#include <QtGlobal>
+
+#include "wire_codec.h"
+
+struct StatusReply {
+    int workMode = 0;
+    int loadPosition = 0;
+    bool workStatus = false;
+};
+
+struct SelfcheckReply {
+    int channelState = 0;
+    int freqConvState = 0;
+    int mainCtrlState = 0;
+    int powerState = 0;
+    int timeState = 0;
+};
+
+enum DownlinkMessageType : quint8 {
+    DownlinkStatusReply = 0x01,
+    DownlinkSelfcheckReply = 0x02
+};
+
+using StatusReplyWire = WireLayout<StatusReply, DownlinkStatusReply,
+                                   WireField<&StatusReply::workMode, qint32>,
+                                   WireField<&StatusReply::loadPosition, qint32>,
+                                   WireField<&StatusReply::workStatus, quint8>>;
+
+using SelfcheckReplyWire = WireLayout<SelfcheckReply, DownlinkSelfcheckReply,
+                                      WireField<&SelfcheckReply::channelState, qint32>,
+                                      WireField<&SelfcheckReply::freqConvState, qint32>,
+                                      WireField<&SelfcheckReply::mainCtrlState, qint32>,
+                                      WireField<&SelfcheckReply::powerState, qint32>,
+                                      WireField<&SelfcheckReply::timeState, qint32>>;
+
+// 线上格式是协议的一部分，长度变化必须是有意的
+static_assert(StatusReplyWire::kSize == 10, "StatusReply wire format changed");
+static_assert(SelfcheckReplyWire::kSize == 21, "SelfcheckReply wire format changed");
+
+#endif // DOWNLINK_MESSAGES_H
@@ -0,0 +1,236 @@
+/**
+ * @file frame_decoder.h
+ * @brief 每连接环形缓冲区帧解码器
+ *
+ * 套接字数据直接读入环形缓冲区，解码出的帧以FrameView（指针+长度）形式返回，
+ * 只有跨越环尾的帧才会复制到暂存区。正确处理TCP的半包和粘包。
+ *
+ * 支持两种分帧方式：
+ *   - LineDelimited:  以'\n'结尾的文本行（兼容telnet/nc调试）
+ *   - LengthPrefixed: 4字节大端长度 + 负载
+ */
+
+#ifndef FRAME_DECODER_H
+#define FRAME_DECODER_H
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QtEndian>
+#include <QtGlobal>
+#include <cstring>
+#include <memory>
+
+enum class FramingMode {
+    LineDelimited,
+    LengthPrefixed
+};
+
+// 指向解码器内部存储的帧视图，在下一次next()/readFrom()之前有效
+struct FrameView {
+    const char *data = nullptr;
+    qint32 size = 0;
+};
+
+class FrameDecoder {
+public:
+    static constexpr qint32 kLengthPrefixSize = 4;
+
+    // capacity必须是2的幂；缓冲区在第一次读取时才分配，空闲连接不占用内存
+    explicit FrameDecoder(FramingMode mode = FramingMode::LineDelimited, qint32 capacity = 16 * 1024)
+        : m_mode(mode)
+        , m_capacity(capacity)
+        , m_mask(static_cast<quint64>(capacity) - 1)
+        , m_maxFrameSize(capacity - kLengthPrefixSize) {
+        Q_ASSERT(capacity > kLengthPrefixSize && (capacity & (capacity - 1)) == 0);
+    }
+
+    FramingMode mode() const { return m_mode; }
+    qint32 maxFrameSize() const { return m_maxFrameSize; }
+    qint64 bufferedBytes() const { return static_cast<qint64>(m_tail - m_head); }
+    qint64 freeBytes() const { return m_capacity - bufferedBytes(); }
+    bool hasError() const { return m_error; }
+    // 当前持有的堆内存：环形缓冲区（第一次读取后）加跨环尾帧的临时副本
+    qint64 allocatedBytes() const { return (m_storage ? m_capacity : 0) + m_scratch.capacity(); }
+
+    // 下一段连续可写区域，配合commit()可以零拷贝地从任意来源写入
+    char *writePointer(qint64 *contiguous) {
+        ensureStorage();
+        const quint64 offset = m_tail & m_mask;
+        *contiguous = qMin<qint64>(freeBytes(), m_capacity - static_cast<qint64>(offset));
+        return m_storage.get() + offset;
+    }
+
+    void commit(qint64 bytes) { m_tail += static_cast<quint64>(bytes); }
+
+    // 从设备读取尽可能多的数据（最多两次read，分别填充环尾和环首）
+    qint64 readFrom(QIODevice *device) {
+        qint64 total = 0;
+        for (int pass = 0; pass < 2 && freeBytes() > 0; ++pass) {
+            qint64 contiguous = 0;
+            char *target = writePointer(&contiguous);
+            const qint64 received = device->read(target, contiguous);
+            if (received <= 0) {
+                break;
+            }
+            commit(received);
+            total += received;
+            if (received < contiguous) {
+                break;
+            }
+        }
+        return total;
+    }
+
+    // 取出下一个完整帧；数据不足或出错时返回false
+    bool next(FrameView *frame) {
+        if (m_error) {
+            return false;
+        }
+        return m_mode == FramingMode::LengthPrefixed ? nextLengthPrefixed(frame) : nextLine(frame);
+    }
+
+    // 断开时归还缓冲区
+    void release() {
+        m_storage.reset();
+        m_scratch = QByteArray();
+        m_head = m_tail = m_scanned = 0;
+        m_error = false;
+    }
+
+private:
+    void ensureStorage() {
+        if (!m_storage) {
+            m_storage.reset(new char[static_cast<size_t>(m_capacity)]);
+        }
+    }
+
+    char byteAt(quint64 position) const { return m_storage[position & m_mask]; }
+
+    // 把[position, position+size)映射为连续视图，跨越环尾时复制到暂存区
+    FrameView viewAt(quint64 position, qint32 size) {
+        const quint64 offset = position & m_mask;
+        if (offset + static_cast<quint64>(size) <= static_cast<quint64>(m_capacity)) {
+            return FrameView{m_storage.get() + offset, size};
+        }
+
+        const qint32 firstPart = static_cast<qint32>(m_capacity - static_cast<qint64>(offset));
+        m_scratch.resize(size);
+        std::memcpy(m_scratch.data(), m_storage.get() + offset, static_cast<size_t>(firstPart));
+        std::memcpy(m_scratch.data() + firstPart, m_storage.get(), static_cast<size_t>(size - firstPart));
+        return FrameView{m_scratch.constData(), size};
+    }
+
+    bool nextLengthPrefixed(FrameView *frame) {
+        if (bufferedBytes() < kLengthPrefixSize) {
+            return false;
+        }
+
+        uchar header[kLengthPrefixSize];
+        for (int i = 0; i < kLengthPrefixSize; ++i) {
+            header[i] = static_cast<uchar>(byteAt(m_head + static_cast<quint64>(i)));
+        }
+        const quint32 length = qFromBigEndian<quint32>(header);
+        if (length > static_cast<quint32>(m_maxFrameSize)) {
+            m_error = true;     // 超长帧永远无法放入缓冲区，只能断开
+            return false;
+        }
+
+        if (bufferedBytes() < kLengthPrefixSize + static_cast<qint64>(length)) {
+            return false;
+        }
+
+        *frame = viewAt(m_head + kLengthPrefixSize, static_cast<qint32>(length));
+        m_head += kLengthPrefixSize + length;
+        return true;
+    }
+
+    bool nextLine(FrameView *frame) {
+        // m_scanned记录已确认不含'\n'的位置，半包到达时不重复扫描
+        quint64 position = qMax(m_scanned, m_head);
+        while (position < m_tail) {
+            const quint64 offset = position & m_mask;
+            const size_t contiguous = static_cast<size_t>(
+                qMin<quint64>(m_tail - position, static_cast<quint64>(m_capacity) - offset));
+            const void *found = std::memchr(m_storage.get() + offset, '\n', contiguous);
+            if (!found) {
+                position += contiguous;
+                continue;
+            }
+
+            const quint64 newline = position + static_cast<quint64>(
+                static_cast<const char *>(found) - (m_storage.get() + offset));
+            qint32 size = static_cast<qint32>(newline - m_head);
+            if (size > 0 && byteAt(newline - 1) == '\r') {
+                --size;
+            }
+
+            *frame = viewAt(m_head, size);
+            m_head = newline + 1;
+            m_scanned = m_head;
+            return true;
+        }
+
+        m_scanned = position;
+        if (bufferedBytes() >= m_capacity) {
+            m_error = true;     // 整个缓冲区都没有行结束符
+        }
+        return false;
+    }
+
+    FramingMode m_mode;
+    qint64 m_capacity;
+    quint64 m_mask;
+    qint32 m_maxFrameSize;
+
+    std::unique_ptr<char[]> m_storage;
+    QByteArray m_scratch;           // 仅用于跨越环尾的帧
+    quint64 m_head = 0;             // 单调递增的读位置
+    quint64 m_tail = 0;             // 单调递增的写位置
+    quint64 m_scanned = 0;
+    bool m_error = false;
+};
+
+// 在不经过QString的情况下把"hh:mm:ss.zzz"追加到响应中
+inline void appendClockTime(QByteArray &out, int msecsSinceMidnight) {
+    char text[12];
+    const int hours = msecsSinceMidnight / 3600000;
+    const int minutes = msecsSinceMidnight / 60000 % 60;
+    const int seconds = msecsSinceMidnight / 1000 % 60;
+    const int millis = msecsSinceMidnight % 1000;
+    text[0] = static_cast<char>('0' + hours / 10);
+    text[1] = static_cast<char>('0' + hours % 10);
+    text[2] = ':';
+    text[3] = static_cast<char>('0' + minutes / 10);
+    text[4] = static_cast<char>('0' + minutes % 10);
+    text[5] = ':';
+    text[6] = static_cast<char>('0' + seconds / 10);
+    text[7] = static_cast<char>('0' + seconds % 10);
+    text[8] = '.';
+    text[9] = static_cast<char>('0' + millis / 100);
+    text[10] = static_cast<char>('0' + millis / 10 % 10);
+    text[11] = static_cast<char>('0' + millis % 10);
+    out.append(text, sizeof(text));
+}
+
+// 去掉帧首尾的ASCII空白；UTF-8多字节序列不含ASCII字节，因此无需解码
+inline FrameView trimmedFrame(FrameView frame) {
+    auto isSpace = [](char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f'; };
+    while (frame.size > 0 && isSpace(frame.data[0])) {
+        ++frame.data;
+        --frame.size;
+    }
+    while (frame.size > 0 && isSpace(frame.data[frame.size - 1])) {
+        --frame.size;
+    }
+    return frame;
+}
+
+// 追加一个长度前缀帧
+inline void appendLengthPrefixedFrame(QByteArray &out, const char *payload, qint32 size) {
+    uchar header[FrameDecoder::kLengthPrefixSize];
+    qToBigEndian<quint32>(static_cast<quint32>(size), header);
+    out.append(reinterpret_cast<const char *>(header), sizeof(header));
+    out.append(payload, size);
+}
+
+#endif // FRAME_DECODER_H
@@ -0,0 +1,161 @@
+/**
+ * @file frame_decoder_benchmark.cpp
+ * @brief FrameDecoder单核吞吐量微基准
+ *
+ * 预先生成帧流，按随机大小的"TCP分段"喂给解码器（模拟半包和粘包），
+ * 对每帧组装与服务器相同的响应，统计单核每秒处理的帧数。
+ * 同时测量旧实现（readAll + QString往返）作为对照。
+ *
+ * 用法: frame_decoder_benchmark [帧负载字节数=64] [帧数=2000000]
+ */
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QString>
+#include <QTime>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "frame_decoder.h"
+
+static QByteArray buildStream(FramingMode mode, int payloadSize, int frameCount) {
+    QByteArray payload(payloadSize, 'x');
+    QByteArray stream;
+    stream.reserve(frameCount * (payloadSize + FrameDecoder::kLengthPrefixSize));
+    for (int i = 0; i < frameCount; ++i) {
+        if (mode == FramingMode::LengthPrefixed) {
+            appendLengthPrefixedFrame(stream, payload.constData(), payload.size());
+        } else {
+            stream.append(payload);
+            stream.append('\n');
+        }
+    }
+    return stream;
+}
+
+// 随机分段大小，固定种子保证各轮可比
+static std::vector<int> buildSegments(qint64 streamSize) {
+    QRandomGenerator generator(42);
+    std::vector<int> segments;
+    for (qint64 consumed = 0; consumed < streamSize;) {
+        const int segment = generator.bounded(1, 1460 * 4);
+        segments.push_back(segment);
+        consumed += segment;
+    }
+    return segments;
+}
+
+// 解码器进入错误状态（负载超过最大帧长）时返回false：此后writePointer()不再给出空间，继续喂数据会死循环
+static bool runDecoder(FramingMode mode, const QByteArray &stream, const std::vector<int> &segments,
+                       int frameCount) {
+    FrameDecoder decoder(mode, 64 * 1024);
+    QByteArray response;
+    response.reserve(64 * 1024);
+
+    const int now = QTime::currentTime().msecsSinceStartOfDay();
+    qint64 offset = 0;
+    qint64 frames = 0;
+    qint64 responseBytes = 0;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int segment : segments) {
+        qint64 remaining = qMin<qint64>(segment, stream.size() - offset);
+        while (remaining > 0) {
+            qint64 contiguous = 0;
+            char *target = decoder.writePointer(&contiguous);
+            const qint64 chunk = qMin(contiguous, remaining);
+            std::memcpy(target, stream.constData() + offset, static_cast<size_t>(chunk));
+            decoder.commit(chunk);
+            offset += chunk;
+            remaining -= chunk;
+
+            response.resize(0);
+            FrameView frame;
+            while (decoder.next(&frame)) {
+                if (mode == FramingMode::LengthPrefixed) {
+                    appendLengthPrefixedFrame(response, frame.data, frame.size);
+                } else {
+                    const FrameView text = trimmedFrame(frame);
+                    response.append("收到数据 [");
+                    appendClockTime(response, now);
+                    response.append("]: ");
+                    response.append(text.data, text.size);
+                    response.append('\n');
+                }
+                ++frames;
+            }
+            responseBytes += response.size();
+            if (decoder.hasError()) {
+                std::fprintf(stderr, "%-16s decoder error after %lld frames: payload exceeds max frame size %d\n",
+                             mode == FramingMode::LengthPrefixed ? "length-prefixed" : "line-delimited",
+                             static_cast<long long>(frames), decoder.maxFrameSize());
+                return false;
+            }
+        }
+    }
+
+    const double seconds = timer.nsecsElapsed() / 1e9;
+    std::printf("%-16s frames=%lld/%d  %.2f Mframes/s  %.1f MB/s in  (response %lld bytes)\n",
+                mode == FramingMode::LengthPrefixed ? "length-prefixed" : "line-delimited",
+                static_cast<long long>(frames), frameCount,
+                frames / seconds / 1e6, stream.size() / seconds / 1e6,
+                static_cast<long long>(responseBytes));
+    return true;
+}
+
+// 旧实现：每个分段一次readAll()拷贝 + QString往返，且不分帧
+static void runLegacy(const QByteArray &stream, const std::vector<int> &segments) {
+    qint64 offset = 0;
+    qint64 packets = 0;
+    qint64 responseBytes = 0;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int segment : segments) {
+        const qint64 size = qMin<qint64>(segment, stream.size() - offset);
+        if (size <= 0) {
+            break;
+        }
+        const QByteArray data = stream.mid(offset, size);
+        offset += size;
+
+        QString response = QString("收到数据 [%1]: %2\n")
+                          .arg(QDateTime::currentDateTime().toString("hh:mm:ss.zzz"))
+                          .arg(QString::fromUtf8(data).trimmed());
+        responseBytes += response.toUtf8().size();
+        ++packets;
+    }
+
+    const double seconds = timer.nsecsElapsed() / 1e9;
+    std::printf("%-16s packets=%lld  %.2f Mpackets/s  %.1f MB/s in  (response %lld bytes)\n",
+                "legacy-qstring", static_cast<long long>(packets),
+                packets / seconds / 1e6, stream.size() / seconds / 1e6,
+                static_cast<long long>(responseBytes));
+}
+
+int main(int argc, char *argv[]) {
+    const int payloadSize = argc > 1 ? std::atoi(argv[1]) : 64;
+    const int frameCount = argc > 2 ? std::atoi(argv[2]) : 2000000;
+
+    std::printf("FrameDecoder benchmark: payload=%d bytes, frames=%d, single core\n", payloadSize, frameCount);
+
+    for (FramingMode mode : {FramingMode::LengthPrefixed, FramingMode::LineDelimited}) {
+        const QByteArray stream = buildStream(mode, payloadSize, frameCount);
+        const std::vector<int> segments = buildSegments(stream.size());
+        if (!runDecoder(mode, stream, segments, frameCount)) {
+            return 1;
+        }
+        if (mode == FramingMode::LineDelimited) {
+            runLegacy(stream, segments);
+        }
+    }
+
+    return 0;
+}
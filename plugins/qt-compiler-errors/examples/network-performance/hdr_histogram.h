@@ -0,0 +1,151 @@
+/**
+ * @file hdr_histogram.h
+ * @brief 高动态范围（HDR）直方图
+ *
+ * 按HdrHistogram的对数-线性分桶方式记录整数值：在[lowest, highest]范围内
+ * 保证significantDigits位有效数字精度，记录为O(1)且不分配内存，可无损合并。
+ * 用于统计往返延迟的p50/p99/p999等百分位。
+ */
+
+#ifndef HDR_HISTOGRAM_H
+#define HDR_HISTOGRAM_H
+
+#include <QtAlgorithms>
+#include <QtGlobal>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+class HdrHistogram {
+public:
+    // 默认范围1ns ~ 1h，3位有效数字
+    explicit HdrHistogram(qint64 lowest = 1, qint64 highest = 3600LL * 1000 * 1000 * 1000,
+                          int significantDigits = 3)
+        : m_lowest(lowest), m_highest(highest) {
+        const qint64 largestSingleUnitResolution = 2 * static_cast<qint64>(std::pow(10, significantDigits));
+        const int subBucketCountMagnitude = static_cast<int>(std::ceil(std::log2(largestSingleUnitResolution)));
+        m_subBucketHalfCountMagnitude = qMax(subBucketCountMagnitude, 1) - 1;
+        m_unitMagnitude = static_cast<int>(std::floor(std::log2(static_cast<double>(lowest))));
+        m_subBucketCount = qint64(1) << (m_subBucketHalfCountMagnitude + 1);
+        m_subBucketHalfCount = m_subBucketCount / 2;
+        m_subBucketMask = (m_subBucketCount - 1) << m_unitMagnitude;
+
+        // 计算覆盖highest所需的桶数
+        qint64 smallestUntrackable = m_subBucketCount << m_unitMagnitude;
+        int bucketsNeeded = 1;
+        while (smallestUntrackable <= highest) {
+            if (smallestUntrackable > (std::numeric_limits<qint64>::max() >> 1)) {
+                ++bucketsNeeded;
+                break;
+            }
+            smallestUntrackable <<= 1;
+            ++bucketsNeeded;
+        }
+        m_bucketCount = bucketsNeeded;
+        m_counts.assign(static_cast<size_t>((m_bucketCount + 1) * m_subBucketHalfCount), 0);
+    }
+
+    // 超出范围的值被截断到边界，不丢弃样本
+    void record(qint64 value, qint64 count = 1) {
+        value = qBound(m_lowest, value, m_highest);
+        m_counts[static_cast<size_t>(countsIndex(value))] += count;
+        m_totalCount += count;
+        m_min = qMin(m_min, value);
+        m_max = qMax(m_max, value);
+        m_sum += static_cast<double>(value) * count;
+    }
+
+    void merge(const HdrHistogram &other) {
+        Q_ASSERT(other.m_counts.size() == m_counts.size());
+        for (size_t i = 0; i < m_counts.size(); ++i) {
+            m_counts[i] += other.m_counts[i];
+        }
+        m_totalCount += other.m_totalCount;
+        m_min = qMin(m_min, other.m_min);
+        m_max = qMax(m_max, other.m_max);
+        m_sum += other.m_sum;
+    }
+
+    void reset() {
+        std::fill(m_counts.begin(), m_counts.end(), 0);
+        m_totalCount = 0;
+        m_min = std::numeric_limits<qint64>::max();
+        m_max = 0;
+        m_sum = 0;
+    }
+
+    qint64 totalCount() const { return m_totalCount; }
+    qint64 min() const { return m_totalCount ? m_min : 0; }
+    qint64 max() const { return m_max; }
+    double mean() const { return m_totalCount ? m_sum / m_totalCount : 0.0; }
+
+    // 返回percentile（0~100）处的值，结果为所在桶的最大等价值
+    qint64 valueAtPercentile(double percentile) const {
+        if (m_totalCount == 0) {
+            return 0;
+        }
+
+        const double clamped = qBound(0.0, percentile, 100.0);
+        qint64 target = static_cast<qint64>(std::ceil(clamped / 100.0 * m_totalCount));
+        target = qMax<qint64>(target, 1);
+
+        qint64 cumulative = 0;
+        for (size_t i = 0; i < m_counts.size(); ++i) {
+            cumulative += m_counts[i];
+            if (cumulative >= target) {
+                return qMin(highestEquivalentValue(valueFromIndex(static_cast<qint64>(i))), m_max);
+            }
+        }
+        return m_max;
+    }
+
+private:
+    int bucketIndexOf(qint64 value) const {
+        const int pow2Ceiling = 64 - qCountLeadingZeroBits(static_cast<quint64>(value | m_subBucketMask));
+        return pow2Ceiling - m_unitMagnitude - (m_subBucketHalfCountMagnitude + 1);
+    }
+
+    qint64 countsIndex(qint64 value) const {
+        const int bucketIndex = bucketIndexOf(value);
+        const qint64 subBucketIndex = value >> (bucketIndex + m_unitMagnitude);
+        const qint64 bucketBaseIndex = static_cast<qint64>(bucketIndex + 1) << m_subBucketHalfCountMagnitude;
+        return bucketBaseIndex + (subBucketIndex - m_subBucketHalfCount);
+    }
+
+    qint64 valueFromIndex(qint64 index) const {
+        int bucketIndex = static_cast<int>(index >> m_subBucketHalfCountMagnitude) - 1;
+        qint64 subBucketIndex = (index & (m_subBucketHalfCount - 1)) + m_subBucketHalfCount;
+        if (bucketIndex < 0) {
+            subBucketIndex -= m_subBucketHalfCount;
+            bucketIndex = 0;
+        }
+        return subBucketIndex << (bucketIndex + m_unitMagnitude);
+    }
+
+    qint64 highestEquivalentValue(qint64 value) const {
+        const int bucketIndex = bucketIndexOf(value);
+        const qint64 subBucketIndex = value >> (bucketIndex + m_unitMagnitude);
+        const int adjustedBucket = subBucketIndex >= m_subBucketCount ? bucketIndex + 1 : bucketIndex;
+        const qint64 rangeSize = qint64(1) << (m_unitMagnitude + adjustedBucket);
+        const qint64 lowestEquivalent = (value >> (m_unitMagnitude + adjustedBucket)) << (m_unitMagnitude + adjustedBucket);
+        return lowestEquivalent + rangeSize - 1;
+    }
+
+    qint64 m_lowest;
+    qint64 m_highest;
+    int m_unitMagnitude = 0;
+    int m_subBucketHalfCountMagnitude = 0;
+    qint64 m_subBucketCount = 0;
+    qint64 m_subBucketHalfCount = 0;
+    qint64 m_subBucketMask = 0;
+    int m_bucketCount = 0;
+
+    std::vector<qint64> m_counts;
+    qint64 m_totalCount = 0;
+    qint64 m_min = std::numeric_limits<qint64>::max();
+    qint64 m_max = 0;
+    double m_sum = 0;
+};
+
+#endif // HDR_HISTOGRAM_H
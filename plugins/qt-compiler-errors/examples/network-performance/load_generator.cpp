@@ -0,0 +1,381 @@
+/**
+ * @file load_generator.cpp
+ * @brief 回环负载生成器与延迟基准
+ *
+ * 在多个线程中各运行一个事件循环，打开大量TCP连接，按配置的消息大小和速率
+ * 发送长度前缀帧，并用HDR直方图统计往返延迟百分位，最终以JSON输出结果。
+ *
+ * 每个负载的前8字节是计划发送时间（steady_clock纳秒）。固定速率模式下延迟从
+ * "计划"发送时间算起，避免服务器变慢时因客户端少发而低估延迟（coordinated omission）。
+ *
+ * 用法示例：
+ *   network_debug_example --framing=length --reactor-threads=8
+ *   load_generator --port=50001 --connections=2000 --threads=4 --message-size=128 --rate=100 --duration=30
+ *
+ * 对不回显的服务器（如GoodNetworkServer）使用 --mode=sink，只统计发送吞吐量。
+ */
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QHostAddress>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTcpSocket>
+#include <QThread>
+#include <QTimer>
+#include <QtEndian>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "frame_decoder.h"
+#include "hdr_histogram.h"
+
+struct LoadConfig {
+    QString host = "127.0.0.1";
+    quint16 port = 50001;
+    int connections = 100;
+    int threads = 1;
+    int messageSize = 64;           // 负载字节数，不含4字节长度前缀
+    double rate = 100;              // 每连接每秒消息数；0表示闭环（收到回显再发）
+    int pipeline = 1;               // 闭环模式下每连接同时在途的消息数
+    int durationSec = 10;
+    int warmupSec = 2;
+    int tickMs = 1;
+    bool sinkMode = false;          // 服务器不回显
+};
+
+struct LoadResult {
+    HdrHistogram latencyNs;
+    qint64 connected = 0;
+    qint64 connectFailures = 0;
+    qint64 socketErrors = 0;
+    qint64 messagesSent = 0;
+    qint64 messagesReceived = 0;
+    qint64 bytesSent = 0;
+    qint64 bytesReceived = 0;
+    qint64 sendsSkipped = 0;        // 客户端发送缓冲区积压而未能按计划发送
+};
+
+static qint64 steadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct ClientConnection {
+    QTcpSocket *socket = nullptr;
+    FrameDecoder decoder{FramingMode::LengthPrefixed, 64 * 1024};
+    bool connected = false;
+    qint64 scheduled = 0;           // 已到计划发送时间的消息数
+    int inFlight = 0;
+};
+
+/**
+ * @brief 单个负载线程：自己的事件循环、连接和直方图
+ */
+class LoadWorker {
+public:
+    LoadWorker(const LoadConfig &config, int connectionCount)
+        : m_config(config), m_connectionCount(connectionCount) {
+        m_frame.resize(FrameDecoder::kLengthPrefixSize + qMax(config.messageSize, 8));
+        qToBigEndian<quint32>(static_cast<quint32>(m_frame.size() - FrameDecoder::kLengthPrefixSize),
+                              reinterpret_cast<uchar *>(m_frame.data()));
+        std::memset(m_frame.data() + FrameDecoder::kLengthPrefixSize, 'L',
+                    static_cast<size_t>(m_frame.size() - FrameDecoder::kLengthPrefixSize));
+    }
+
+    // 在负载线程中调用，直到测量结束才返回
+    void run() {
+        QEventLoop loop;
+        m_clients.resize(static_cast<size_t>(m_connectionCount));
+        for (ClientConnection &client : m_clients) {
+            openConnection(&client, &loop);
+        }
+
+        QTimer tick;
+        tick.setTimerType(Qt::PreciseTimer);
+        QObject::connect(&tick, &QTimer::timeout, &loop, [this]() { onTick(); });
+
+        QTimer::singleShot(m_config.warmupSec * 1000, &loop, [this]() {
+            m_measuring = true;
+            m_measureStartNs = steadyNowNs();
+            m_result = LoadResult();
+            for (const ClientConnection &client : m_clients) {
+                m_result.connected += client.connected ? 1 : 0;
+            }
+        });
+        QTimer::singleShot((m_config.warmupSec + m_config.durationSec) * 1000, &loop, &QEventLoop::quit);
+
+        m_startNs = steadyNowNs();
+        tick.start(m_config.tickMs);
+        loop.exec();
+
+        m_measureEndNs = steadyNowNs();
+        for (ClientConnection &client : m_clients) {
+            if (client.socket) {
+                client.socket->abort();
+                delete client.socket;
+            }
+        }
+    }
+
+    const LoadResult &result() const { return m_result; }
+    double measuredSeconds() const { return (m_measureEndNs - m_measureStartNs) / 1e9; }
+
+private:
+    void openConnection(ClientConnection *client, QObject *context) {
+        client->socket = new QTcpSocket();
+        client->socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+
+        QObject::connect(client->socket, &QTcpSocket::connected, context, [this, client]() {
+            client->connected = true;
+            ++m_result.connected;
+            // ❌ 原来：scheduled置0，onTick()会把从开始到连上之间的全部计划消息一次补发出去，
+            //    并按早已过去的计划时间计延迟，连接建立慢的客户端看起来延迟巨大
+            // ✅ 现在：从连上时刻对应的计划序号开始发送
+            if (m_config.rate > 0) {
+                const double intervalNs = 1e9 / m_config.rate;
+                client->scheduled = static_cast<qint64>((steadyNowNs() - m_startNs) / intervalNs);
+            } else {
+                // 闭环模式：一连上就发出pipeline条消息
+                for (int i = 0; i < m_config.pipeline; ++i) {
+                    sendFrame(client, steadyNowNs());
+                }
+            }
+        });
+        QObject::connect(client->socket, &QTcpSocket::readyRead, context, [this, client]() {
+            onReadyRead(client);
+        });
+        QObject::connect(client->socket, &QAbstractSocket::errorOccurred, context,
+                         [this, client](QAbstractSocket::SocketError) {
+            if (client->connected) {
+                ++m_result.socketErrors;
+            } else {
+                ++m_result.connectFailures;
+            }
+            client->connected = false;
+        });
+
+        client->socket->connectToHost(m_config.host, m_config.port);
+    }
+
+    void onTick() {
+        if (m_config.rate <= 0) {
+            return;
+        }
+
+        // 按计划时间补发：第k条消息的计划时间为 start + k / rate
+        const qint64 now = steadyNowNs();
+        const double intervalNs = 1e9 / m_config.rate;
+        const qint64 due = static_cast<qint64>((now - m_startNs) / intervalNs);
+
+        for (ClientConnection &client : m_clients) {
+            if (!client.connected) {
+                continue;
+            }
+            while (client.scheduled < due) {
+                const qint64 intendedNs = m_startNs + static_cast<qint64>(client.scheduled * intervalNs);
+                ++client.scheduled;
+                if (client.socket->bytesToWrite() > 1024 * 1024) {
+                    ++m_result.sendsSkipped;    // 服务器跟不上，不再无限堆积
+                    continue;
+                }
+                sendFrame(&client, intendedNs);
+            }
+        }
+    }
+
+    void sendFrame(ClientConnection *client, qint64 intendedNs) {
+        std::memcpy(m_frame.data() + FrameDecoder::kLengthPrefixSize, &intendedNs, sizeof(intendedNs));
+        client->socket->write(m_frame);
+        ++client->inFlight;
+        ++m_result.messagesSent;
+        m_result.bytesSent += m_frame.size();
+    }
+
+    void onReadyRead(ClientConnection *client) {
+        if (m_config.sinkMode) {
+            m_result.bytesReceived += client->socket->readAll().size();
+            return;
+        }
+
+        for (;;) {
+            const qint64 bytes = client->decoder.readFrom(client->socket);
+            m_result.bytesReceived += bytes;
+
+            const qint64 now = steadyNowNs();
+            FrameView frame;
+            while (client->decoder.next(&frame)) {
+                if (frame.size < static_cast<qint32>(sizeof(qint64))) {
+                    continue;
+                }
+                qint64 sentNs;
+                std::memcpy(&sentNs, frame.data, sizeof(sentNs));
+                --client->inFlight;
+                ++m_result.messagesReceived;
+                if (m_measuring && sentNs >= m_measureStartNs) {
+                    m_result.latencyNs.record(now - sentNs);
+                }
+                if (m_config.rate <= 0) {
+                    sendFrame(client, steadyNowNs());
+                }
+            }
+
+            if (bytes == 0 || client->socket->bytesAvailable() == 0) {
+                break;
+            }
+        }
+    }
+
+    LoadConfig m_config;
+    int m_connectionCount;
+    std::vector<ClientConnection> m_clients;
+    QByteArray m_frame;
+    LoadResult m_result;
+    bool m_measuring = false;
+    qint64 m_startNs = 0;
+    qint64 m_measureStartNs = 0;
+    qint64 m_measureEndNs = 0;
+};
+
+static QJsonObject latencyJson(const HdrHistogram &histogram) {
+    auto micros = [](qint64 ns) { return ns / 1000.0; };
+    QJsonObject latency;
+    latency["unit"] = "us";
+    latency["samples"] = histogram.totalCount();
+    latency["min"] = micros(histogram.min());
+    latency["mean"] = histogram.mean() / 1000.0;
+    latency["p50"] = micros(histogram.valueAtPercentile(50.0));
+    latency["p90"] = micros(histogram.valueAtPercentile(90.0));
+    latency["p99"] = micros(histogram.valueAtPercentile(99.0));
+    latency["p999"] = micros(histogram.valueAtPercentile(99.9));
+    latency["max"] = micros(histogram.max());
+    return latency;
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("TCP loopback load generator (length-prefixed echo protocol)");
+    parser.addHelpOption();
+    QCommandLineOption hostOption("host", "服务器地址", "host", "127.0.0.1");
+    QCommandLineOption portOption("port", "服务器端口", "port", "50001");
+    QCommandLineOption connectionsOption("connections", "连接总数", "count", "100");
+    QCommandLineOption threadsOption("threads", "负载线程数", "count", "1");
+    QCommandLineOption sizeOption("message-size", "负载字节数(>=8)", "bytes", "64");
+    QCommandLineOption rateOption("rate", "每连接每秒消息数，0为闭环", "msgs", "100");
+    QCommandLineOption pipelineOption("pipeline", "闭环模式下每连接在途消息数", "count", "1");
+    QCommandLineOption durationOption("duration", "测量时长(秒)", "seconds", "10");
+    QCommandLineOption warmupOption("warmup", "预热时长(秒)，不计入统计", "seconds", "2");
+    QCommandLineOption modeOption("mode", "echo | sink", "mode", "echo");
+    QCommandLineOption labelOption("label", "写入结果的标签（如被测后端名称）", "text", "");
+    QCommandLineOption outputOption("output", "JSON输出文件，默认标准输出", "file");
+    parser.addOptions({hostOption, portOption, connectionsOption, threadsOption, sizeOption, rateOption,
+                       pipelineOption, durationOption, warmupOption, modeOption, labelOption, outputOption});
+    parser.process(app);
+
+    LoadConfig config;
+    config.host = parser.value(hostOption);
+    config.port = static_cast<quint16>(parser.value(portOption).toUInt());
+    config.connections = qMax(1, parser.value(connectionsOption).toInt());
+    config.threads = qBound(1, parser.value(threadsOption).toInt(), config.connections);
+    config.messageSize = qMax(8, parser.value(sizeOption).toInt());
+    config.rate = parser.value(rateOption).toDouble();
+    config.pipeline = qMax(1, parser.value(pipelineOption).toInt());
+    config.durationSec = qMax(1, parser.value(durationOption).toInt());
+    config.warmupSec = qMax(0, parser.value(warmupOption).toInt());
+    config.sinkMode = parser.value(modeOption) == "sink";
+
+    // 连接均匀分配到各负载线程
+    std::vector<std::unique_ptr<LoadWorker>> workers;
+    std::vector<QThread *> threads;
+    for (int i = 0; i < config.threads; ++i) {
+        const int count = config.connections / config.threads + (i < config.connections % config.threads ? 1 : 0);
+        workers.push_back(std::make_unique<LoadWorker>(config, count));
+        LoadWorker *worker = workers.back().get();
+        threads.push_back(QThread::create([worker]() { worker->run(); }));
+        threads.back()->start();
+    }
+    for (QThread *thread : threads) {
+        thread->wait();
+        delete thread;
+    }
+
+    LoadResult total;
+    double seconds = 0;
+    QJsonArray perThread;
+    for (const std::unique_ptr<LoadWorker> &worker : workers) {
+        const LoadResult &result = worker->result();
+        total.latencyNs.merge(result.latencyNs);
+        total.connected += result.connected;
+        total.connectFailures += result.connectFailures;
+        total.socketErrors += result.socketErrors;
+        total.messagesSent += result.messagesSent;
+        total.messagesReceived += result.messagesReceived;
+        total.bytesSent += result.bytesSent;
+        total.bytesReceived += result.bytesReceived;
+        total.sendsSkipped += result.sendsSkipped;
+        seconds = qMax(seconds, worker->measuredSeconds());
+
+        QJsonObject thread;
+        thread["connected"] = result.connected;
+        thread["messages_received"] = result.messagesReceived;
+        thread["latency"] = latencyJson(result.latencyNs);
+        perThread.append(thread);
+    }
+    seconds = qMax(seconds, 1e-9);
+
+    QJsonObject configJson;
+    configJson["host"] = config.host;
+    configJson["port"] = config.port;
+    configJson["connections"] = config.connections;
+    configJson["threads"] = config.threads;
+    configJson["message_size"] = config.messageSize;
+    configJson["rate_per_connection"] = config.rate;
+    configJson["pipeline"] = config.pipeline;
+    configJson["duration_s"] = config.durationSec;
+    configJson["warmup_s"] = config.warmupSec;
+    configJson["mode"] = config.sinkMode ? "sink" : "echo";
+
+    QJsonObject throughput;
+    throughput["sent_msgs_per_s"] = total.messagesSent / seconds;
+    throughput["received_msgs_per_s"] = total.messagesReceived / seconds;
+    throughput["sent_mb_per_s"] = total.bytesSent / seconds / 1e6;
+    throughput["received_mb_per_s"] = total.bytesReceived / seconds / 1e6;
+
+    QJsonObject report;
+    report["label"] = parser.value(labelOption);
+    report["config"] = configJson;
+    report["measured_s"] = seconds;
+    report["connected"] = total.connected;
+    report["connect_failures"] = total.connectFailures;
+    report["socket_errors"] = total.socketErrors;
+    report["messages_sent"] = total.messagesSent;
+    report["messages_received"] = total.messagesReceived;
+    report["sends_skipped"] = total.sendsSkipped;
+    report["throughput"] = throughput;
+    report["latency"] = latencyJson(total.latencyNs);
+    report["per_thread"] = perThread;
+
+    const QByteArray json = QJsonDocument(report).toJson(QJsonDocument::Indented);
+    if (parser.isSet(outputOption)) {
+        QFile file(parser.value(outputOption));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qCritical() << "[ERROR] Cannot write" << file.fileName() << ":" << file.errorString();
+            return 1;
+        }
+        file.write(json);
+    } else {
+        std::fwrite(json.constData(), 1, static_cast<size_t>(json.size()), stdout);
+    }
+
+    return total.connected > 0 ? 0 : 2;
+}
@@ -0,0 +1,323 @@
+/**
+ * @file metrics.h
+ * @brief 服务器指标注册表与Prometheus文本格式抓取端点
+ *
+ * 热路径只做relaxed原子加法，不加锁；每个计数器独占一个缓存行，
+ * 不同Reactor线程各自使用带reactor标签的序列，彼此之间没有伪共享和争用。
+ * 只有注册（启动时）和抓取（每次scrape）时才持有注册表的互斥锁。
+ *
+ * 指标类型：
+ *   Counter       单调递增计数
+ *   Gauge         可增可减的当前值
+ *   Histogram     固定上界分桶（非累积存储，输出时累积），原始单位乘以scale后输出
+ *   gaugeFunction 抓取时调用回调读取，适合暴露已有的原子计数
+ *   counterFunction 同上，但回调返回的值必须单调不减（如内核维护的累计次数）
+ * retire()停止导出不再有意义的序列（如所属线程已退出），同名同标签再次注册时恢复。
+ *
+ * MetricsEndpoint在本地TCP端口上以HTTP/1.0响应 GET /metrics。
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <QByteArray>
+#include <QHostAddress>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QVariant>
+#include <QtGlobal>
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class alignas(64) Counter {
+public:
+    void increment(quint64 n = 1) { m_value.fetch_add(n, std::memory_order_relaxed); }
+    quint64 value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<quint64> m_value{0};
+};
+
+class alignas(64) Gauge {
+public:
+    void set(qint64 value) { m_value.store(value, std::memory_order_relaxed); }
+    void add(qint64 delta) { m_value.fetch_add(delta, std::memory_order_relaxed); }
+    qint64 value() const { return m_value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<qint64> m_value{0};
+};
+
+class Histogram {
+public:
+    // upperBounds为升序的原始单位上界（如纳秒），scale把原始单位换算为输出单位（如秒）
+    Histogram(std::vector<qint64> upperBounds, double scale)
+        : m_bounds(std::move(upperBounds))
+        , m_scale(scale)
+        , m_buckets(new std::atomic<quint64>[m_bounds.size() + 1]) {
+        for (size_t i = 0; i <= m_bounds.size(); ++i) {
+            m_buckets[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void observe(qint64 value) {
+        const size_t bucket = static_cast<size_t>(
+            std::lower_bound(m_bounds.begin(), m_bounds.end(), value) - m_bounds.begin());
+        m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+        m_sum.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    const std::vector<qint64> &upperBounds() const { return m_bounds; }
+    double scale() const { return m_scale; }
+    quint64 bucketCount(size_t index) const { return m_buckets[index].load(std::memory_order_relaxed); }
+    qint64 sum() const { return m_sum.load(std::memory_order_relaxed); }
+
+    // 从firstBound开始每次乘2，共count个上界
+    static std::vector<qint64> exponentialBounds(qint64 firstBound, int count) {
+        std::vector<qint64> bounds;
+        for (int i = 0; i < count; ++i) {
+            bounds.push_back(firstBound << i);
+        }
+        return bounds;
+    }
+
+private:
+    std::vector<qint64> m_bounds;
+    double m_scale;
+    std::unique_ptr<std::atomic<quint64>[]> m_buckets;    // 最后一个为+Inf
+    alignas(64) std::atomic<qint64> m_sum{0};
+};
+
+// 格式化单个标签 name="value"，多个标签用逗号连接
+inline QByteArray metricLabel(const char *name, const QByteArray &value) {
+    return QByteArray(name) + "=\"" + value + '"';
+}
+
+class MetricsRegistry {
+public:
+    static MetricsRegistry &instance() {
+        static MetricsRegistry registry;
+        return registry;
+    }
+
+    // 相同名称和标签重复注册时返回已有的序列；返回的指针在进程生命周期内有效
+    Counter *counter(const QByteArray &name, const QByteArray &help, const QByteArray &labels = QByteArray()) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Series &series = findOrCreate(name, help, "counter", labels);
+        if (!series.counter) {
+            series.counter.reset(new Counter());
+        }
+        return series.counter.get();
+    }
+
+    Gauge *gauge(const QByteArray &name, const QByteArray &help, const QByteArray &labels = QByteArray()) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Series &series = findOrCreate(name, help, "gauge", labels);
+        if (!series.gauge) {
+            series.gauge.reset(new Gauge());
+        }
+        return series.gauge.get();
+    }
+
+    Histogram *histogram(const QByteArray &name, const QByteArray &help, const QByteArray &labels,
+                         const std::vector<qint64> &upperBounds, double scale) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Series &series = findOrCreate(name, help, "histogram", labels);
+        if (!series.histogram) {
+            series.histogram.reset(new Histogram(upperBounds, scale));
+        }
+        return series.histogram.get();
+    }
+
+    // 回调在抓取线程中执行，只能读取线程安全的状态（通常是原子变量）
+    void gaugeFunction(const QByteArray &name, const QByteArray &help, const QByteArray &labels,
+                       std::function<double()> read) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        findOrCreate(name, help, "gauge", labels).read = std::move(read);
+    }
+
+    void counterFunction(const QByteArray &name, const QByteArray &help, const QByteArray &labels,
+                         std::function<double()> read) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        findOrCreate(name, help, "counter", labels).read = std::move(read);
+    }
+
+    // 序列对象保留：已返回的Counter/Gauge指针仍然有效，只是不再输出；回调立即释放
+    void retire(const QByteArray &name, const QByteArray &labels) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (Family &family : m_families) {
+            if (family.name != name) {
+                continue;
+            }
+            for (Series &series : family.series) {
+                if (series.labels == labels) {
+                    series.retired = true;
+                    series.read = nullptr;
+                }
+            }
+        }
+    }
+
+    QByteArray renderPrometheus() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        QByteArray out;
+        out.reserve(16 * 1024);
+
+        for (const Family &family : m_families) {
+            out += "# HELP " + family.name + ' ' + family.help + '\n';
+            out += "# TYPE " + family.name + ' ' + family.type + '\n';
+            for (const Series &series : family.series) {
+                if (series.retired) {
+                    continue;
+                }
+                if (series.histogram) {
+                    renderHistogram(out, family.name, series.labels, *series.histogram);
+                    continue;
+                }
+
+                out += family.name;
+                appendLabels(out, series.labels, QByteArray());
+                out += ' ';
+                if (series.counter) {
+                    out += QByteArray::number(series.counter->value());
+                } else if (series.gauge) {
+                    out += QByteArray::number(series.gauge->value());
+                } else if (series.read) {
+                    out += QByteArray::number(series.read(), 'g', 15);
+                } else {
+                    out += '0';
+                }
+                out += '\n';
+            }
+        }
+        return out;
+    }
+
+private:
+    MetricsRegistry() = default;
+
+    struct Series {
+        QByteArray labels;
+        std::unique_ptr<Counter> counter;
+        std::unique_ptr<Gauge> gauge;
+        std::unique_ptr<Histogram> histogram;
+        std::function<double()> read;
+        bool retired = false;
+    };
+
+    struct Family {
+        QByteArray name;
+        QByteArray help;
+        const char *type;
+        std::deque<Series> series;      // deque保证已返回的指针不因扩容失效
+    };
+
+    Series &findOrCreate(const QByteArray &name, const QByteArray &help, const char *type,
+                         const QByteArray &labels) {
+        auto family = std::find_if(m_families.begin(), m_families.end(),
+                                   [&name](const Family &f) { return f.name == name; });
+        if (family == m_families.end()) {
+            m_families.push_back(Family{name, help, type, {}});
+            family = m_families.end() - 1;
+        }
+        Q_ASSERT(qstrcmp(family->type, type) == 0);
+
+        for (Series &series : family->series) {
+            if (series.labels == labels) {
+                series.retired = false;
+                return series;
+            }
+        }
+        family->series.emplace_back();
+        family->series.back().labels = labels;
+        return family->series.back();
+    }
+
+    static void appendLabels(QByteArray &out, const QByteArray &labels, const QByteArray &extra) {
+        if (labels.isEmpty() && extra.isEmpty()) {
+            return;
+        }
+        out += '{';
+        out += labels;
+        if (!labels.isEmpty() && !extra.isEmpty()) {
+            out += ',';
+        }
+        out += extra;
+        out += '}';
+    }
+
+    static void renderHistogram(QByteArray &out, const QByteArray &name, const QByteArray &labels,
+                                const Histogram &histogram) {
+        const std::vector<qint64> &bounds = histogram.upperBounds();
+        quint64 cumulative = 0;
+        for (size_t i = 0; i <= bounds.size(); ++i) {
+            cumulative += histogram.bucketCount(i);
+            const QByteArray le = i < bounds.size()
+                                  ? QByteArray::number(bounds[i] * histogram.scale(), 'g', 15)
+                                  : QByteArray("+Inf");
+            out += name + "_bucket";
+            appendLabels(out, labels, metricLabel("le", le));
+            out += ' ' + QByteArray::number(cumulative) + '\n';
+        }
+        out += name + "_sum";
+        appendLabels(out, labels, QByteArray());
+        out += ' ' + QByteArray::number(histogram.sum() * histogram.scale(), 'g', 15) + '\n';
+        out += name + "_count";
+        appendLabels(out, labels, QByteArray());
+        out += ' ' + QByteArray::number(cumulative) + '\n';
+    }
+
+    mutable std::mutex m_mutex;     // 只在注册和抓取时加锁
+    std::deque<Family> m_families;
+};
+
+/**
+ * @brief 最小HTTP抓取端点：任何请求都返回当前指标，响应后关闭连接
+ *
+ * 运行在创建它的线程的事件循环中，抓取与I/O线程互不阻塞。
+ */
+class MetricsEndpoint {
+public:
+    explicit MetricsEndpoint(MetricsRegistry &registry = MetricsRegistry::instance())
+        : m_registry(registry) {
+        QObject::connect(&m_server, &QTcpServer::newConnection, &m_server, [this]() {
+            while (QTcpSocket *socket = m_server.nextPendingConnection()) {
+                QObject::connect(socket, &QTcpSocket::readyRead, socket, [this, socket]() { serve(socket); });
+                QObject::connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+            }
+        });
+    }
+
+    bool listen(const QHostAddress &address, quint16 port) { return m_server.listen(address, port); }
+    QString errorString() const { return m_server.errorString(); }
+    quint16 port() const { return m_server.serverPort(); }
+
+private:
+    void serve(QTcpSocket *socket) {
+        // 请求头读完（空行）之前不响应；请求内容本身不关心
+        const QByteArray request = socket->property("request").toByteArray() + socket->readAll();
+        if (!request.contains("\r\n\r\n") && !request.contains("\n\n") && request.size() < 8192) {
+            socket->setProperty("request", request);
+            return;
+        }
+
+        const QByteArray body = m_registry.renderPrometheus();
+        QByteArray response = "HTTP/1.0 200 OK\r\n"
+                              "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                              "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                              "Connection: close\r\n\r\n";
+        response += body;
+        socket->write(response);
+        socket->disconnectFromHost();
+    }
+
+    MetricsRegistry &m_registry;
+    QTcpServer m_server;
+};
+
+#endif // METRICS_H
@@ -0,0 +1,891 @@
+/**
+ * @file native_reactor.h
+ * @brief Linux原生I/O后端：边沿触发epoll，可选io_uring
+ *
+ * 接受仍由QTcpServer完成，已接受的描述符交给NativeReactor线程直接驱动，
+ * 不创建QTcpSocket，不经过事件队列和QIODevice内部缓冲：
+ *   - Epoll:   EPOLLIN|EPOLLOUT|EPOLLRDHUP|EPOLLET一次注册，读到EAGAIN为止，
+ *              直接recv()进FrameDecoder的环形缓冲区，send()失败于EAGAIN时等待EPOLLOUT
+ *   - IoUring: 每连接最多一个在途recv和一个在途send，完成后再提交下一次；
+ *              需要liburing，并在编译时定义NETDEBUG_HAVE_IO_URING
+ *
+ * 分帧、响应组装、发送队列背压、空闲心跳和指标与Qt后端语义相同：
+ * 帧通过NativeHandlers::onFrame交给与Qt后端同一个处理函数。
+ */
+
+#ifndef NATIVE_REACTOR_H
+#define NATIVE_REACTOR_H
+
+#include <QtGlobal>
+
+#ifdef Q_OS_LINUX
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QString>
+#include <QTime>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#ifdef NETDEBUG_HAVE_IO_URING
+#include <liburing.h>
+#endif
+
+#include "async_logger.h"
+#include "frame_decoder.h"
+#include "outbound_queue.h"
+#include "reactor_metrics.h"
+#include "slot_map.h"
+#include "timing_wheel.h"
+
+enum class NativeBackend {
+    Epoll,
+    IoUring
+};
+
+// 所有回调都在Reactor线程中调用
+struct NativeHandlers {
+    std::function<void(const FrameView &frame, int clockMs, QByteArray *response)> onFrame;
+    std::function<QByteArray(quint32 clientId)> greeting;   // 可为空
+    QByteArray heartbeat;
+    std::function<void()> threadStarted;                    // 可为空，在Reactor线程入口调用
+    std::function<void()> threadFinished;                   // 可为空，在Reactor线程退出前调用
+};
+
+class NativeReactor {
+public:
+    NativeReactor(int index, NativeBackend backend, FramingMode mode, const OutboundQueueConfig &outboundConfig,
+                  const IdleTimeoutConfig &idleConfig, NativeHandlers handlers)
+        : m_index(index)
+        , m_backend(backend)
+        , m_framingMode(mode)
+        , m_outboundConfig(outboundConfig)
+        , m_idleConfig(idleConfig)
+        , m_handlers(std::move(handlers))
+        , m_metrics(QByteArray(backend == NativeBackend::Epoll ? "epoll-" : "uring-") + QByteArray::number(index)) {
+        m_connections.reserve(1024);
+    }
+
+    ~NativeReactor() { stop(); }
+
+    NativeReactor(const NativeReactor &) = delete;
+    NativeReactor &operator=(const NativeReactor &) = delete;
+
+    int index() const { return m_index; }
+    NativeBackend backend() const { return m_backend; }
+    const char *backendName() const { return m_backend == NativeBackend::Epoll ? "epoll" : "io_uring"; }
+
+    int connectionCount() const { return static_cast<int>(m_metrics.connections->value()); }
+    int nearTimeoutCount() const { return static_cast<int>(m_metrics.nearTimeout->value()); }
+    quint64 heartbeatsSent() const { return m_metrics.heartbeats->value(); }
+    quint64 idleDisconnects() const { return m_metrics.idleDisconnects->value(); }
+
+    // 由接受线程在adopt()之前调用，保证LeastLoaded在突发连接下也能看到最新负载
+    void reserveConnection() { m_metrics.connections->add(1); }
+
+    bool start(QString *errorMessage) {
+        m_wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (m_wakeFd < 0) {
+            *errorMessage = QString("eventfd: %1").arg(std::strerror(errno));
+            return false;
+        }
+
+        if (m_backend == NativeBackend::Epoll) {
+            m_epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+            if (m_epollFd < 0) {
+                *errorMessage = QString("epoll_create1: %1").arg(std::strerror(errno));
+                closeDescriptors();
+                return false;
+            }
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.u64 = kWakeToken;
+            ::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_wakeFd, &event);
+        } else {
+#ifdef NETDEBUG_HAVE_IO_URING
+            const int result = io_uring_queue_init(kRingEntries, &m_ring, 0);
+            if (result < 0) {
+                *errorMessage = QString("io_uring_queue_init: %1").arg(std::strerror(-result));
+                closeDescriptors();
+                return false;
+            }
+            m_ringReady = true;
+#else
+            *errorMessage = "io_uring support not compiled in (define NETDEBUG_HAVE_IO_URING and link liburing)";
+            closeDescriptors();
+            return false;
+#endif
+        }
+
+        m_clock.start();
+        m_idleWheel = IdleWheel(m_idleConfig.tickMs, m_clock.elapsed());
+        m_stopping.store(false, std::memory_order_relaxed);
+        m_thread = std::thread([this]() {
+            if (m_handlers.threadStarted) {
+                m_handlers.threadStarted();
+            }
+            if (m_backend == NativeBackend::Epoll) {
+                runEpoll();
+            } else {
+#ifdef NETDEBUG_HAVE_IO_URING
+                runIoUring();
+#endif
+            }
+            if (m_handlers.threadFinished) {
+                m_handlers.threadFinished();
+            }
+        });
+        return true;
+    }
+
+    void stop() {
+        if (m_thread.joinable()) {
+            m_stopping.store(true, std::memory_order_release);
+            wake();
+            m_thread.join();
+        }
+
+        // 线程已退出，以下状态不再有并发访问者；先退出io_uring（取消在途操作），再释放连接缓冲区
+        for (NativeConnection &connection : m_connections) {
+            ::close(connection.fd);
+        }
+        closeDescriptors();
+        m_connections = SlotMap<NativeConnection>();
+        {
+            std::lock_guard<std::mutex> lock(m_pendingMutex);
+            for (const PendingDescriptor &pending : m_pending) {
+                ::close(static_cast<int>(pending.fd));
+            }
+            m_pending.clear();
+        }
+    }
+
+    // 任意线程调用：描述符排队，由Reactor线程在下一次唤醒时接管
+    void adopt(qintptr socketDescriptor, quint32 clientId) {
+        {
+            std::lock_guard<std::mutex> lock(m_pendingMutex);
+            m_pending.push_back(PendingDescriptor{socketDescriptor, clientId});
+        }
+        wake();
+    }
+
+private:
+    using IdleWheel = TimingWheel<SlotHandle>;
+
+    static constexpr quint64 kWakeToken = 0;        // 句柄的generation从不为0
+    static constexpr int kMaxEvents = 256;
+    static constexpr unsigned kRingEntries = 4096;
+
+    struct PendingDescriptor {
+        qintptr fd;
+        quint32 clientId;
+    };
+
+    struct NativeConnection {
+        int fd = -1;
+        quint32 id = 0;
+        quint32 peerAddress = 0;
+        quint16 peerPort = 0;
+        FrameDecoder decoder;
+        OutboundQueue outbound;
+        QByteArray txBuffer;
+        qint64 lastActivityMs = 0;
+        IdleWheel::TimerId idleTimer = IdleWheel::kInvalidTimer;
+        bool heartbeatPending = false;
+        bool readPending = false;       // 暂停读取时内核中仍有数据，边沿触发不会再次通知
+        bool closing = false;           // io_uring：等待在途操作完成后再释放
+        bool recvInFlight = false;
+        bool sendInFlight = false;
+        qint64 reportedQueuedBytes = 0;
+    };
+
+    static quint64 tokenFor(SlotHandle handle) {
+        return (static_cast<quint64>(handle.index) << 32) | handle.generation;
+    }
+
+    static SlotHandle handleFor(quint64 token) {
+        SlotHandle handle;
+        handle.index = static_cast<quint32>(token >> 32);
+        handle.generation = static_cast<quint32>(token);
+        return handle;
+    }
+
+    void wake() {
+        const quint64 one = 1;
+        if (m_wakeFd >= 0) {
+            const ssize_t ignored = ::write(m_wakeFd, &one, sizeof(one));
+            Q_UNUSED(ignored);
+        }
+    }
+
+    void closeDescriptors() {
+#ifdef NETDEBUG_HAVE_IO_URING
+        if (m_ringReady) {
+            io_uring_queue_exit(&m_ring);
+            m_ringReady = false;
+        }
+#endif
+        if (m_epollFd >= 0) {
+            ::close(m_epollFd);
+            m_epollFd = -1;
+        }
+        if (m_wakeFd >= 0) {
+            ::close(m_wakeFd);
+            m_wakeFd = -1;
+        }
+    }
+
+    int tickTimeoutMs() const { return m_idleConfig.enabled() ? static_cast<int>(m_idleWheel.tickMs()) : -1; }
+
+    // ===== 接管与关闭 =====
+
+    void adoptPending() {
+        std::vector<PendingDescriptor> pending;
+        {
+            std::lock_guard<std::mutex> lock(m_pendingMutex);
+            pending.swap(m_pending);
+        }
+
+        for (const PendingDescriptor &descriptor : pending) {
+            const int fd = static_cast<int>(descriptor.fd);
+            const int flags = ::fcntl(fd, F_GETFL, 0);
+            if (flags < 0 || ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+                NETLOG_ERROR(NetLogCategory::Error, "Reactor %d 无法接管套接字描述符 %d", m_index, fd);
+                ::close(fd);
+                m_metrics.connections->add(-1);
+                m_metrics.acceptFailures->increment();
+                continue;
+            }
+            const int noDelay = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+            NativeConnection state;
+            state.fd = fd;
+            state.id = descriptor.clientId;
+            sockaddr_in peer{};
+            socklen_t peerLength = sizeof(peer);
+            if (::getpeername(fd, reinterpret_cast<sockaddr*>(&peer), &peerLength) == 0 && peer.sin_family == AF_INET) {
+                state.peerAddress = ntohl(peer.sin_addr.s_addr);
+                state.peerPort = ntohs(peer.sin_port);
+            }
+            state.decoder = FrameDecoder(m_framingMode);
+            state.outbound = OutboundQueue(m_outboundConfig);
+            state.lastActivityMs = m_clock.elapsed();
+            const SlotHandle handle = m_connections.insert(std::move(state));
+            NativeConnection *connection = m_connections.find(handle);
+
+            if (m_backend == NativeBackend::Epoll) {
+                epoll_event event{};
+                event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+                event.data.u64 = tokenFor(handle);
+                if (::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &event) < 0) {
+                    NETLOG_ERROR(NetLogCategory::Error, "Reactor %d epoll_ctl失败，描述符 %d", m_index, fd);
+                    m_metrics.acceptFailures->increment();
+                    ::close(fd);
+                    m_connections.remove(handle);
+                    m_metrics.connections->add(-1);
+                    continue;
+                }
+            }
+
+            m_metrics.accepted->increment();
+            if (m_idleConfig.enabled()) {
+                connection->idleTimer = m_idleWheel.arm(nextDeadline(*connection, connection->lastActivityMs), handle);
+            }
+            NETLOG_INFO(NetLogCategory::Connection, "新的客户端连接 - 客户端 %a:%d (ID:%d)",
+                        connection->peerAddress, connection->peerPort, connection->id);
+
+            if (m_handlers.greeting) {
+                send(handle, m_handlers.greeting(connection->id));
+                connection = m_connections.find(handle);
+            }
+#ifdef NETDEBUG_HAVE_IO_URING
+            if (connection && m_backend == NativeBackend::IoUring) {
+                submitRecv(handle);
+            }
+#endif
+        }
+    }
+
+    void closeConnection(SlotHandle handle) {
+        NativeConnection *connection = m_connections.find(handle);
+        if (!connection || connection->closing) {
+            return;
+        }
+
+        if (connection->idleTimer != IdleWheel::kInvalidTimer) {
+            m_idleWheel.cancel(connection->idleTimer);
+            connection->idleTimer = IdleWheel::kInvalidTimer;
+        }
+        if (connection->heartbeatPending) {
+            connection->heartbeatPending = false;
+            m_metrics.nearTimeout->add(-1);
+        }
+
+        // io_uring：内核仍持有缓冲区指针，先shutdown让在途操作尽快完成，再释放
+        if (connection->recvInFlight || connection->sendInFlight) {
+            connection->closing = true;
+            ::shutdown(connection->fd, SHUT_RDWR);
+            return;
+        }
+        releaseConnection(handle);
+    }
+
+    void releaseConnection(SlotHandle handle) {
+        NativeConnection *connection = m_connections.find(handle);
+        NETLOG_INFO(NetLogCategory::Connection, "客户端断开连接 - 客户端 %a:%d (ID:%d)",
+                    connection->peerAddress, connection->peerPort, connection->id);
+
+        ::close(connection->fd);    // 关闭描述符同时将其移出epoll
+        m_metrics.queuedBytes->add(-connection->reportedQueuedBytes);
+        m_connections.remove(handle);
+        m_metrics.connections->add(-1);
+    }
+
+    // ===== 数据路径（两种后端共用） =====
+
+    // 解码缓冲区中所有完整帧，响应追加到txBuffer
+    void decodeFrames(NativeConnection *connection, int clockMs, qint64 *frames) {
+        FrameView frame;
+        while (connection->decoder.next(&frame)) {
+            ++*frames;
+            NETLOG_DATA("接收数据，客户端ID: %d - %x", frame.data, frame.size, connection->id);
+            m_handlers.onFrame(frame, clockMs, &connection->txBuffer);
+        }
+    }
+
+    // 一批数据解码完成后：更新统计和空闲状态，响应入队并发送；返回false表示连接已关闭
+    bool finishInput(SlotHandle handle, qint64 received, qint64 frames, qint64 unsentFrames, qint64 startNs) {
+        NativeConnection *connection = m_connections.find(handle);
+        if (connection->decoder.hasError()) {
+            NETLOG_ERROR(NetLogCategory::Error, "客户端 %d 帧超过最大长度 %d 字节，断开连接",
+                         connection->id, connection->decoder.maxFrameSize());
+            closeConnection(handle);
+            return false;
+        }
+        if (received == 0) {
+            return true;
+        }
+
+        connection->lastActivityMs = startNs / 1000000;
+        if (connection->heartbeatPending) {
+            connection->heartbeatPending = false;
+            m_metrics.nearTimeout->add(-1);
+        }
+        m_metrics.bytesIn->increment(static_cast<quint64>(received));
+        m_metrics.framesIn->increment(static_cast<quint64>(frames));
+
+        bool open = true;
+        if (!connection->txBuffer.isEmpty()) {
+            m_metrics.framesOut->increment(static_cast<quint64>(unsentFrames));
+            open = send(handle, connection->txBuffer);
+        }
+        m_metrics.readLatency->observe(m_clock.nsecsElapsed() - startNs);
+        return open;
+    }
+
+    // 入队并尽量立即发送；返回false表示连接因背压被关闭
+    bool send(SlotHandle handle, const QByteArray &message) {
+        NativeConnection *connection = m_connections.find(handle);
+        BackpressureAction action = connection->outbound.enqueue(message);
+        if (action != BackpressureAction::Disconnect) {
+            // 发送后的状态更新：入队时暂停、发送后又降到低水位则以恢复为准
+            const BackpressureAction flushAction = flush(handle);
+            if (flushAction != BackpressureAction::None) {
+                action = flushAction;
+            }
+        }
+        return applyBackpressure(handle, action);
+    }
+
+    BackpressureAction flush(SlotHandle handle) {
+#ifdef NETDEBUG_HAVE_IO_URING
+        if (m_backend == NativeBackend::IoUring) {
+            submitSend(handle);
+            return BackpressureAction::None;
+        }
+#endif
+        NativeConnection *connection = m_connections.find(handle);
+        BackpressureAction result = BackpressureAction::None;
+        const char *data = nullptr;
+        qint64 size = 0;
+        while (connection->outbound.peekFront(&data, &size)) {
+            const ssize_t written = ::send(connection->fd, data, static_cast<size_t>(size), MSG_NOSIGNAL);
+            if (written > 0) {
+                m_metrics.bytesOut->increment(static_cast<quint64>(written));
+                const BackpressureAction action = connection->outbound.consume(written);
+                if (action != BackpressureAction::None) {
+                    result = action;
+                }
+                continue;
+            }
+            if (written < 0 && errno == EINTR) {
+                continue;
+            }
+            if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                break;      // 内核发送缓冲区已满，等待EPOLLOUT
+            }
+            recordSocketError(written < 0 ? errno : EPIPE);
+            return BackpressureAction::Disconnect;
+        }
+        return result;
+    }
+
+    // 返回false表示连接已关闭
+    bool applyBackpressure(SlotHandle handle, BackpressureAction action) {
+        NativeConnection *connection = m_connections.find(handle);
+        switch (action) {
+        case BackpressureAction::None:
+            break;
+        case BackpressureAction::PauseReads:
+            NETLOG_WARNING(NetLogCategory::Connection, "客户端 %d 发送队列超过高水位 (%d 字节)，暂停读取",
+                           connection->id, connection->outbound.queuedBytes());
+            break;
+        case BackpressureAction::ResumeReads:
+            NETLOG_INFO(NetLogCategory::Connection, "客户端 %d 发送队列低于低水位，恢复读取", connection->id);
+            // 不在这里递归读取，本轮事件处理完后统一恢复
+            m_resumed.push_back(handle);
+            break;
+        case BackpressureAction::Disconnect:
+            NETLOG_WARNING(NetLogCategory::Connection, "客户端 %d 跟不上发送速度 (排队 %d 字节)，断开连接",
+                           connection->id, connection->outbound.queuedBytes());
+            m_metrics.slowConsumerDisconnects->increment();
+            if (!connection->sendInFlight) {
+                connection->outbound.clear();
+            }
+            updateQueueGauge(connection);
+            closeConnection(handle);
+            return false;
+        }
+
+        updateQueueGauge(connection);
+        return true;
+    }
+
+    void updateQueueGauge(NativeConnection *connection) {
+        const qint64 queued = connection->outbound.queuedBytes();
+        if (queued != connection->reportedQueuedBytes) {
+            m_metrics.queuedBytes->add(queued - connection->reportedQueuedBytes);
+            connection->reportedQueuedBytes = queued;
+        }
+    }
+
+    void resumeReads() {
+        for (size_t i = 0; i < m_resumed.size(); ++i) {
+            const SlotHandle handle = m_resumed[i];
+            NativeConnection *connection = m_connections.find(handle);
+            if (!connection || connection->closing || connection->outbound.readsPaused()) {
+                continue;
+            }
+#ifdef NETDEBUG_HAVE_IO_URING
+            if (m_backend == NativeBackend::IoUring) {
+                submitRecv(handle);
+                continue;
+            }
+#endif
+            if (connection->readPending) {
+                connection->readPending = false;
+                onReadable(handle);
+            }
+        }
+        m_resumed.clear();
+    }
+
+    // 把errno归入与Qt后端相同的SocketError种类，两条路径的错误指标可以直接对比
+    void recordSocketError(int error) {
+        const char *kind = "NetworkError";
+        switch (error) {
+        case ECONNRESET:
+        case EPIPE:
+            kind = "RemoteHostClosedError";
+            break;
+        case ETIMEDOUT:
+            kind = "SocketTimeoutError";
+            break;
+        case ENOBUFS:
+        case ENOMEM:
+            kind = "SocketResourceError";
+            break;
+        default:
+            break;
+        }
+        m_metrics.socketError(kind)->increment();
+        NETLOG_WARNING(NetLogCategory::Error, "Reactor %d 套接字错误: %s (errno %d)",
+                       m_index, reinterpret_cast<qintptr>(kind), error);
+    }
+
+    // ===== 空闲检测 =====
+
+    qint64 nextDeadline(const NativeConnection &connection, qint64 now) const {
+        return nextIdleDeadline(m_idleConfig, connection.lastActivityMs, connection.heartbeatPending, now);
+    }
+
+    void advanceIdleWheel() {
+        if (!m_idleConfig.enabled()) {
+            return;
+        }
+
+        const qint64 now = m_clock.elapsed();
+        m_expiredTimers.clear();
+        if (m_idleWheel.advance(now, &m_expiredTimers) == 0) {
+            return;
+        }
+
+        for (const SlotHandle handle : m_expiredTimers) {
+            NativeConnection *connection = m_connections.find(handle);
+            if (!connection || connection->closing) {
+                continue;
+            }
+            connection->idleTimer = IdleWheel::kInvalidTimer;
+
+            const qint64 idle = now - connection->lastActivityMs;
+            const IdleAction action = idleActionFor(m_idleConfig, idle);
+            if (action == IdleAction::Disconnect) {
+                NETLOG_WARNING(NetLogCategory::Connection, "客户端 %d 空闲 %d 毫秒，断开连接", connection->id, idle);
+                m_metrics.idleDisconnects->increment();
+                closeConnection(handle);
+                continue;
+            }
+            if (action == IdleAction::SendHeartbeat) {
+                if (!connection->heartbeatPending) {
+                    connection->heartbeatPending = true;
+                    m_metrics.nearTimeout->add(1);
+                }
+                NETLOG_DEBUG(NetLogCategory::Debug, "发送心跳给客户端 %d", connection->id);
+                m_metrics.heartbeats->increment();
+                if (!send(handle, m_handlers.heartbeat)) {
+                    continue;
+                }
+                connection = m_connections.find(handle);
+            }
+            connection->idleTimer = m_idleWheel.arm(nextDeadline(*connection, now), handle);
+        }
+    }
+
+    // ===== epoll =====
+
+    void runEpoll() {
+        epoll_event events[kMaxEvents];
+        while (!m_stopping.load(std::memory_order_acquire)) {
+            const int count = ::epoll_wait(m_epollFd, events, kMaxEvents, tickTimeoutMs());
+            if (count < 0 && errno != EINTR) {
+                NETLOG_ERROR(NetLogCategory::Error, "Reactor %d epoll_wait失败 (errno %d)", m_index, errno);
+                break;
+            }
+
+            for (int i = 0; i < count; ++i) {
+                const quint64 token = events[i].data.u64;
+                if (token == kWakeToken) {
+                    quint64 value;
+                    while (::read(m_wakeFd, &value, sizeof(value)) > 0) {
+                    }
+                    adoptPending();
+                    continue;
+                }
+
+                const SlotHandle handle = handleFor(token);
+                const quint32 ready = events[i].events;
+                if (ready & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+                    onReadable(handle);
+                }
+                if (ready & EPOLLOUT) {
+                    onWritable(handle);
+                }
+            }
+
+            resumeReads();
+            advanceIdleWheel();
+        }
+    }
+
+    void onReadable(SlotHandle handle) {
+        NativeConnection *connection = m_connections.find(handle);
+        if (!connection) {
+            return;     // 同一批事件中已关闭
+        }
+        if (connection->outbound.readsPaused()) {
+            connection->readPending = true;
+            return;
+        }
+
+        const qint64 startNs = m_clock.nsecsElapsed();
+        const int clockMs = QTime::currentTime().msecsSinceStartOfDay();
+        connection->txBuffer.resize(0);
+        qint64 received = 0;
+        qint64 frames = 0;
+        qint64 sentFrames = 0;
+        int error = 0;
+        bool peerClosed = false;
+
+        // 边沿触发：必须读到EAGAIN，否则剩余数据不会再有通知
+        for (;;) {
+            qint64 contiguous = 0;
+            char *target = connection->decoder.writePointer(&contiguous);
+            if (contiguous == 0) {
+                break;
+            }
+            const ssize_t bytes = ::recv(connection->fd, target, static_cast<size_t>(contiguous), 0);
+            if (bytes > 0) {
+                connection->decoder.commit(bytes);
+                received += bytes;
+                decodeFrames(connection, clockMs, &frames);
+                if (connection->decoder.hasError()) {
+                    break;
+                }
+                // 输入量大时分段入队，让响应边读边发，而不是整批压入队列后才触发背压
+                if (connection->txBuffer.size() >= m_outboundConfig.coalesceLimit) {
+                    m_metrics.framesOut->increment(static_cast<quint64>(frames - sentFrames));
+                    sentFrames = frames;
+                    if (!send(handle, connection->txBuffer)) {
+                        return;
+                    }
+                    connection = m_connections.find(handle);
+                    connection->txBuffer.resize(0);
+                    if (connection->outbound.readsPaused()) {
+                        connection->readPending = true;
+                        break;
+                    }
+                }
+                continue;
+            }
+            if (bytes == 0) {
+                peerClosed = true;
+            } else if (errno == EINTR) {
+                continue;
+            } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                error = errno;
+            }
+            break;
+        }
+
+        if (!finishInput(handle, received, frames, frames - sentFrames, startNs)) {
+            return;
+        }
+        if (error != 0) {
+            recordSocketError(error);
+            closeConnection(handle);
+        } else if (peerClosed) {
+            closeConnection(handle);
+        }
+    }
+
+    void onWritable(SlotHandle handle) {
+        NativeConnection *connection = m_connections.find(handle);
+        if (!connection || connection->outbound.queuedBytes() == 0) {
+            return;
+        }
+        applyBackpressure(handle, flush(handle));
+    }
+
+#ifdef NETDEBUG_HAVE_IO_URING
+    // ===== io_uring =====
+
+    enum : quint64 {
+        kOpRecv = quint64(1) << 62,
+        kOpSend = quint64(2) << 62,
+        kOpMask = quint64(3) << 62
+    };
+
+    io_uring_sqe *acquireSqe() {
+        io_uring_sqe *sqe = io_uring_get_sqe(&m_ring);
+        if (!sqe) {
+            io_uring_submit(&m_ring);   // 提交队列已满，先提交再取
+            sqe = io_uring_get_sqe(&m_ring);
+        }
+        return sqe;
+    }
+
+    void submitWakeRead() {
+        io_uring_sqe *sqe = acquireSqe();
+        io_uring_prep_read(sqe, m_wakeFd, &m_wakeValue, sizeof(m_wakeValue), 0);
+        io_uring_sqe_set_data64(sqe, kWakeToken);
+    }
+
+    void submitRecv(SlotHandle handle) {
+        NativeConnection *connection = m_connections.find(handle);
+        if (!connection || connection->recvInFlight || connection->closing) {
+            return;
+        }
+        qint64 contiguous = 0;
+        char *target = connection->decoder.writePointer(&contiguous);
+        io_uring_sqe *sqe = acquireSqe();
+        io_uring_prep_recv(sqe, connection->fd, target, static_cast<size_t>(contiguous), 0);
+        io_uring_sqe_set_data64(sqe, tokenFor(handle) | kOpRecv);
+        connection->recvInFlight = true;
+    }
+
+    void submitSend(SlotHandle handle) {
+        NativeConnection *connection = m_connections.find(handle);
+        const char *data = nullptr;
+        qint64 size = 0;
+        if (!connection || connection->sendInFlight || connection->closing
+            || !connection->outbound.peekFront(&data, &size)) {
+            return;
+        }
+        io_uring_sqe *sqe = acquireSqe();
+        io_uring_prep_send(sqe, connection->fd, data, static_cast<size_t>(size), MSG_NOSIGNAL);
+        io_uring_sqe_set_data64(sqe, tokenFor(handle) | kOpSend);
+        connection->sendInFlight = true;
+    }
+
+    void runIoUring() {
+        submitWakeRead();
+        while (!m_stopping.load(std::memory_order_acquire)) {
+            io_uring_submit(&m_ring);
+
+            io_uring_cqe *cqe = nullptr;
+            int result;
+            if (m_idleConfig.enabled()) {
+                // tickMs可以超过1秒，tv_nsec必须小于10^9，否则内核返回-EINVAL
+                const qint64 tickMs = m_idleWheel.tickMs();
+                __kernel_timespec timeout{};
+                timeout.tv_sec = tickMs / 1000;
+                timeout.tv_nsec = (tickMs % 1000) * 1000000;
+                result = io_uring_wait_cqe_timeout(&m_ring, &cqe, &timeout);
+            } else {
+                result = io_uring_wait_cqe(&m_ring, &cqe);
+            }
+            if (result < 0 && result != -ETIME && result != -EINTR) {
+                NETLOG_ERROR(NetLogCategory::Error, "Reactor %d io_uring_wait_cqe失败 (%d)", m_index, result);
+                break;
+            }
+
+            // 一次处理所有已完成的操作，批量推进完成队列
+            unsigned head;
+            unsigned completed = 0;
+            io_uring_for_each_cqe(&m_ring, head, cqe) {
+                onCompletion(io_uring_cqe_get_data64(cqe), cqe->res);
+                ++completed;
+            }
+            io_uring_cq_advance(&m_ring, completed);
+
+            resumeReads();
+            advanceIdleWheel();
+        }
+    }
+
+    void onCompletion(quint64 userData, int result) {
+        if (userData == kWakeToken) {
+            adoptPending();
+            submitWakeRead();
+            return;
+        }
+
+        const SlotHandle handle = handleFor(userData & ~kOpMask);
+        NativeConnection *connection = m_connections.find(handle);
+        if (!connection) {
+            return;
+        }
+
+        if ((userData & kOpMask) == kOpRecv) {
+            connection->recvInFlight = false;
+            onRecvCompleted(handle, result);
+        } else {
+            connection->sendInFlight = false;
+            onSendCompleted(handle, result);
+        }
+
+        connection = m_connections.find(handle);
+        if (connection && connection->closing && !connection->recvInFlight && !connection->sendInFlight) {
+            releaseConnection(handle);
+        }
+    }
+
+    void onRecvCompleted(SlotHandle handle, int result) {
+        NativeConnection *connection = m_connections.find(handle);
+        if (connection->closing) {
+            return;
+        }
+        if (result == -EINTR || result == -EAGAIN) {
+            submitRecv(handle);
+            return;
+        }
+        if (result <= 0) {
+            if (result < 0) {
+                recordSocketError(-result);
+            }
+            closeConnection(handle);
+            return;
+        }
+
+        const qint64 startNs = m_clock.nsecsElapsed();
+        qint64 frames = 0;
+        connection->txBuffer.resize(0);
+        connection->decoder.commit(result);
+        decodeFrames(connection, QTime::currentTime().msecsSinceStartOfDay(), &frames);
+        if (!finishInput(handle, result, frames, frames, startNs)) {
+            return;
+        }
+
+        connection = m_connections.find(handle);
+        if (!connection->outbound.readsPaused()) {
+            submitRecv(handle);
+        }
+    }
+
+    void onSendCompleted(SlotHandle handle, int result) {
+        NativeConnection *connection = m_connections.find(handle);
+        if (connection->closing) {
+            connection->outbound.clear();   // 内核已不再引用队首块
+            return;
+        }
+        if (result < 0) {
+            recordSocketError(-result);
+            connection->outbound.clear();
+            updateQueueGauge(connection);
+            closeConnection(handle);
+            return;
+        }
+
+        m_metrics.bytesOut->increment(static_cast<quint64>(result));
+        const BackpressureAction action = connection->outbound.consume(result);
+        if (applyBackpressure(handle, action)) {
+            submitSend(handle);
+        }
+    }
+
+    io_uring m_ring{};
+    bool m_ringReady = false;
+    quint64 m_wakeValue = 0;
+#endif // NETDEBUG_HAVE_IO_URING
+
+    const int m_index;
+    const NativeBackend m_backend;
+    const FramingMode m_framingMode;
+    const OutboundQueueConfig m_outboundConfig;
+    const IdleTimeoutConfig m_idleConfig;
+    const NativeHandlers m_handlers;
+
+    ReactorMetrics m_metrics;
+    SlotMap<NativeConnection> m_connections;
+    QElapsedTimer m_clock;
+    IdleWheel m_idleWheel;
+    std::vector<SlotHandle> m_expiredTimers;
+    std::vector<SlotHandle> m_resumed;
+
+    int m_epollFd = -1;
+    int m_wakeFd = -1;
+    std::atomic<bool> m_stopping{false};
+    std::thread m_thread;
+
+    std::mutex m_pendingMutex;
+    std::vector<PendingDescriptor> m_pending;
+};
+
+#endif // Q_OS_LINUX
+
+#endif // NATIVE_REACTOR_H
@@ -0,0 +1,207 @@
+/**
+ * @file outbound_queue.h
+ * @brief 每连接发送队列：高低水位背压 + 小写合并
+ *
+ * QTcpSocket::write()从不拒绝数据，慢客户端会让套接字内部缓冲区无限增长。
+ * OutboundQueue只在套接字待发送字节低于socketBudget时才把数据交给套接字，
+ * 其余数据留在自身队列中并受高水位约束；由bytesWritten信号驱动继续发送。
+ *
+ * 小消息在入队时直接追加到队尾块中（不超过coalesceLimit），
+ * 一次flush只需少量write()调用，效果等同于writev聚合写。
+ *
+ * 不经过QAbstractSocket的原生后端（epoll/io_uring）使用peekFront()/consume()：
+ * 取出队首未发送部分直接交给内核，按实际写入字节确认。被peek过的队首块在完全发送前
+ * 不会被合并写入或丢弃，异步发送期间其内存保持有效。
+ */
+
+#ifndef OUTBOUND_QUEUE_H
+#define OUTBOUND_QUEUE_H
+
+#include <QAbstractSocket>
+#include <QByteArray>
+#include <QtGlobal>
+#include <cstddef>
+#include <deque>
+
+// 客户端跟不上时的处理策略
+enum class SlowConsumerPolicy {
+    DropOldest,     // 丢弃最早排队的消息（适合只关心最新状态的遥测）
+    PauseReads,     // 暂停读取该客户端；套接字读缓冲区须有上限，TCP流控才能把压力传回对端
+    Disconnect      // 直接断开
+};
+
+struct OutboundQueueConfig {
+    qint64 highWaterMark = 256 * 1024;
+    qint64 lowWaterMark = 64 * 1024;
+    qint64 socketBudget = 64 * 1024;    // 交给QTcpSocket的最大未发送字节数
+    qint32 coalesceLimit = 16 * 1024;   // 小于此值的消息合并进同一块
+    SlowConsumerPolicy policy = SlowConsumerPolicy::PauseReads;
+};
+
+// 调用方需要执行的动作
+enum class BackpressureAction {
+    None,
+    PauseReads,
+    ResumeReads,
+    Disconnect
+};
+
+class OutboundQueue {
+public:
+    explicit OutboundQueue(const OutboundQueueConfig &config = OutboundQueueConfig())
+        : m_config(config) {}
+
+    BackpressureAction enqueue(const QByteArray &message) {
+        return enqueue(message.constData(), message.size());
+    }
+
+    BackpressureAction enqueue(const char *data, qint64 size) {
+        if (size <= 0) {
+            return BackpressureAction::None;
+        }
+
+        // 正在发送的队首块不能再追加，否则QByteArray重新分配会让内核持有的指针失效
+        const bool tailBusy = m_frontBusy && m_chunks.size() == 1;
+        if (!m_chunks.empty() && !tailBusy && size < m_config.coalesceLimit
+            && m_chunks.back().size() + size <= m_config.coalesceLimit) {
+            m_chunks.back().append(data, static_cast<int>(size));
+            ++m_chunkMessages.back();
+        } else {
+            QByteArray chunk;
+            chunk.reserve(static_cast<int>(qMax<qint64>(size, qMin<qint64>(m_config.coalesceLimit, 4096))));
+            chunk.append(data, static_cast<int>(size));
+            m_chunks.push_back(std::move(chunk));
+            m_chunkMessages.push_back(1);
+        }
+        m_queuedBytes += size;
+        m_peakQueuedBytes = qMax(m_peakQueuedBytes, m_queuedBytes);
+
+        return applyHighWater();
+    }
+
+    // 在enqueue之后和每次bytesWritten时调用
+    BackpressureAction flush(QAbstractSocket *socket) {
+        while (!m_chunks.empty() && socket->bytesToWrite() < m_config.socketBudget) {
+            const QByteArray &chunk = m_chunks.front();
+            const qint64 written = socket->write(chunk);
+            if (written < 0) {
+                return BackpressureAction::Disconnect;
+            }
+            m_queuedBytes -= chunk.size();
+            m_flushedBytes += chunk.size();
+            ++m_writeCalls;
+            m_chunks.pop_front();
+            m_chunkMessages.pop_front();
+        }
+
+        if (m_paused && pendingBytes(socket) <= m_config.lowWaterMark) {
+            m_paused = false;
+            return BackpressureAction::ResumeReads;
+        }
+        return BackpressureAction::None;
+    }
+
+    // 队首未发送部分；返回false表示队列为空
+    bool peekFront(const char **data, qint64 *size) {
+        if (m_chunks.empty()) {
+            return false;
+        }
+        const QByteArray &chunk = m_chunks.front();
+        *data = chunk.constData() + m_frontOffset;
+        *size = chunk.size() - m_frontOffset;
+        m_frontBusy = true;
+        return true;
+    }
+
+    // 确认内核已接收队首的bytes字节（可以是部分写入）
+    BackpressureAction consume(qint64 bytes) {
+        m_frontOffset += bytes;
+        m_queuedBytes -= bytes;
+        m_flushedBytes += bytes;
+        ++m_writeCalls;
+        if (!m_chunks.empty() && m_frontOffset >= m_chunks.front().size()) {
+            m_chunks.pop_front();
+            m_chunkMessages.pop_front();
+            m_frontOffset = 0;
+            m_frontBusy = false;
+        }
+
+        if (m_paused && m_queuedBytes <= m_config.lowWaterMark) {
+            m_paused = false;
+            return BackpressureAction::ResumeReads;
+        }
+        return BackpressureAction::None;
+    }
+
+    // 异步发送进行中时调用者必须等待完成后再clear()
+    void clear() {
+        m_chunks.clear();
+        m_chunkMessages.clear();
+        m_queuedBytes = 0;
+        m_frontOffset = 0;
+        m_frontBusy = false;
+        m_paused = false;
+    }
+
+    const OutboundQueueConfig &config() const { return m_config; }
+    bool readsPaused() const { return m_paused; }
+    qint64 queuedBytes() const { return m_queuedBytes; }
+    qint64 peakQueuedBytes() const { return m_peakQueuedBytes; }
+    qint64 flushedBytes() const { return m_flushedBytes; }
+    quint64 writeCalls() const { return m_writeCalls; }
+    quint64 droppedMessages() const { return m_droppedMessages; }
+    qint64 droppedBytes() const { return m_droppedBytes; }
+
+private:
+    qint64 pendingBytes(QAbstractSocket *socket) const { return m_queuedBytes + socket->bytesToWrite(); }
+
+    BackpressureAction applyHighWater() {
+        if (m_queuedBytes <= m_config.highWaterMark) {
+            return BackpressureAction::None;
+        }
+
+        switch (m_config.policy) {
+        case SlowConsumerPolicy::DropOldest:
+        {
+            // 保留最新的一块，即使它本身超过高水位；正在发送的队首块不能丢弃，否则流会被截断
+            const size_t victim = m_frontBusy ? 1 : 0;
+            while (m_queuedBytes > m_config.highWaterMark && m_chunks.size() > victim + 1) {
+                m_queuedBytes -= m_chunks[victim].size();
+                m_droppedBytes += m_chunks[victim].size();
+                m_droppedMessages += m_chunkMessages[victim];
+                m_chunks.erase(m_chunks.begin() + static_cast<std::ptrdiff_t>(victim));
+                m_chunkMessages.erase(m_chunkMessages.begin() + static_cast<std::ptrdiff_t>(victim));
+            }
+            return BackpressureAction::None;
+        }
+        case SlowConsumerPolicy::PauseReads:
+            // 暂停后仍有其他生产者继续写入时，超过两倍高水位则断开，保证内存有界
+            if (m_queuedBytes > 2 * m_config.highWaterMark) {
+                return BackpressureAction::Disconnect;
+            }
+            if (!m_paused) {
+                m_paused = true;
+                return BackpressureAction::PauseReads;
+            }
+            return BackpressureAction::None;
+        case SlowConsumerPolicy::Disconnect:
+            return BackpressureAction::Disconnect;
+        }
+        return BackpressureAction::None;
+    }
+
+    OutboundQueueConfig m_config;
+    std::deque<QByteArray> m_chunks;
+    std::deque<quint32> m_chunkMessages;    // 每块合并了多少条消息，用于丢弃统计
+    qint64 m_queuedBytes = 0;
+    qint64 m_peakQueuedBytes = 0;
+    qint64 m_flushedBytes = 0;
+    quint64 m_writeCalls = 0;
+    quint64 m_droppedMessages = 0;
+    qint64 m_droppedBytes = 0;
+    qint64 m_frontOffset = 0;       // 队首块已发送的字节数（仅原生后端会部分发送）
+    bool m_frontBusy = false;       // 队首块已交给内核
+    bool m_paused = false;
+};
+
+#endif // OUTBOUND_QUEUE_H
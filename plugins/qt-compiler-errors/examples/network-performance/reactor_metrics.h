@@ -0,0 +1,78 @@
+/**
+ * @file reactor_metrics.h
+ * @brief 单个I/O线程（Reactor）的指标序列
+ *
+ * Qt后端和原生epoll/io_uring后端注册同名序列，只是reactor标签不同，
+ * 抓取端可以直接按标签对比两条数据路径。
+ */
+
+#ifndef REACTOR_METRICS_H
+#define REACTOR_METRICS_H
+
+#include <QByteArray>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "metrics.h"
+
+struct ReactorMetrics {
+    explicit ReactorMetrics(const QByteArray &reactorLabel)
+        : labels(metricLabel("reactor", reactorLabel)) {
+        MetricsRegistry &metrics = MetricsRegistry::instance();
+        connections = metrics.gauge("netdebug_connections", "Open client connections", labels);
+        nearTimeout = metrics.gauge("netdebug_near_timeout_connections",
+                                    "Connections with an unanswered heartbeat", labels);
+        queuedBytes = metrics.gauge("netdebug_outbound_queued_bytes", "Bytes waiting in outbound queues", labels);
+        accepted = metrics.counter("netdebug_accepted_total", "Accepted connections", labels);
+        acceptFailures = metrics.counter("netdebug_accept_failures_total",
+                                         "Descriptors that could not be adopted", labels);
+        bytesIn = metrics.counter("netdebug_received_bytes_total", "Bytes read from clients", labels);
+        bytesOut = metrics.counter("netdebug_sent_bytes_total", "Bytes written to clients", labels);
+        framesIn = metrics.counter("netdebug_received_frames_total", "Decoded request frames", labels);
+        framesOut = metrics.counter("netdebug_sent_frames_total", "Response frames queued", labels);
+        heartbeats = metrics.counter("netdebug_heartbeats_total", "Heartbeats sent", labels);
+        idleDisconnects = metrics.counter("netdebug_idle_disconnects_total",
+                                          "Connections closed by idle timeout", labels);
+        slowConsumerDisconnects = metrics.counter("netdebug_slow_consumer_disconnects_total",
+                                                  "Connections closed by outbound backpressure", labels);
+        // 1us ~ 1s，按2倍递增
+        readLatency = metrics.histogram("netdebug_read_event_duration_seconds",
+                                        "Time to decode a read event and queue its responses", labels,
+                                        Histogram::exponentialBounds(1000, 21), 1e-9);
+    }
+
+    // 错误是冷路径：按种类首次出现时才注册序列；kind必须是字符串字面量
+    Counter *socketError(const char *kind) {
+        for (const auto &entry : m_socketErrors) {
+            if (entry.first == kind || std::strcmp(entry.first, kind) == 0) {
+                return entry.second;
+            }
+        }
+        Counter *counter = MetricsRegistry::instance().counter(
+            "netdebug_socket_errors_total", "Socket errors by QAbstractSocket::SocketError kind",
+            labels + ',' + metricLabel("kind", QByteArray(kind)));
+        m_socketErrors.emplace_back(kind, counter);
+        return counter;
+    }
+
+    QByteArray labels;
+    Gauge *connections;
+    Gauge *nearTimeout;
+    Gauge *queuedBytes;
+    Counter *accepted;
+    Counter *acceptFailures;
+    Counter *bytesIn;
+    Counter *bytesOut;
+    Counter *framesIn;
+    Counter *framesOut;
+    Counter *heartbeats;
+    Counter *idleDisconnects;
+    Counter *slowConsumerDisconnects;
+    Histogram *readLatency;
+
+private:
+    std::vector<std::pair<const char*, Counter*>> m_socketErrors;
+};
+
+#endif // REACTOR_METRICS_H
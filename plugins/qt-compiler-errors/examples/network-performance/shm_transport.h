@@ -0,0 +1,825 @@
+/**
+ * @file shm_transport.h
+ * @brief 同机跨进程共享内存环形传输（Linux）
+ *
+ * 采集进程（ServiceFacade所在进程）作为ShmPublisher，界面进程作为ShmSubscriber，
+ * 不再经过示例服务器的TCP往返：
+ *   - 每个订阅者一个单生产者/单消费者环，存放在memfd中；大小在创建后封印，
+ *     消费端映射后生产端无法截断文件让消费端SIGBUS；
+ *   - 唤醒走eventfd，按批而不是按条（与Channel<T>相同的wakePending协议），
+ *     消费端用QSocketNotifier在自己的事件循环中排空；
+ *   - memfd和eventfd通过抽象命名空间的Unix套接字（SCM_RIGHTS）交给订阅者，
+ *     该套接字同时用来感知对端退出；
+ *   - 每个槽位带序号：负载写完后才以release发布"序号+1"，消费端只接受与自己位置
+ *     相符的序号。生产端在写槽位中途崩溃时，半写的记录永远不会被交付，
+ *     已发布的记录在生产端退出后仍可排空。
+ * 记录是wire_codec.h的定长消息（首字节为消息类型），订阅端按类型注册处理函数，
+ * 得到与statusReplyReady/selfcheckReplyReady相同的值语义。
+ *
+ * 环满时的处理按消息类型选择（ShmOverflow，与ChannelOverflow相同）：Drop丢弃新记录并计入dropped，
+ * 消费端可以读到丢弃次数；Spill把记录留在发布端该订阅者的积压队列中，之后每次发布和重试定时器
+ * 按原顺序补写（积压只在发布进程内，订阅者断开时随之丢弃）。积压队列有上限，订阅者长时间停住时
+ * 丢弃最老的积压记录并计入dropped和spillDropped，发布进程的内存不会无限增长。
+ * ShmPublisher和ShmSubscriber都只能在创建它们的线程中使用；ShmSubscriber::connectTo()不阻塞，
+ * 握手在该线程的事件循环中完成，可以在界面线程或Reactor线程中调用。
+ */
+
+#ifndef SHM_TRANSPORT_H
+#define SHM_TRANSPORT_H
+
+#include <QtGlobal>
+
+#ifdef Q_OS_LINUX
+#define NETDEBUG_HAVE_SHM_TRANSPORT 1
+
+#include <QByteArray>
+#include <QDebug>
+#include <QObject>
+#include <QSocketNotifier>
+#include <QString>
+#include <QTimer>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "wire_codec.h"
+
+static const quint32 kShmRingMagic = 0x4e444c4b;       // "NDLK"
+static const quint32 kShmRingVersion = 1;
+static const int kShmSlotPayload = 52;
+
+static_assert(std::atomic<quint64>::is_always_lock_free && std::atomic<quint32>::is_always_lock_free,
+              "atomics shared between processes must be lock-free");
+
+// 位于memfd开头；各方写入的字段各占一个缓存行
+struct ShmRingHeader {
+    quint32 magic = kShmRingMagic;
+    quint32 version = kShmRingVersion;
+    quint32 slotCount = 0;
+    quint32 slotSize = 0;
+
+    alignas(64) std::atomic<quint64> tail{0};       // 生产端写：已发布的记录数
+    std::atomic<quint64> dropped{0};                // 生产端写：环满被丢弃的记录数
+
+    alignas(64) std::atomic<quint64> head{0};       // 消费端写：已取走的记录数
+
+    alignas(64) std::atomic<quint32> wakePending{0};
+};
+
+struct ShmRingSlot {
+    std::atomic<quint64> sequence{0};   // 记录序号+1，负载写完后发布；0表示从未写入
+    quint16 size = 0;
+    quint16 reserved = 0;
+    char payload[kShmSlotPayload];
+};
+
+static_assert(sizeof(ShmRingSlot) == 64, "one slot per cache line");
+
+struct ShmTransportStats {
+    quint64 published = 0;      // 生产端：写入成功的记录（每个订阅者各计一次）
+    quint64 dropped = 0;        // 环满被丢弃的记录（ShmOverflow::Drop）
+    quint64 spilled = 0;        // 生产端：环满转入积压队列的记录（ShmOverflow::Spill）
+    quint64 spillDropped = 0;   // 生产端：积压队列达到上限被丢弃的最老记录（也计入dropped）
+    quint64 wakeups = 0;        // 写eventfd（生产端）或被唤醒（消费端）的次数
+    quint64 delivered = 0;      // 消费端：交给处理函数的记录
+    quint64 invalid = 0;        // 消费端：类型未注册、长度越界或解码失败
+    quint64 maxBatch = 0;       // 消费端：单次唤醒排空的最大记录数
+};
+
+// 环满时的处理方式
+enum class ShmOverflow {
+    Drop,       // 丢弃新记录：只关心最新值的状态
+    Spill       // 留在发布端积压队列，按顺序补写：每条都必须送达的结果
+};
+
+inline QString shmErrnoString(const char *call) {
+    return QStringLiteral("%1: %2").arg(QLatin1String(call), QString::fromLocal8Bit(std::strerror(errno)));
+}
+
+/**
+ * @brief memfd中的单生产者/单消费者环：生产端create()，消费端attach()
+ */
+class ShmRing {
+public:
+    ~ShmRing() {
+        if (m_memory != MAP_FAILED) {
+            ::munmap(m_memory, m_length);
+        }
+        if (m_fd >= 0) {
+            ::close(m_fd);
+        }
+    }
+
+    ShmRing(const ShmRing &) = delete;
+    ShmRing &operator=(const ShmRing &) = delete;
+
+    static size_t slotsOffset() { return (sizeof(ShmRingHeader) + 63) & ~size_t(63); }
+
+    // slotCount向上取整为2的幂
+    static std::unique_ptr<ShmRing> create(quint32 slotCount, QString *error) {
+        quint32 rounded = 2;
+        while (rounded < slotCount) {
+            rounded <<= 1;
+        }
+        const size_t length = slotsOffset() + size_t(rounded) * sizeof(ShmRingSlot);
+
+        const int fd = ::memfd_create("netdebug-downlink", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+        if (fd < 0) {
+            *error = shmErrnoString("memfd_create");
+            return nullptr;
+        }
+        std::unique_ptr<ShmRing> ring(new ShmRing(fd));
+        if (::ftruncate(fd, static_cast<off_t>(length)) != 0) {
+            *error = shmErrnoString("ftruncate");
+            return nullptr;
+        }
+        if (::fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) != 0) {
+            *error = shmErrnoString("F_ADD_SEALS");
+            return nullptr;
+        }
+        if (!ring->map(length, error)) {
+            return nullptr;
+        }
+
+        ShmRingHeader *header = new (ring->m_memory) ShmRingHeader();
+        header->slotCount = rounded;
+        header->slotSize = sizeof(ShmRingSlot);
+        ShmRingSlot *slots = reinterpret_cast<ShmRingSlot *>(static_cast<char *>(ring->m_memory) + slotsOffset());
+        for (quint32 i = 0; i < rounded; ++i) {
+            new (&slots[i]) ShmRingSlot();
+        }
+        ring->bind(rounded);
+        return ring;
+    }
+
+    // 接管fd；只信任本进程校验过的大小和槽位数，生产端之后改写头部也不会越界
+    static std::unique_ptr<ShmRing> attach(int fd, QString *error) {
+        std::unique_ptr<ShmRing> ring(new ShmRing(fd));
+        const int seals = ::fcntl(fd, F_GET_SEALS);
+        if (seals < 0 || (seals & F_SEAL_SHRINK) == 0) {
+            *error = QStringLiteral("ring memfd is not sealed against shrinking");
+            return nullptr;
+        }
+        struct stat status;
+        if (::fstat(fd, &status) != 0) {
+            *error = shmErrnoString("fstat");
+            return nullptr;
+        }
+        const size_t length = static_cast<size_t>(status.st_size);
+        if (length < slotsOffset()) {
+            *error = QStringLiteral("ring memfd too small");
+            return nullptr;
+        }
+        if (!ring->map(length, error)) {
+            return nullptr;
+        }
+
+        const ShmRingHeader *header = static_cast<const ShmRingHeader *>(ring->m_memory);
+        const quint32 slotCount = header->slotCount;
+        if (header->magic != kShmRingMagic || header->version != kShmRingVersion
+            || header->slotSize != sizeof(ShmRingSlot) || slotCount < 2 || (slotCount & (slotCount - 1)) != 0
+            || slotsOffset() + size_t(slotCount) * sizeof(ShmRingSlot) > length) {
+            *error = QStringLiteral("ring header mismatch (magic/version/size)");
+            return nullptr;
+        }
+        ring->bind(slotCount);
+        return ring;
+    }
+
+    int fd() const { return m_fd; }
+    quint32 slotCount() const { return static_cast<quint32>(m_mask + 1); }
+    ShmRingHeader *header() const { return m_header; }
+
+    // ===== 生产端 =====
+
+    // 环满时返回false；countDrop为false时调用方自行保留记录，不计入环头部的dropped
+    bool tryWrite(const char *data, int size, bool countDrop = true) {
+        const quint64 tail = m_tail;
+        if (tail - m_cachedHead > m_mask) {
+            m_cachedHead = m_header->head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead > m_mask) {
+                if (countDrop) {
+                    recordDrop();
+                }
+                return false;
+            }
+        }
+        ShmRingSlot &slot = m_slots[tail & m_mask];
+        std::memcpy(slot.payload, data, static_cast<size_t>(size));
+        slot.size = static_cast<quint16>(size);
+        slot.sequence.store(tail + 1, std::memory_order_release);
+        m_tail = tail + 1;
+        m_header->tail.store(m_tail, std::memory_order_release);
+        return true;
+    }
+
+    // 计入环头部的dropped，消费端的stats()可见
+    void recordDrop() {
+        m_header->dropped.store(m_header->dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    // 与clearWake()中的栅栏配对：要么消费端看到新记录，要么这里看到需要唤醒
+    bool needsWake() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return !m_header->wakePending.load(std::memory_order_relaxed)
+            && !m_header->wakePending.exchange(1);
+    }
+
+    // ===== 消费端 =====
+
+    // 先清除标志再排空：排空期间发布的记录会触发下一次唤醒
+    void clearWake() {
+        m_header->wakePending.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    // f(data, size)；size已校验不超过槽位负载；返回取出的记录数
+    template <typename F>
+    size_t drain(F &&f) {
+        quint64 head = m_head;
+        size_t count = 0;
+        for (;;) {
+            const ShmRingSlot &slot = m_slots[head & m_mask];
+            // 序号不符：尚未发布，或生产端在写这个槽位时退出
+            if (slot.sequence.load(std::memory_order_acquire) != head + 1) {
+                break;
+            }
+            f(slot.payload, qMin<int>(slot.size, kShmSlotPayload));
+            ++head;
+            ++count;
+            if ((count & 63) == 0) {
+                m_header->head.store(head, std::memory_order_release);
+            }
+        }
+        m_head = head;
+        m_header->head.store(head, std::memory_order_release);
+        return count;
+    }
+
+private:
+    explicit ShmRing(int fd) : m_fd(fd) {}
+
+    bool map(size_t length, QString *error) {
+        m_memory = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+        if (m_memory == MAP_FAILED) {
+            *error = shmErrnoString("mmap");
+            return false;
+        }
+        m_length = length;
+        return true;
+    }
+
+    void bind(quint32 slotCount) {
+        m_header = static_cast<ShmRingHeader *>(m_memory);
+        m_slots = reinterpret_cast<ShmRingSlot *>(static_cast<char *>(m_memory) + slotsOffset());
+        m_mask = slotCount - 1;
+        // 只有一方会使用这些本地位置，另一方的值对它无意义
+        m_tail = m_header->tail.load(std::memory_order_relaxed);
+        m_head = m_header->head.load(std::memory_order_relaxed);
+        m_cachedHead = m_head;
+    }
+
+    int m_fd;
+    void *m_memory = MAP_FAILED;
+    size_t m_length = 0;
+    ShmRingHeader *m_header = nullptr;
+    ShmRingSlot *m_slots = nullptr;
+    quint64 m_mask = 0;
+    quint64 m_tail = 0;         // 生产端
+    quint64 m_cachedHead = 0;   // 生产端缓存的消费位置
+    quint64 m_head = 0;         // 消费端
+};
+
+// ===== 控制套接字：抽象命名空间，名称不对应文件 =====
+
+struct ShmHello {
+    quint32 magic;
+    quint32 version;
+    quint32 slotCount;
+};
+
+inline socklen_t shmSocketAddress(const QString &name, sockaddr_un *address) {
+    std::memset(address, 0, sizeof(*address));
+    address->sun_family = AF_UNIX;
+    const QByteArray bytes = name.toUtf8().left(static_cast<int>(sizeof(address->sun_path)) - 1);
+    std::memcpy(address->sun_path + 1, bytes.constData(), static_cast<size_t>(bytes.size()));
+    return static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + 1 + bytes.size());
+}
+
+inline bool shmSendHello(int socket, const ShmHello &hello, int ringFd, int eventFd) {
+    iovec data = {const_cast<ShmHello *>(&hello), sizeof(hello)};
+    alignas(cmsghdr) char control[CMSG_SPACE(2 * sizeof(int))] = {};
+    msghdr message = {};
+    message.msg_iov = &data;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    cmsghdr *header = CMSG_FIRSTHDR(&message);
+    header->cmsg_level = SOL_SOCKET;
+    header->cmsg_type = SCM_RIGHTS;
+    header->cmsg_len = CMSG_LEN(2 * sizeof(int));
+    const int fds[2] = {ringFd, eventFd};
+    std::memcpy(CMSG_DATA(header), fds, sizeof(fds));
+    return ::sendmsg(socket, &message, MSG_NOSIGNAL) == static_cast<ssize_t>(sizeof(hello));
+}
+
+// 成功时fds[0]为环memfd，fds[1]为eventfd，所有权交给调用方
+inline bool shmReceiveHello(int socket, ShmHello *hello, int fds[2]) {
+    iovec data = {hello, sizeof(*hello)};
+    alignas(cmsghdr) char control[CMSG_SPACE(2 * sizeof(int))] = {};
+    msghdr message = {};
+    message.msg_iov = &data;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    const ssize_t received = ::recvmsg(socket, &message, MSG_CMSG_CLOEXEC);
+
+    int receivedFds[2] = {-1, -1};
+    int count = 0;
+    for (cmsghdr *header = CMSG_FIRSTHDR(&message); header; header = CMSG_NXTHDR(&message, header)) {
+        if (header->cmsg_level == SOL_SOCKET && header->cmsg_type == SCM_RIGHTS) {
+            count = static_cast<int>((header->cmsg_len - CMSG_LEN(0)) / sizeof(int));
+            std::memcpy(receivedFds, CMSG_DATA(header), sizeof(int) * static_cast<size_t>(qMin(count, 2)));
+        }
+    }
+    if (received != static_cast<ssize_t>(sizeof(*hello)) || count != 2 || (message.msg_flags & MSG_CTRUNC)) {
+        for (int fd : receivedFds) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+        return false;
+    }
+    fds[0] = receivedFds[0];
+    fds[1] = receivedFds[1];
+    return true;
+}
+
+// deferred：在该通知器自己的activated处理中释放时必须延迟删除
+inline void shmReleaseNotifier(QSocketNotifier *&notifier, bool deferred) {
+    if (notifier) {
+        notifier->setEnabled(false);
+        if (deferred) {
+            notifier->deleteLater();
+        } else {
+            delete notifier;
+        }
+        notifier = nullptr;
+    }
+}
+
+/**
+ * @brief 生产端：接受订阅者，为每个订阅者创建环，发布记录
+ */
+class ShmPublisher {
+public:
+    // maxBacklog：每个订阅者最多积压的Spill记录数
+    explicit ShmPublisher(quint32 slotCount = 4096, size_t maxBacklog = 65536)
+        : m_slotCount(slotCount)
+        , m_maxBacklog(qMax<size_t>(1, maxBacklog)) {
+        m_retryTimer.setSingleShot(true);
+        QObject::connect(&m_retryTimer, &QTimer::timeout, [this]() { flushBacklogs(); });
+    }
+
+    ~ShmPublisher() {
+        for (const std::unique_ptr<Subscriber> &subscriber : m_subscribers) {
+            closeSubscriber(*subscriber, false);
+        }
+        delete m_listenNotifier;
+        if (m_listenFd >= 0) {
+            ::close(m_listenFd);
+        }
+    }
+
+    ShmPublisher(const ShmPublisher &) = delete;
+    ShmPublisher &operator=(const ShmPublisher &) = delete;
+
+    bool listen(const QString &name, QString *error) {
+        m_listenFd = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (m_listenFd < 0) {
+            *error = shmErrnoString("socket");
+            return false;
+        }
+        sockaddr_un address;
+        const socklen_t length = shmSocketAddress(name, &address);
+        if (::bind(m_listenFd, reinterpret_cast<sockaddr *>(&address), length) != 0
+            || ::listen(m_listenFd, 16) != 0) {
+            *error = shmErrnoString("bind/listen");
+            ::close(m_listenFd);
+            m_listenFd = -1;
+            return false;
+        }
+        m_listenNotifier = new QSocketNotifier(m_listenFd, QSocketNotifier::Read);
+        QObject::connect(m_listenNotifier, &QSocketNotifier::activated, m_listenNotifier,
+                         [this]() { acceptPending(); });
+        return true;
+    }
+
+    int subscriberCount() const { return static_cast<int>(m_subscribers.size()); }
+
+    // 编码一次，写入每个订阅者的环；返回已写入环的订阅者数（Spill时其余订阅者的记录在积压队列中）
+    template <typename Layout>
+    int publish(const typename Layout::Type &value, ShmOverflow overflow = ShmOverflow::Drop) {
+        static_assert(Layout::kSize <= static_cast<size_t>(kShmSlotPayload), "message does not fit in a ring slot");
+        char payload[Layout::kSize];
+        Layout::encode(value, payload);
+        return publishRaw(payload, static_cast<int>(Layout::kSize), overflow);
+    }
+
+    int publishRaw(const char *data, int size, ShmOverflow overflow = ShmOverflow::Drop) {
+        Q_ASSERT(size > 0 && size <= kShmSlotPayload);
+        int written = 0;
+        for (const std::unique_ptr<Subscriber> &subscriber : m_subscribers) {
+            Subscriber &target = *subscriber;
+            bool wrote = false;
+            // 先补写积压记录；Spill记录之间保持顺序，积压补写完之前新记录只能排在后面
+            const bool caughtUp = flushBacklog(target);
+            if (overflow == ShmOverflow::Spill && !caughtUp) {
+                spill(target, data, size);
+            } else if (target.ring->tryWrite(data, size, overflow == ShmOverflow::Drop)) {
+                wrote = true;
+            } else if (overflow == ShmOverflow::Spill) {
+                spill(target, data, size);
+            } else {
+                ++m_stats.dropped;
+            }
+            if (wrote) {
+                ++written;
+                ++m_stats.published;
+                wake(target);
+            }
+        }
+        return written;
+    }
+
+    // 所有订阅者的积压记录数
+    size_t backlog() const {
+        size_t total = 0;
+        for (const std::unique_ptr<Subscriber> &subscriber : m_subscribers) {
+            total += subscriber->backlog.size();
+        }
+        return total;
+    }
+
+    const ShmTransportStats &stats() const { return m_stats; }
+
+private:
+    struct Subscriber {
+        int socketFd = -1;
+        int eventFd = -1;
+        std::unique_ptr<ShmRing> ring;
+        QSocketNotifier *notifier = nullptr;
+        std::deque<QByteArray> backlog;     // ShmOverflow::Spill：环满时未写入的记录，按发布顺序
+    };
+
+    // 消费端每次排空最多间隔一个事件循环周期，积压时以此间隔重试
+    static const int kBacklogRetryMs = 1;
+
+    void wake(Subscriber &subscriber) {
+        if (subscriber.ring->needsWake()) {
+            ++m_stats.wakeups;
+            const quint64 one = 1;
+            const ssize_t bytes = ::write(subscriber.eventFd, &one, sizeof(one));
+            Q_UNUSED(bytes);
+        }
+    }
+
+    void spill(Subscriber &subscriber, const char *data, int size) {
+        // ❌ 原来：积压队列没有上限，订阅者停住不读时发布进程的内存无限增长
+        // ✅ 现在：达到上限后丢弃最老的积压记录，与Drop一样计入环头部，消费端知道有记录丢失
+        if (subscriber.backlog.size() >= m_maxBacklog) {
+            subscriber.backlog.pop_front();
+            subscriber.ring->recordDrop();
+            ++m_stats.dropped;
+            ++m_stats.spillDropped;
+        }
+        subscriber.backlog.emplace_back(data, size);
+        ++m_stats.spilled;
+        if (!m_retryTimer.isActive()) {
+            m_retryTimer.start(kBacklogRetryMs);
+        }
+    }
+
+    // 按顺序补写积压记录；全部写入时返回true
+    bool flushBacklog(Subscriber &subscriber) {
+        bool wrote = false;
+        while (!subscriber.backlog.empty()) {
+            const QByteArray &record = subscriber.backlog.front();
+            if (!subscriber.ring->tryWrite(record.constData(), record.size(), false)) {
+                break;
+            }
+            subscriber.backlog.pop_front();
+            ++m_stats.published;
+            wrote = true;
+        }
+        if (wrote) {
+            wake(subscriber);
+        }
+        return subscriber.backlog.empty();
+    }
+
+    void flushBacklogs() {
+        bool pending = false;
+        for (const std::unique_ptr<Subscriber> &subscriber : m_subscribers) {
+            pending = !flushBacklog(*subscriber) || pending;
+        }
+        if (pending) {
+            m_retryTimer.start(kBacklogRetryMs);
+        }
+    }
+
+    void acceptPending() {
+        for (;;) {
+            const int socketFd = ::accept4(m_listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (socketFd < 0) {
+                if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                    qWarning() << "[WARNING] Shared-memory accept failed:" << shmErrnoString("accept4");
+                }
+                return;
+            }
+
+            std::unique_ptr<Subscriber> subscriber(new Subscriber());
+            subscriber->socketFd = socketFd;
+            QString error;
+            subscriber->ring = ShmRing::create(m_slotCount, &error);
+            subscriber->eventFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            const ShmHello hello = {kShmRingMagic, kShmRingVersion,
+                                    subscriber->ring ? subscriber->ring->slotCount() : 0};
+            if (!subscriber->ring || subscriber->eventFd < 0
+                || !shmSendHello(socketFd, hello, subscriber->ring->fd(), subscriber->eventFd)) {
+                qWarning() << "[WARNING] Shared-memory subscriber setup failed:"
+                           << (error.isEmpty() ? shmErrnoString("eventfd/sendmsg") : error);
+                closeSubscriber(*subscriber, false);
+                continue;
+            }
+
+            // 订阅者不再发送数据：可读即对端关闭（或违规发送，同样断开）
+            Subscriber *raw = subscriber.get();
+            subscriber->notifier = new QSocketNotifier(socketFd, QSocketNotifier::Read);
+            QObject::connect(subscriber->notifier, &QSocketNotifier::activated, subscriber->notifier,
+                             [this, raw]() { onSubscriberReadable(raw); });
+            m_subscribers.push_back(std::move(subscriber));
+            qDebug() << "[DEBUG] Shared-memory subscriber attached, ring slots:" << hello.slotCount
+                     << "subscribers:" << m_subscribers.size();
+        }
+    }
+
+    void onSubscriberReadable(Subscriber *subscriber) {
+        for (size_t i = 0; i < m_subscribers.size(); ++i) {
+            if (m_subscribers[i].get() == subscriber) {
+                qDebug() << "[DEBUG] Shared-memory subscriber detached";
+                dropSubscriber(i);
+                return;
+            }
+        }
+    }
+
+    void dropSubscriber(size_t index) {
+        closeSubscriber(*m_subscribers[index], true);
+        m_subscribers[index] = std::move(m_subscribers.back());
+        m_subscribers.pop_back();
+    }
+
+    static void closeSubscriber(Subscriber &subscriber, bool deferred) {
+        shmReleaseNotifier(subscriber.notifier, deferred);
+        subscriber.ring.reset();
+        if (subscriber.eventFd >= 0) {
+            ::close(subscriber.eventFd);
+            subscriber.eventFd = -1;
+        }
+        if (subscriber.socketFd >= 0) {
+            ::close(subscriber.socketFd);
+            subscriber.socketFd = -1;
+        }
+    }
+
+    const quint32 m_slotCount;
+    const size_t m_maxBacklog;
+    int m_listenFd = -1;
+    QSocketNotifier *m_listenNotifier = nullptr;
+    std::vector<std::unique_ptr<Subscriber>> m_subscribers;
+    QTimer m_retryTimer;            // 有积压记录时补写
+    ShmTransportStats m_stats;
+};
+
+/**
+ * @brief 消费端：连接生产端，在本线程事件循环中按消息类型分发
+ */
+class ShmSubscriber {
+public:
+    ShmSubscriber() {
+        m_handshakeTimer.setSingleShot(true);
+        QObject::connect(&m_handshakeTimer, &QTimer::timeout, [this]() {
+            failConnect(QStringLiteral("no handshake from publisher"));
+        });
+    }
+    ~ShmSubscriber() { teardown(false); }
+
+    ShmSubscriber(const ShmSubscriber &) = delete;
+    ShmSubscriber &operator=(const ShmSubscriber &) = delete;
+
+    // 注册某种消息的处理函数，handler在本线程中按发布顺序调用
+    template <typename Layout>
+    void on(std::function<void(const typename Layout::Type &)> handler) {
+        static_assert(Layout::kSize <= static_cast<size_t>(kShmSlotPayload), "message does not fit in a ring slot");
+        m_handlers[Layout::kType] = [this, handler](const char *data, int size) {
+            typename Layout::Type value;
+            if (Layout::decode(data, size, &value) != WireDecodeStatus::Ok) {
+                ++m_stats.invalid;
+                return;
+            }
+            ++m_stats.delivered;
+            handler(value);
+        };
+    }
+
+    // 生产端退出或连接断开时调用（已发布的记录先排空）
+    void onDisconnected(std::function<void()> handler) { m_onDisconnected = std::move(handler); }
+
+    // connectTo()返回true之后握手失败或超时时调用
+    void onConnectFailed(std::function<void(const QString &error)> handler) {
+        m_onConnectFailed = std::move(handler);
+    }
+
+    // ❌ 原来：阻塞等待生产端的握手，最多timeoutMs，在界面线程中调用会卡住界面
+    // ✅ 现在：只发起连接就返回，握手在本线程事件循环中完成，之后isConnected()为true；
+    //    timeoutMs内没有完成握手则调用onConnectFailed的处理函数。立即可知的错误返回false
+    bool connectTo(const QString &name, QString *error, int timeoutMs = 1000) {
+        close();
+        m_socketFd = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (m_socketFd < 0) {
+            *error = shmErrnoString("socket");
+            return false;
+        }
+        sockaddr_un address;
+        const socklen_t length = shmSocketAddress(name, &address);
+        // Unix套接字的connect不等待accept：生产端不存在或积压已满时立即失败
+        if (::connect(m_socketFd, reinterpret_cast<sockaddr *>(&address), length) != 0) {
+            *error = shmErrnoString("connect");
+            close();
+            return false;
+        }
+
+        // 握手完成之前套接字可读表示握手消息到达，之后只表示生产端关闭
+        m_socketNotifier = new QSocketNotifier(m_socketFd, QSocketNotifier::Read);
+        QObject::connect(m_socketNotifier, &QSocketNotifier::activated, m_socketNotifier, [this]() {
+            if (m_ring) {
+                onPublisherClosed();
+            } else {
+                finishHandshake();
+            }
+        });
+        m_handshakeTimer.start(timeoutMs);
+        return true;
+    }
+
+    bool isConnected() const { return m_ring != nullptr; }
+
+    void close() { teardown(true); }
+
+    // published/dropped来自生产端写在环头部的计数，断开后保留最后一次的值
+    ShmTransportStats stats() const {
+        ShmTransportStats stats = m_stats;
+        if (m_ring) {
+            readRingCounters(&stats);
+        }
+        return stats;
+    }
+
+private:
+    void readRingCounters(ShmTransportStats *stats) const {
+        stats->published = m_ring->header()->tail.load(std::memory_order_relaxed);
+        stats->dropped = m_ring->header()->dropped.load(std::memory_order_relaxed);
+    }
+
+    void finishHandshake() {
+        ShmHello hello = {};
+        int fds[2] = {-1, -1};
+        errno = 0;
+        if (!shmReceiveHello(m_socketFd, &hello, fds)) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                return;
+            }
+            failConnect(QStringLiteral("no handshake from publisher"));
+            return;
+        }
+        m_handshakeTimer.stop();
+        m_eventFd = fds[1];
+        if (hello.magic != kShmRingMagic || hello.version != kShmRingVersion) {
+            ::close(fds[0]);
+            failConnect(QStringLiteral("publisher protocol version mismatch"));
+            return;
+        }
+        QString error;
+        m_ring = ShmRing::attach(fds[0], &error);
+        if (!m_ring) {
+            failConnect(error);
+            return;
+        }
+
+        m_wakeNotifier = new QSocketNotifier(m_eventFd, QSocketNotifier::Read);
+        QObject::connect(m_wakeNotifier, &QSocketNotifier::activated, m_wakeNotifier, [this]() { onWake(); });
+
+        // 握手之前已发布的记录
+        onWake();
+    }
+
+    void failConnect(const QString &error) {
+        close();
+        if (m_onConnectFailed) {
+            m_onConnectFailed(error);
+        }
+    }
+
+    void teardown(bool deferred) {
+        m_handshakeTimer.stop();
+        shmReleaseNotifier(m_wakeNotifier, deferred);
+        shmReleaseNotifier(m_socketNotifier, deferred);
+        if (m_ring) {
+            readRingCounters(&m_stats);
+        }
+        m_ring.reset();
+        for (int *fd : {&m_eventFd, &m_socketFd}) {
+            if (*fd >= 0) {
+                ::close(*fd);
+                *fd = -1;
+            }
+        }
+    }
+
+    void onWake() {
+        quint64 counter = 0;
+        const ssize_t bytes = ::read(m_eventFd, &counter, sizeof(counter));
+        Q_UNUSED(bytes);
+        ++m_stats.wakeups;
+
+        m_ring->clearWake();
+        const size_t count = m_ring->drain([this](const char *data, int size) {
+            const std::function<void(const char *, int)> &handler = m_handlers[wireMessageType(data, size)];
+            if (handler) {
+                handler(data, size);
+            } else {
+                ++m_stats.invalid;
+            }
+        });
+        m_stats.maxBatch = qMax<quint64>(m_stats.maxBatch, count);
+    }
+
+    void onPublisherClosed() {
+        char byte = 0;
+        const ssize_t received = ::recv(m_socketFd, &byte, sizeof(byte), MSG_DONTWAIT);
+        if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+            return;
+        }
+        // 已完整发布的记录仍然有效
+        onWake();
+        close();
+        if (m_onDisconnected) {
+            m_onDisconnected();
+        }
+    }
+
+    int m_socketFd = -1;
+    int m_eventFd = -1;
+    std::unique_ptr<ShmRing> m_ring;
+    QSocketNotifier *m_wakeNotifier = nullptr;
+    QSocketNotifier *m_socketNotifier = nullptr;
+    std::function<void(const char *, int)> m_handlers[256];
+    std::function<void()> m_onDisconnected;
+    std::function<void(const QString &)> m_onConnectFailed;
+    QTimer m_handshakeTimer;
+    ShmTransportStats m_stats;
+};
+
+/**
+ * @brief 把单参数信号直接发布到共享内存环
+ *
+ * 信号参数可以是Layout::Type或可隐式转换为const Layout::Type&的包装类型（如Traced<T>）。
+ * 每条都必须送达的消息传ShmOverflow::Spill。
+ */
+template <typename Layout, typename Sender, typename SignalArg>
+QMetaObject::Connection connectShmPublisher(Sender *sender, void (Sender::*signal)(SignalArg),
+                                            ShmPublisher *publisher,
+                                            ShmOverflow overflow = ShmOverflow::Drop) {
+    return QObject::connect(sender, signal, sender, [publisher, overflow](SignalArg value) {
+        publisher->publish<Layout>(static_cast<const typename Layout::Type &>(value), overflow);
+    }, Qt::DirectConnection);
+}
+
+#endif // Q_OS_LINUX
+
+#endif // SHM_TRANSPORT_H
@@ -0,0 +1,288 @@
+/**
+ * @file shm_transport_benchmark.cpp
+ * @brief 同机跨进程传输对比：共享内存环（ShmPublisher/ShmSubscriber）与本机回环TCP
+ *
+ * 本程序作为发布端，用QProcess启动自身的另一个实例作为订阅端（两个独立进程）。
+ * 每条消息是WireLayout编码的探针（发送时刻steady_clock纳秒 + 序号），
+ * 订阅端在自己的事件循环中收到后用HDR直方图记录端到端延迟：
+ *   shm  ShmPublisher::publish → eventfd唤醒 → QSocketNotifier → 排空环
+ *   tcp  与示例服务器相同的路径：长度前缀帧 → QTcpSocket(TCP_NODELAY) → readyRead → FrameDecoder
+ * 两个场景：
+ *   burst  尽快发送N条，测量吞吐量（共享内存环满时发布端重试，不丢消息）
+ *   paced  按固定速率发送，测量不饱和时的尾延迟
+ *
+ * 用法: shm_transport_benchmark [消息数=1000000] [paced速率msgs/s=100000]
+ * 仅Linux。
+ */
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QHostAddress>
+#include <QProcess>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QThread>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "frame_decoder.h"
+#include "hdr_histogram.h"
+#include "shm_transport.h"
+#include "wire_codec.h"
+
+#ifdef NETDEBUG_HAVE_SHM_TRANSPORT
+
+struct BenchProbe {
+    qint64 sentNs = 0;
+    qint64 sequence = 0;
+};
+
+using BenchProbeWire = WireLayout<BenchProbe, 0x7f,
+                                  WireField<&BenchProbe::sentNs, qint64>,
+                                  WireField<&BenchProbe::sequence, qint64>>;
+
+static qint64 steadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// ===== 订阅端（子进程）=====
+
+class ProbeReceiver {
+public:
+    explicit ProbeReceiver(qint64 expected) : m_expected(expected) {}
+
+    void onProbe(const BenchProbe &probe) {
+        const qint64 now = steadyNowNs();
+        if (m_received == 0) {
+            m_firstSentNs = probe.sentNs;
+        }
+        m_latencyNs.record(qMax<qint64>(now - probe.sentNs, 1));
+        if (probe.sequence != m_received) {
+            ++m_outOfOrder;
+        }
+        ++m_received;
+        if (m_received == m_expected) {
+            m_lastReceivedNs = now;
+            QCoreApplication::quit();
+        }
+    }
+
+    // 结果写到标准输出，由发布端转印
+    void print(const char *transport, const char *scenario, const ShmTransportStats *stats) const {
+        auto micros = [](qint64 ns) { return ns / 1000.0; };
+        const double seconds = (m_lastReceivedNs - m_firstSentNs) / 1e9;
+        std::printf("%-5s %-6s %12.0f msgs/s  p50 %8.2f us  p99 %8.2f us  p999 %9.2f us  max %10.2f us",
+                    transport, scenario, seconds > 0 ? m_received / seconds : 0.0,
+                    micros(m_latencyNs.valueAtPercentile(50.0)), micros(m_latencyNs.valueAtPercentile(99.0)),
+                    micros(m_latencyNs.valueAtPercentile(99.9)), micros(m_latencyNs.max()));
+        if (stats) {
+            std::printf("  wakeups %llu  max batch %llu", static_cast<unsigned long long>(stats->wakeups),
+                        static_cast<unsigned long long>(stats->maxBatch));
+        }
+        if (m_outOfOrder > 0) {
+            std::printf("  OUT OF ORDER %lld", static_cast<long long>(m_outOfOrder));
+        }
+        std::printf("\n");
+        std::fflush(stdout);
+    }
+
+private:
+    HdrHistogram m_latencyNs;
+    qint64 m_expected;
+    qint64 m_received = 0;
+    qint64 m_outOfOrder = 0;
+    qint64 m_firstSentNs = 0;
+    qint64 m_lastReceivedNs = 0;
+};
+
+static int runSubscriber(QCoreApplication &app, const QString &transport, const QString &endpoint,
+                         const char *scenario, qint64 count) {
+    ProbeReceiver receiver(count);
+
+    if (transport == "shm") {
+        ShmSubscriber subscriber;
+        subscriber.on<BenchProbeWire>([&receiver](const BenchProbe &probe) { receiver.onProbe(probe); });
+        QString error;
+        if (!subscriber.connectTo(endpoint, &error, 5000)) {
+            std::fprintf(stderr, "subscriber: %s\n", qPrintable(error));
+            return 1;
+        }
+        subscriber.onConnectFailed([&app](const QString &reason) {
+            std::fprintf(stderr, "subscriber: %s\n", qPrintable(reason));
+            app.exit(1);
+        });
+        if (app.exec() != 0) {
+            return 1;
+        }
+        const ShmTransportStats stats = subscriber.stats();
+        receiver.print("shm", scenario, &stats);
+        return 0;
+    }
+
+    QTcpSocket socket;
+    FrameDecoder decoder(FramingMode::LengthPrefixed, 256 * 1024);
+    QObject::connect(&socket, &QTcpSocket::readyRead, &socket, [&]() {
+        while (decoder.readFrom(&socket) > 0) {
+            FrameView frame;
+            while (decoder.next(&frame)) {
+                BenchProbe probe;
+                if (BenchProbeWire::decode(frame.data, frame.size, &probe) == WireDecodeStatus::Ok) {
+                    receiver.onProbe(probe);
+                }
+            }
+        }
+    });
+    socket.connectToHost(QHostAddress::LocalHost, static_cast<quint16>(endpoint.toUInt()));
+    if (!socket.waitForConnected(5000)) {
+        std::fprintf(stderr, "subscriber: %s\n", qPrintable(socket.errorString()));
+        return 1;
+    }
+    socket.setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    app.exec();
+    receiver.print("tcp", scenario, nullptr);
+    return 0;
+}
+
+// ===== 发布端 =====
+
+static QProcess *startSubscriber(const QString &transport, const QString &endpoint, const char *scenario,
+                                 qint64 count) {
+    QProcess *process = new QProcess();
+    process->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+    process->start(QCoreApplication::applicationFilePath(),
+                   {"--subscriber", transport, endpoint, QString::fromLatin1(scenario), QString::number(count)});
+    return process;
+}
+
+static void finishSubscriber(QProcess *process) {
+    if (!process->waitForFinished(60000)) {
+        std::printf("subscriber did not finish\n");
+        process->kill();
+        process->waitForFinished();
+    }
+    std::fputs(process->readAllStandardOutput().constData(), stdout);
+    delete process;
+}
+
+// intervalNs为0表示尽快发送；send返回false表示需要重试
+template <typename Send>
+static qint64 sendProbes(qint64 count, qint64 intervalNs, Send send) {
+    const qint64 startNs = steadyNowNs();
+    qint64 retries = 0;
+    BenchProbe probe;
+    for (qint64 i = 0; i < count; ++i) {
+        if (intervalNs > 0) {
+            const qint64 due = startNs + i * intervalNs;
+            while (steadyNowNs() < due) {
+            }
+        }
+        probe.sequence = i;
+        probe.sentNs = steadyNowNs();
+        while (!send(probe)) {
+            ++retries;
+            QThread::yieldCurrentThread();
+            probe.sentNs = steadyNowNs();
+        }
+    }
+    return retries;
+}
+
+static void runShm(const char *scenario, qint64 count, qint64 intervalNs) {
+    const QString name = QStringLiteral("netdebug-shm-bench-%1").arg(QCoreApplication::applicationPid());
+    ShmPublisher publisher(4096);
+    QString error;
+    if (!publisher.listen(name, &error)) {
+        std::printf("shm: %s\n", qPrintable(error));
+        return;
+    }
+
+    QProcess *process = startSubscriber("shm", name, scenario, count);
+    QElapsedTimer timer;
+    timer.start();
+    while (publisher.subscriberCount() == 0 && timer.elapsed() < 5000) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    }
+    if (publisher.subscriberCount() == 0) {
+        std::printf("shm: subscriber did not attach\n");
+    } else {
+        const qint64 retries = sendProbes(count, intervalNs, [&publisher](const BenchProbe &probe) {
+            return publisher.publish<BenchProbeWire>(probe) > 0;
+        });
+        if (retries > 0) {
+            std::printf("  (shm %s: ring full, %lld retries)\n", scenario, static_cast<long long>(retries));
+        }
+    }
+    finishSubscriber(process);
+}
+
+static void runTcp(const char *scenario, qint64 count, qint64 intervalNs) {
+    QTcpServer server;
+    if (!server.listen(QHostAddress::LocalHost, 0)) {
+        std::printf("tcp: %s\n", qPrintable(server.errorString()));
+        return;
+    }
+
+    QProcess *process = startSubscriber("tcp", QString::number(server.serverPort()), scenario, count);
+    if (!server.waitForNewConnection(5000)) {
+        std::printf("tcp: subscriber did not connect\n");
+        finishSubscriber(process);
+        return;
+    }
+    QTcpSocket *socket = server.nextPendingConnection();
+    socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+
+    QByteArray frame;
+    frame.reserve(64);
+    sendProbes(count, intervalNs, [socket, &frame](const BenchProbe &probe) {
+        // 与示例服务器相同：每条消息一个长度前缀帧，立即写入内核
+        char payload[BenchProbeWire::kSize];
+        BenchProbeWire::encode(probe, payload);
+        frame.resize(0);
+        appendLengthPrefixedFrame(frame, payload, static_cast<qint32>(sizeof(payload)));
+        socket->write(frame);
+        socket->flush();
+        if (socket->bytesToWrite() > 4 * 1024 * 1024) {
+            socket->waitForBytesWritten(100);
+        }
+        return true;
+    });
+    while (socket->bytesToWrite() > 0 && socket->waitForBytesWritten(5000)) {
+    }
+    finishSubscriber(process);
+    socket->disconnectFromHost();
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+
+    if (argc == 6 && std::strcmp(argv[1], "--subscriber") == 0) {
+        return runSubscriber(app, QString::fromLocal8Bit(argv[2]), QString::fromLocal8Bit(argv[3]), argv[4],
+                             std::atoll(argv[5]));
+    }
+
+    const qint64 count = argc > 1 ? std::atoll(argv[1]) : 1000000;
+    const qint64 pacedRate = argc > 2 ? std::atoll(argv[2]) : 100000;
+    const qint64 pacedCount = qMin(count, pacedRate * 5);
+
+    std::printf("Cross-process transport: %lld messages (%d bytes encoded), paced rate %lld msgs/s\n",
+                static_cast<long long>(count), static_cast<int>(BenchProbeWire::kSize),
+                static_cast<long long>(pacedRate));
+
+    runShm("burst", count, 0);
+    runTcp("burst", count, 0);
+    runShm("paced", pacedCount, 1000000000LL / pacedRate);
+    runTcp("paced", pacedCount, 1000000000LL / pacedRate);
+    return 0;
+}
+
+#else // !NETDEBUG_HAVE_SHM_TRANSPORT
+
+int main() {
+    std::printf("shm_transport_benchmark requires Linux (memfd/eventfd)\n");
+    return 0;
+}
+
+#endif // NETDEBUG_HAVE_SHM_TRANSPORT
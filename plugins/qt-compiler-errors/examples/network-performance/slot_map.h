@@ -0,0 +1,129 @@
+/**
+ * @file slot_map.h
+ * @brief 代数槽位表（generational slot map）
+ *
+ * 插入、查找、删除均为O(1)；值连续存放在稠密数组中，遍历对缓存友好。
+ * 句柄带有代数，元素删除后旧句柄自动失效，可安全地被排队的信号槽lambda捕获。
+ */
+
+#ifndef SLOT_MAP_H
+#define SLOT_MAP_H
+
+#include <QtGlobal>
+#include <vector>
+#include <utility>
+
+struct SlotHandle {
+    quint32 index = 0;
+    quint32 generation = 0;     // 0 保留给空句柄
+
+    bool isNull() const { return generation == 0; }
+    bool operator==(const SlotHandle &other) const {
+        return index == other.index && generation == other.generation;
+    }
+    bool operator!=(const SlotHandle &other) const { return !(*this == other); }
+};
+
+template <typename T>
+class SlotMap {
+public:
+    void reserve(size_t capacity) {
+        m_slots.reserve(capacity);
+        m_values.reserve(capacity);
+        m_denseToSlot.reserve(capacity);
+    }
+
+    SlotHandle insert(T value) {
+        quint32 slotIndex;
+        if (m_freeHead != kNoFreeSlot) {
+            slotIndex = m_freeHead;
+            m_freeHead = m_slots[slotIndex].denseIndex;
+        } else {
+            slotIndex = static_cast<quint32>(m_slots.size());
+            m_slots.push_back(Slot{1, 0});
+        }
+
+        Slot &slot = m_slots[slotIndex];
+        slot.denseIndex = static_cast<quint32>(m_values.size());
+        m_values.push_back(std::move(value));
+        m_denseToSlot.push_back(slotIndex);
+
+        return SlotHandle{slotIndex, slot.generation};
+    }
+
+    T *find(SlotHandle handle) {
+        if (!contains(handle)) {
+            return nullptr;
+        }
+        return &m_values[m_slots[handle.index].denseIndex];
+    }
+
+    const T *find(SlotHandle handle) const {
+        if (!contains(handle)) {
+            return nullptr;
+        }
+        return &m_values[m_slots[handle.index].denseIndex];
+    }
+
+    bool contains(SlotHandle handle) const {
+        return handle.index < m_slots.size()
+               && handle.generation != 0
+               && m_slots[handle.index].generation == handle.generation;
+    }
+
+    // 与稠密数组末尾交换后弹出，不移动其他元素
+    bool remove(SlotHandle handle) {
+        if (!contains(handle)) {
+            return false;
+        }
+
+        Slot &slot = m_slots[handle.index];
+        const quint32 dense = slot.denseIndex;
+        const quint32 last = static_cast<quint32>(m_values.size() - 1);
+
+        if (dense != last) {
+            m_values[dense] = std::move(m_values[last]);
+            m_denseToSlot[dense] = m_denseToSlot[last];
+            m_slots[m_denseToSlot[dense]].denseIndex = dense;
+        }
+        m_values.pop_back();
+        m_denseToSlot.pop_back();
+
+        // 递增代数使旧句柄失效；跳过0以保留空句柄
+        if (++slot.generation == 0) {
+            slot.generation = 1;
+        }
+        slot.denseIndex = m_freeHead;
+        m_freeHead = handle.index;
+        return true;
+    }
+
+    // 稠密下标 -> 句柄，用于遍历时反查
+    SlotHandle handleAt(size_t denseIndex) const {
+        const quint32 slotIndex = m_denseToSlot[denseIndex];
+        return SlotHandle{slotIndex, m_slots[slotIndex].generation};
+    }
+
+    size_t size() const { return m_values.size(); }
+    bool isEmpty() const { return m_values.empty(); }
+
+    typename std::vector<T>::iterator begin() { return m_values.begin(); }
+    typename std::vector<T>::iterator end() { return m_values.end(); }
+    typename std::vector<T>::const_iterator begin() const { return m_values.begin(); }
+    typename std::vector<T>::const_iterator end() const { return m_values.end(); }
+
+private:
+    static constexpr quint32 kNoFreeSlot = 0xFFFFFFFFu;
+
+    struct Slot {
+        quint32 generation;
+        quint32 denseIndex;     // 空闲时复用为空闲链表的下一个槽位
+    };
+
+    std::vector<Slot> m_slots;
+    std::vector<T> m_values;
+    std::vector<quint32> m_denseToSlot;
+    quint32 m_freeHead = kNoFreeSlot;
+};
+
+#endif // SLOT_MAP_H
@@ -0,0 +1,481 @@
+/**
+ * @file thread_placement.h
+ * @brief 按线程名配置CPU亲和性与调度策略，并报告实际生效的位置
+ *
+ * 配置来源（后者覆盖前者的同名规则）：
+ *   NETDEBUG_THREAD_PLACEMENT       规则写成一行，条目之间用';'分隔：
+ *       network=2-3:fifo:50;receiver=4;gui=0-1
+ *   NETDEBUG_THREAD_PLACEMENT_FILE  同样的规则写成JSON文件，例如
+ *       { "network": { "cpus": "2-3", "policy": "fifo", "priority": 50 },
+ *         "gui":     { "cpus": "0-1" } }
+ *   loadFile()                      程序显式加载的文件（如--thread-placement）
+ *
+ * policy: inherit（默认，不修改）| other | batch | idle | fifo | rr
+ * priority: fifo/rr为实时优先级(1-99)，other/batch为nice值(-20~19)
+ *
+ * 规则必须在目标线程内应用：QThread用attach()在started时应用，
+ * 其他线程在入口处调用applyToCurrentThread()。权限不足（如实时策略需要CAP_SYS_NICE）
+ * 时保留已成功的部分，并在报告中记录错误，不影响线程运行。
+ *
+ * 每个应用过的线程在MetricsRegistry中导出：
+ *   netdebug_thread_placement_info{thread,cpus,policy,priority} 1
+ *   netdebug_thread_allowed_cpus{thread}    实际允许运行的CPU数
+ *   netdebug_thread_migrations_total{thread} 内核记录的跨核迁移次数（Linux）
+ * 线程结束时调用threadFinished()撤下这些序列；attach()的线程在QThread::finished时自动调用。
+ */
+
+#ifndef THREAD_PLACEMENT_H
+#define THREAD_PLACEMENT_H
+
+#include <QByteArray>
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+#include <QtGlobal>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "metrics.h"
+
+#ifdef Q_OS_LINUX
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+enum class SchedulingPolicy {
+    Inherit,
+    Other,
+    Batch,
+    Idle,
+    Fifo,
+    RoundRobin
+};
+
+struct ThreadPlacementRule {
+    std::vector<int> cpus;          // 空表示不限制
+    SchedulingPolicy policy = SchedulingPolicy::Inherit;
+    int priority = 0;
+};
+
+// 线程实际所处的位置（从内核读回，而不是配置值）
+struct ThreadPlacementReport {
+    QByteArray thread;
+    qint64 tid = 0;
+    QByteArray requestedCpus;
+    QByteArray actualCpus;
+    int allowedCpuCount = 0;
+    int currentCpu = -1;
+    QByteArray policy;
+    int priority = 0;
+    QStringList errors;
+};
+
+// "0-3,6" <-> {0,1,2,3,6}
+inline bool parseCpuList(const QByteArray &text, std::vector<int> *cpus) {
+    cpus->clear();
+    const QByteArray trimmed = text.trimmed();
+    if (trimmed.isEmpty() || trimmed == "*") {
+        return true;
+    }
+    for (const QByteArray &part : trimmed.split(',')) {
+        const int dash = part.indexOf('-');
+        bool okFirst = false;
+        bool okLast = false;
+        const int first = (dash < 0 ? part : part.left(dash)).trimmed().toInt(&okFirst);
+        const int last = dash < 0 ? first : part.mid(dash + 1).trimmed().toInt(&okLast);
+        if (!okFirst || (dash >= 0 && !okLast) || first < 0 || last < first) {
+            return false;
+        }
+        for (int cpu = first; cpu <= last; ++cpu) {
+            cpus->push_back(cpu);
+        }
+    }
+    std::sort(cpus->begin(), cpus->end());
+    cpus->erase(std::unique(cpus->begin(), cpus->end()), cpus->end());
+    return true;
+}
+
+inline QByteArray formatCpuList(const std::vector<int> &cpus) {
+    if (cpus.empty()) {
+        return "*";
+    }
+    QByteArray out;
+    size_t i = 0;
+    while (i < cpus.size()) {
+        size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) {
+            ++j;
+        }
+        if (!out.isEmpty()) {
+            out += ',';
+        }
+        out += QByteArray::number(cpus[i]);
+        if (j > i) {
+            out += '-' + QByteArray::number(cpus[j]);
+        }
+        i = j + 1;
+    }
+    return out;
+}
+
+inline bool parseSchedulingPolicy(const QByteArray &text, SchedulingPolicy *policy) {
+    const QByteArray name = text.trimmed().toLower();
+    if (name.isEmpty() || name == "inherit") {
+        *policy = SchedulingPolicy::Inherit;
+    } else if (name == "other" || name == "normal") {
+        *policy = SchedulingPolicy::Other;
+    } else if (name == "batch") {
+        *policy = SchedulingPolicy::Batch;
+    } else if (name == "idle") {
+        *policy = SchedulingPolicy::Idle;
+    } else if (name == "fifo") {
+        *policy = SchedulingPolicy::Fifo;
+    } else if (name == "rr") {
+        *policy = SchedulingPolicy::RoundRobin;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+class ThreadPlacement {
+public:
+    // 第一次使用时从环境变量加载配置
+    static ThreadPlacement &instance() {
+        static ThreadPlacement placement;
+        return placement;
+    }
+
+    bool loadFile(const QString &path, QString *errorMessage) {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) {
+            *errorMessage = QString("Cannot open %1: %2").arg(path, file.errorString());
+            return false;
+        }
+        QJsonParseError parseError;
+        const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+        if (!document.isObject()) {
+            *errorMessage = QString("%1: %2").arg(path, parseError.errorString());
+            return false;
+        }
+
+        const QJsonObject threads = document.object();
+        for (auto it = threads.begin(); it != threads.end(); ++it) {
+            const QJsonObject entry = it.value().toObject();
+            ThreadPlacementRule rule;
+            // "cpus"可以是"2-3"这样的字符串，也可以是数字或数字数组
+            const QJsonValue cpus = entry.value("cpus");
+            QByteArray cpuText = cpus.toString().toUtf8();
+            if (cpus.isDouble()) {
+                cpuText = QByteArray::number(cpus.toInt());
+            } else if (cpus.isArray()) {
+                for (const QJsonValue &cpu : cpus.toArray()) {
+                    cpuText += (cpuText.isEmpty() ? "" : ",") + QByteArray::number(cpu.toInt());
+                }
+            }
+            if (!parseCpuList(cpuText, &rule.cpus)
+                || !parseSchedulingPolicy(entry.value("policy").toString().toUtf8(), &rule.policy)) {
+                *errorMessage = QString("%1: invalid placement for thread '%2'").arg(path, it.key());
+                return false;
+            }
+            rule.priority = entry.value("priority").toInt();
+            setRule(it.key().toUtf8(), rule);
+        }
+        return true;
+    }
+
+    // name=cpus[:policy[:priority]];...
+    bool parseSpec(const QByteArray &spec, QString *errorMessage) {
+        for (const QByteArray &entry : spec.split(';')) {
+            if (entry.trimmed().isEmpty()) {
+                continue;
+            }
+            const int equals = entry.indexOf('=');
+            const QList<QByteArray> fields = entry.mid(equals + 1).split(':');
+            ThreadPlacementRule rule;
+            bool ok = equals > 0 && fields.size() <= 3 && parseCpuList(fields.value(0), &rule.cpus)
+                      && parseSchedulingPolicy(fields.value(1), &rule.policy);
+            if (ok && fields.size() == 3) {
+                rule.priority = fields.at(2).trimmed().toInt(&ok);
+            }
+            if (!ok) {
+                *errorMessage = QString("Invalid thread placement entry '%1'").arg(QString::fromUtf8(entry));
+                return false;
+            }
+            setRule(entry.left(equals).trimmed(), rule);
+        }
+        return true;
+    }
+
+    void setRule(const QByteArray &thread, const ThreadPlacementRule &rule) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_rules[thread] = rule;
+    }
+
+    // started在新线程中发射，直接连接保证规则在该线程内应用
+    void attach(QThread *thread, const QByteArray &name) {
+        QObject::connect(thread, &QThread::started, [name]() {
+            ThreadPlacement::instance().applyToCurrentThread(name);
+        });
+        QObject::connect(thread, &QThread::finished, [name]() {
+            ThreadPlacement::instance().threadFinished(name);
+        });
+    }
+
+    // 线程退出前调用：撤下该线程的指标，已退出的线程不再出现在抓取结果中
+    void threadFinished(const QByteArray &name) {
+        QByteArray infoLabels;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_infoLabels.find(name);
+            if (it == m_infoLabels.end()) {
+                return;
+            }
+            infoLabels = it->second;
+            m_infoLabels.erase(it);
+        }
+        MetricsRegistry &metrics = MetricsRegistry::instance();
+        const QByteArray labels = metricLabel("thread", name);
+        metrics.retire("netdebug_thread_placement_info", infoLabels);
+        metrics.retire("netdebug_thread_allowed_cpus", labels);
+        metrics.retire("netdebug_thread_migrations_total", labels);
+    }
+
+    // 在目标线程中调用；没有规则时也报告当前位置，便于发现浮动的线程
+    ThreadPlacementReport applyToCurrentThread(const QByteArray &name) {
+        ThreadPlacementRule rule;
+        bool hasRule = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_rules.find(name);
+            if (it != m_rules.end()) {
+                rule = it->second;
+                hasRule = true;
+            }
+        }
+
+        ThreadPlacementReport report;
+        report.thread = name;
+        report.requestedCpus = hasRule ? formatCpuList(rule.cpus) : QByteArray("*");
+#ifdef Q_OS_LINUX
+        report.tid = static_cast<qint64>(::syscall(SYS_gettid));
+        if (hasRule) {
+            applyRule(rule, report.tid, &report.errors);
+        }
+        readBack(&report);
+#else
+        Q_UNUSED(rule);
+        if (hasRule) {
+            report.errors << "Thread placement is only supported on Linux";
+        }
+        report.actualCpus = "*";
+        report.policy = "inherit";
+#endif
+
+        qDebug().noquote() << "[DEBUG] Thread placement:" << report.thread << "tid" << report.tid
+                           << "cpus" << report.actualCpus << "(requested" << report.requestedCpus + ")"
+                           << "current cpu" << report.currentCpu
+                           << "policy" << report.policy << "priority" << report.priority;
+        for (const QString &error : report.errors) {
+            qWarning().noquote() << "[WARNING] Thread placement for" << report.thread << ":" << error;
+        }
+
+        exportMetrics(report);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_reports.push_back(report);
+        }
+        return report;
+    }
+
+    std::vector<ThreadPlacementReport> reports() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_reports;
+    }
+
+private:
+    ThreadPlacement() {
+        QString errorMessage;
+        // ❌原来：先读文件再读NETDEBUG_THREAD_PLACEMENT，环境变量反而覆盖了文件
+        // ✅现在：先解析环境变量，再加载文件，同名线程以文件为准
+        const QByteArray spec = qgetenv("NETDEBUG_THREAD_PLACEMENT");
+        if (!spec.isEmpty() && !parseSpec(spec, &errorMessage)) {
+            qWarning().noquote() << "[WARNING]" << errorMessage;
+        }
+        const QByteArray file = qgetenv("NETDEBUG_THREAD_PLACEMENT_FILE");
+        if (!file.isEmpty() && !loadFile(QString::fromLocal8Bit(file), &errorMessage)) {
+            qWarning().noquote() << "[WARNING]" << errorMessage;
+        }
+    }
+
+#ifdef Q_OS_LINUX
+    static void applyRule(const ThreadPlacementRule &rule, qint64 tid, QStringList *errors) {
+        if (!rule.cpus.empty()) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            for (int cpu : rule.cpus) {
+                if (cpu < CPU_SETSIZE) {
+                    CPU_SET(cpu, &set);
+                }
+            }
+            const int result = ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set);
+            if (result != 0) {
+                *errors << QString("setaffinity(%1): %2").arg(QString::fromLatin1(formatCpuList(rule.cpus)),
+                                                             QString::fromLocal8Bit(::strerror(result)));
+            }
+        }
+
+        if (rule.policy == SchedulingPolicy::Inherit) {
+            return;
+        }
+
+        int policy = SCHED_OTHER;
+        switch (rule.policy) {
+        case SchedulingPolicy::Batch:      policy = SCHED_BATCH; break;
+        case SchedulingPolicy::Idle:       policy = SCHED_IDLE; break;
+        case SchedulingPolicy::Fifo:       policy = SCHED_FIFO; break;
+        case SchedulingPolicy::RoundRobin: policy = SCHED_RR; break;
+        default:                           break;
+        }
+        const bool realtime = policy == SCHED_FIFO || policy == SCHED_RR;
+
+        sched_param param;
+        param.sched_priority = realtime ? qBound(::sched_get_priority_min(policy), rule.priority,
+                                                 ::sched_get_priority_max(policy))
+                                        : 0;
+        const int result = ::pthread_setschedparam(::pthread_self(), policy, &param);
+        if (result != 0) {
+            *errors << QString("setschedparam: %1").arg(QString::fromLocal8Bit(::strerror(result)));
+        }
+
+        // 非实时策略的优先级是nice值，Linux上按线程生效
+        if (!realtime && policy != SCHED_IDLE && rule.priority != 0
+            && ::setpriority(PRIO_PROCESS, static_cast<id_t>(tid), rule.priority) != 0) {
+            *errors << QString("setpriority(%1): %2").arg(rule.priority).arg(QString::fromLocal8Bit(::strerror(errno)));
+        }
+    }
+
+    static void readBack(ThreadPlacementReport *report) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        std::vector<int> cpus;
+        if (::pthread_getaffinity_np(::pthread_self(), sizeof(set), &set) == 0) {
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &set)) {
+                    cpus.push_back(cpu);
+                }
+            }
+        }
+        report->actualCpus = formatCpuList(cpus);
+        report->allowedCpuCount = static_cast<int>(cpus.size());
+        report->currentCpu = ::sched_getcpu();
+
+        int policy = SCHED_OTHER;
+        sched_param param;
+        if (::pthread_getschedparam(::pthread_self(), &policy, &param) == 0) {
+            switch (policy) {
+            case SCHED_FIFO:  report->policy = "fifo"; break;
+            case SCHED_RR:    report->policy = "rr"; break;
+            case SCHED_BATCH: report->policy = "batch"; break;
+            case SCHED_IDLE:  report->policy = "idle"; break;
+            default:          report->policy = "other"; break;
+            }
+            report->priority = policy == SCHED_FIFO || policy == SCHED_RR
+                             ? param.sched_priority
+                             : ::getpriority(PRIO_PROCESS, static_cast<id_t>(report->tid));
+        }
+    }
+
+    // /proc/self/task/<tid>/stat的第22个字段：线程启动时间（时钟滴答），读取失败返回-1
+    static qint64 readStartTime(qint64 tid) {
+        QFile file(QString("/proc/self/task/%1/stat").arg(tid));
+        if (!file.open(QIODevice::ReadOnly)) {
+            return -1;
+        }
+        // 线程名可能含空格和括号：从最后一个')'之后数起，第一个字段是第3个字段
+        const QByteArray stat = file.readAll();
+        const QList<QByteArray> fields = stat.mid(stat.lastIndexOf(')') + 2).split(' ');
+        bool ok = false;
+        const qint64 startTime = fields.value(22 - 3).toLongLong(&ok);
+        return ok ? startTime : -1;
+    }
+
+    // /proc/self/task/<tid>/sched中的se.nr_migrations
+    // ❌ 原来：只凭导出时记录的TID读取，线程退出后TID被新线程复用，counter会跳变甚至回退
+    // ✅ 现在：读取前后都核对线程启动时间，不是同一个线程就保留上次的值；结果只增不减
+    static double readMigrations(qint64 tid, qint64 startTime, double *last) {
+        if (startTime < 0 || readStartTime(tid) != startTime) {
+            return *last;
+        }
+        double migrations = -1;
+        QFile file(QString("/proc/self/task/%1/sched").arg(tid));
+        if (file.open(QIODevice::ReadOnly)) {
+            for (const QByteArray &line : file.readAll().split('\n')) {
+                if (line.startsWith("se.nr_migrations")) {
+                    migrations = line.mid(line.indexOf(':') + 1).trimmed().toDouble();
+                    break;
+                }
+            }
+        }
+        if (migrations >= 0 && readStartTime(tid) == startTime) {
+            *last = qMax(*last, migrations);
+        }
+        return *last;
+    }
+#endif
+
+    void exportMetrics(const ThreadPlacementReport &report) {
+        MetricsRegistry &metrics = MetricsRegistry::instance();
+        const QByteArray labels = metricLabel("thread", report.thread);
+        const QByteArray infoLabels = labels + ',' + metricLabel("cpus", report.actualCpus) + ','
+                                    + metricLabel("policy", report.policy) + ','
+                                    + metricLabel("priority", QByteArray::number(report.priority));
+        QByteArray previousInfoLabels;
+        {
+            // 同名线程重新应用（如Reactor重启）后放置可能不同，旧的info序列要撤下
+            std::lock_guard<std::mutex> lock(m_mutex);
+            QByteArray &exported = m_infoLabels[report.thread];
+            previousInfoLabels = exported;
+            exported = infoLabels;
+        }
+        if (!previousInfoLabels.isEmpty() && previousInfoLabels != infoLabels) {
+            metrics.retire("netdebug_thread_placement_info", previousInfoLabels);
+        }
+        metrics.gauge("netdebug_thread_placement_info", "Actual thread placement (value is always 1)",
+                      infoLabels)->set(1);
+        metrics.gauge("netdebug_thread_allowed_cpus", "CPUs the thread is allowed to run on",
+                      labels)->set(report.allowedCpuCount);
+#ifdef Q_OS_LINUX
+        const qint64 tid = report.tid;
+        const qint64 startTime = readStartTime(tid);
+        std::shared_ptr<double> last = std::make_shared<double>(0.0);
+        // se.nr_migrations是内核维护的累计值，按counter导出，配合rate()使用
+        metrics.counterFunction("netdebug_thread_migrations_total", "Times the kernel moved the thread to another CPU",
+                                labels, [tid, startTime, last]() {
+                                    return readMigrations(tid, startTime, last.get());
+                                });
+#endif
+    }
+
+    mutable std::mutex m_mutex;
+    std::map<QByteArray, ThreadPlacementRule> m_rules;
+    std::vector<ThreadPlacementReport> m_reports;
+    std::map<QByteArray, QByteArray> m_infoLabels;     // 线程名 -> 当前导出的info序列标签
+};
+
+#endif // THREAD_PLACEMENT_H
@@ -0,0 +1,233 @@
+/**
+ * @file timing_wheel.h
+ * @brief 分层时间轮
+ *
+ * 4层 × 64槽，每层覆盖上一层的64倍时间范围（tick=100ms时第0层6.4秒，第3层约19天）。
+ * 定时器节点放在连续数组中，以下标组成槽内双向链表：arm/rearm/cancel均为O(1)，
+ * advance()每个tick只处理一个第0层槽，到期的键批量追加到调用方提供的vector中。
+ * 低层槽位回绕时把上一层对应槽的节点重新分配到下层（级联）。
+ *
+ * 不是线程安全的：每个I/O线程持有自己的时间轮。
+ */
+
+#ifndef TIMING_WHEEL_H
+#define TIMING_WHEEL_H
+
+#include <QtGlobal>
+#include <array>
+#include <limits>
+#include <vector>
+
+// 空闲检测：超过heartbeatMs没有收到数据则发送心跳，超过idleTimeoutMs则断开；0表示关闭
+struct IdleTimeoutConfig {
+    qint64 heartbeatMs = 15000;
+    qint64 idleTimeoutMs = 60000;
+    qint64 tickMs = 100;            // 时间轮精度
+
+    bool enabled() const { return heartbeatMs > 0 || idleTimeoutMs > 0; }
+};
+
+// 空闲定时器到期时调用方应执行的动作
+enum class IdleAction {
+    Rearm,          // 期间有数据到达，重新挂回时间轮
+    SendHeartbeat,
+    Disconnect
+};
+
+inline IdleAction idleActionFor(const IdleTimeoutConfig &config, qint64 idleMs) {
+    if (config.idleTimeoutMs > 0 && idleMs >= config.idleTimeoutMs) {
+        return IdleAction::Disconnect;
+    }
+    if (config.heartbeatMs > 0 && idleMs >= config.heartbeatMs) {
+        return IdleAction::SendHeartbeat;
+    }
+    return IdleAction::Rearm;
+}
+
+// 下一次需要检查连接的时间：未发心跳时为心跳时刻，已发心跳后每个心跳周期重发一次，且不晚于空闲超时
+inline qint64 nextIdleDeadline(const IdleTimeoutConfig &config, qint64 lastActivityMs,
+                               bool heartbeatPending, qint64 nowMs) {
+    qint64 deadline = std::numeric_limits<qint64>::max();
+    if (config.heartbeatMs > 0) {
+        deadline = heartbeatPending ? nowMs + config.heartbeatMs : lastActivityMs + config.heartbeatMs;
+    }
+    if (config.idleTimeoutMs > 0) {
+        deadline = qMin(deadline, lastActivityMs + config.idleTimeoutMs);
+    }
+    return deadline;
+}
+
+template <typename Key>
+class TimingWheel {
+public:
+    // 节点下标，在到期或cancel()之前有效
+    using TimerId = qint32;
+    static constexpr TimerId kInvalidTimer = -1;
+
+    static constexpr int kLevels = 4;
+    static constexpr int kSlotBits = 6;
+    static constexpr int kSlots = 1 << kSlotBits;
+    static constexpr qint64 kSlotMask = kSlots - 1;
+
+    explicit TimingWheel(qint64 tickMs = 100, qint64 nowMs = 0)
+        : m_tickMs(qMax<qint64>(tickMs, 1)), m_nextTick(nowMs / m_tickMs) {
+        m_heads.fill(kInvalidTimer);
+    }
+
+    qint64 tickMs() const { return m_tickMs; }
+    int size() const { return m_activeCount; }
+    bool isEmpty() const { return m_activeCount == 0; }
+
+    TimerId arm(qint64 deadlineMs, const Key &key) {
+        const TimerId id = allocateNode();
+        Node &node = m_nodes[static_cast<size_t>(id)];
+        node.key = key;
+        node.deadline = tickFor(deadlineMs);
+        link(id);
+        ++m_activeCount;
+        return id;
+    }
+
+    void rearm(TimerId id, qint64 deadlineMs) {
+        unlink(id);
+        m_nodes[static_cast<size_t>(id)].deadline = tickFor(deadlineMs);
+        link(id);
+    }
+
+    void cancel(TimerId id) {
+        unlink(id);
+        freeNode(id);
+        --m_activeCount;
+    }
+
+    // 推进到nowMs，到期的键追加到expired（节点已释放）；返回本次到期数
+    int advance(qint64 nowMs, std::vector<Key> *expired) {
+        const qint64 targetTick = nowMs / m_tickMs;
+        int fired = 0;
+
+        while (m_nextTick <= targetTick) {
+            const int index = static_cast<int>(m_nextTick & kSlotMask);
+            if (index == 0) {
+                // 第L层的槽位只在第L-1层回绕时才需要级联
+                for (int level = 1; level < kLevels; ++level) {
+                    const int levelIndex = static_cast<int>((m_nextTick >> (kSlotBits * level)) & kSlotMask);
+                    cascade(level, levelIndex);
+                    if (levelIndex != 0) {
+                        break;
+                    }
+                }
+            }
+
+            TimerId id = m_heads[static_cast<size_t>(index)];
+            m_heads[static_cast<size_t>(index)] = kInvalidTimer;
+            while (id != kInvalidTimer) {
+                Node &node = m_nodes[static_cast<size_t>(id)];
+                const TimerId next = node.next;
+                if (node.deadline <= m_nextTick) {
+                    expired->push_back(node.key);
+                    freeNode(id);
+                    --m_activeCount;
+                    ++fired;
+                } else {
+                    link(id);   // 超出最大范围而被钳位的节点，重新放置
+                }
+                id = next;
+            }
+            ++m_nextTick;
+        }
+        return fired;
+    }
+
+private:
+    struct Node {
+        Key key{};
+        qint64 deadline = 0;            // 以tick为单位
+        TimerId prev = kInvalidTimer;
+        TimerId next = kInvalidTimer;   // 空闲节点复用为空闲链表指针
+        qint32 slot = -1;               // level * kSlots + index，-1表示不在任何槽中
+    };
+
+    // 向上取整，保证定时器不会提前到期
+    qint64 tickFor(qint64 deadlineMs) const { return (deadlineMs + m_tickMs - 1) / m_tickMs; }
+
+    TimerId allocateNode() {
+        if (m_freeHead != kInvalidTimer) {
+            const TimerId id = m_freeHead;
+            m_freeHead = m_nodes[static_cast<size_t>(id)].next;
+            return id;
+        }
+        m_nodes.emplace_back();
+        return static_cast<TimerId>(m_nodes.size() - 1);
+    }
+
+    void freeNode(TimerId id) {
+        Node &node = m_nodes[static_cast<size_t>(id)];
+        node.key = Key{};
+        node.slot = -1;
+        node.prev = kInvalidTimer;
+        node.next = m_freeHead;
+        m_freeHead = id;
+    }
+
+    void link(TimerId id) {
+        Node &node = m_nodes[static_cast<size_t>(id)];
+        if (node.deadline < m_nextTick) {
+            node.deadline = m_nextTick;
+        }
+
+        const qint64 delta = node.deadline - m_nextTick;
+        int level = 0;
+        while (level < kLevels - 1 && delta >= (qint64(1) << (kSlotBits * (level + 1)))) {
+            ++level;
+        }
+        const qint64 maxDelta = (qint64(1) << (kSlotBits * kLevels)) - 1;
+        const qint64 placement = delta > maxDelta ? m_nextTick + maxDelta : node.deadline;
+        const int index = static_cast<int>((placement >> (kSlotBits * level)) & kSlotMask);
+
+        const qint32 slot = level * kSlots + index;
+        node.slot = slot;
+        node.prev = kInvalidTimer;
+        node.next = m_heads[static_cast<size_t>(slot)];
+        if (node.next != kInvalidTimer) {
+            m_nodes[static_cast<size_t>(node.next)].prev = id;
+        }
+        m_heads[static_cast<size_t>(slot)] = id;
+    }
+
+    void unlink(TimerId id) {
+        Node &node = m_nodes[static_cast<size_t>(id)];
+        if (node.slot < 0) {
+            return;
+        }
+        if (node.prev != kInvalidTimer) {
+            m_nodes[static_cast<size_t>(node.prev)].next = node.next;
+        } else {
+            m_heads[static_cast<size_t>(node.slot)] = node.next;
+        }
+        if (node.next != kInvalidTimer) {
+            m_nodes[static_cast<size_t>(node.next)].prev = node.prev;
+        }
+        node.prev = node.next = kInvalidTimer;
+        node.slot = -1;
+    }
+
+    void cascade(int level, int index) {
+        const size_t slot = static_cast<size_t>(level * kSlots + index);
+        TimerId id = m_heads[slot];
+        m_heads[slot] = kInvalidTimer;
+        while (id != kInvalidTimer) {
+            const TimerId next = m_nodes[static_cast<size_t>(id)].next;
+            link(id);
+            id = next;
+        }
+    }
+
+    qint64 m_tickMs;
+    qint64 m_nextTick;                  // 下一个待处理的tick
+    std::array<TimerId, kLevels * kSlots> m_heads;
+    std::vector<Node> m_nodes;
+    TimerId m_freeHead = kInvalidTimer;
+    int m_activeCount = 0;
+};
+
+#endif // TIMING_WHEEL_H
@@ -0,0 +1,190 @@
+/**
+ * @file wire_codec.h
+ * @brief 由字段描述在编译期生成的定长二进制编解码
+ *
+ * 消息类型只需列出字段及其线上类型：
+ *
+ *     using StatusReplyWire = WireLayout<StatusReply, 0x01,
+ *                                        WireField<&StatusReply::workMode, qint32>,
+ *                                        WireField<&StatusReply::workStatus, quint8>>;
+ *
+ * 线上格式为1字节消息类型 + 各字段按声明顺序紧密排列，多字节整数一律大端。
+ * 消息长度、各字段偏移都是编译期常量：
+ *   - 编码写入调用方提供的定长缓冲区，不分配堆内存；
+ *   - 以定长数组编解码时长度检查由static_assert完成，运行时没有边界检查；
+ *     以指针+长度解码时只做一次整体长度检查，而不是每个字段一次；
+ *   - 解码先读出全部字段，再一次性校验（不逐字段提前返回），全部合法后才写入输出对象，
+ *     失败时输出对象保持不变。
+ *
+ * 字段的线上类型必须与成员类型同宽同符号（bool使用无符号线上类型，解码时只接受0/1），
+ * 因此编码不需要运行时范围检查。
+ */
+
+#ifndef WIRE_CODEC_H
+#define WIRE_CODEC_H
+
+#include <QByteArray>
+#include <QtEndian>
+#include <QtGlobal>
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+enum class WireDecodeStatus {
+    Ok,
+    Truncated,          // 数据短于消息长度
+    WrongType,          // 消息类型字节不匹配
+    InvalidField        // 某个字段的值不合法（如bool不是0/1）
+};
+
+template <typename MemberPointer>
+struct WireMemberTraits;
+
+template <typename Class, typename Member>
+struct WireMemberTraits<Member Class::*> {
+    using ClassType = Class;
+    using MemberType = Member;
+};
+
+// 一个字段：成员指针 + 线上类型
+template <auto Member, typename Wire>
+struct WireField {
+    using Class = typename WireMemberTraits<decltype(Member)>::ClassType;
+    using Value = typename WireMemberTraits<decltype(Member)>::MemberType;
+    using WireType = Wire;
+
+    static_assert(std::is_integral<Wire>::value && !std::is_same<Wire, bool>::value,
+                  "wire type must be a fixed-width integer");
+    static_assert(std::is_same<Value, bool>::value
+                      ? std::is_unsigned<Wire>::value
+                      : (std::is_integral<Value>::value && sizeof(Wire) == sizeof(Value)
+                         && std::is_signed<Wire>::value == std::is_signed<Value>::value),
+                  "wire type must match the member's width and signedness");
+
+    static constexpr size_t kSize = sizeof(Wire);
+
+    static void write(const Class &object, uchar *out) noexcept {
+        qToBigEndian<Wire>(static_cast<Wire>(object.*Member), out);
+    }
+
+    static Wire read(const uchar *in) noexcept { return qFromBigEndian<Wire>(in); }
+
+    static bool valid(Wire wire) noexcept {
+        if constexpr (std::is_same<Value, bool>::value) {
+            return wire <= 1;
+        } else {
+            Q_UNUSED(wire);
+            return true;
+        }
+    }
+
+    static void assign(Class &object, Wire wire) noexcept { object.*Member = static_cast<Value>(wire); }
+};
+
+template <typename T, quint8 TypeId, typename... Fields>
+class WireLayout {
+    static_assert(sizeof...(Fields) > 0, "a wire layout needs at least one field");
+    static_assert((std::is_same<typename Fields::Class, T>::value && ...), "all fields must belong to T");
+
+public:
+    using Type = T;
+    static constexpr quint8 kType = TypeId;
+    static constexpr size_t kTypeSize = 1;
+    static constexpr size_t kSize = kTypeSize + (Fields::kSize + ...);
+
+    using Buffer = std::array<char, kSize>;
+
+    // out至少kSize字节
+    static void encode(const T &value, char *out) noexcept {
+        uchar *bytes = reinterpret_cast<uchar *>(out);
+        bytes[0] = kType;
+        encodeFields(value, bytes, std::index_sequence_for<Fields...>());
+    }
+
+    template <size_t N>
+    static void encode(const T &value, char (&out)[N]) noexcept {
+        static_assert(N >= kSize, "buffer is smaller than the wire layout");
+        encode(value, &out[0]);
+    }
+
+    static Buffer encode(const T &value) noexcept {
+        Buffer buffer;
+        encode(value, buffer.data());
+        return buffer;
+    }
+
+    // 追加到out；out预留容量后重复使用时不再分配
+    static void appendTo(QByteArray &out, const T &value) {
+        const int offset = out.size();
+        out.resize(offset + static_cast<int>(kSize));
+        encode(value, out.data() + offset);
+    }
+
+    static WireDecodeStatus decode(const char *data, qint64 size, T *out) noexcept {
+        if (size < static_cast<qint64>(kSize)) {
+            return WireDecodeStatus::Truncated;
+        }
+        return decodeUnchecked(data, out);
+    }
+
+    template <size_t N>
+    static WireDecodeStatus decode(const char (&data)[N], T *out) noexcept {
+        static_assert(N >= kSize, "buffer is smaller than the wire layout");
+        return decodeUnchecked(&data[0], out);
+    }
+
+    static WireDecodeStatus decode(const Buffer &buffer, T *out) noexcept {
+        return decodeUnchecked(buffer.data(), out);
+    }
+
+private:
+    template <size_t I>
+    using Field = typename std::tuple_element<I, std::tuple<Fields...>>::type;
+
+    static constexpr std::array<size_t, sizeof...(Fields)> fieldOffsets() {
+        constexpr std::array<size_t, sizeof...(Fields)> sizes{{Fields::kSize...}};
+        std::array<size_t, sizeof...(Fields)> offsets{};
+        size_t offset = kTypeSize;
+        for (size_t i = 0; i < sizes.size(); ++i) {
+            offsets[i] = offset;
+            offset += sizes[i];
+        }
+        return offsets;
+    }
+
+    static constexpr std::array<size_t, sizeof...(Fields)> kOffsets = fieldOffsets();
+
+    template <size_t... I>
+    static void encodeFields(const T &value, uchar *out, std::index_sequence<I...>) noexcept {
+        (Field<I>::write(value, out + kOffsets[I]), ...);
+    }
+
+    static WireDecodeStatus decodeUnchecked(const char *data, T *out) noexcept {
+        const uchar *bytes = reinterpret_cast<const uchar *>(data);
+        if (bytes[0] != kType) {
+            return WireDecodeStatus::WrongType;
+        }
+        return decodeFields(bytes, out, std::index_sequence_for<Fields...>());
+    }
+
+    template <size_t... I>
+    static WireDecodeStatus decodeFields(const uchar *in, T *out, std::index_sequence<I...>) noexcept {
+        const std::tuple<typename Field<I>::WireType...> wire(Field<I>::read(in + kOffsets[I])...);
+        // 按位与而不是&&：所有字段都参与校验，没有逐字段的分支
+        const bool valid = (static_cast<unsigned>(Field<I>::valid(std::get<I>(wire))) & ...) != 0;
+        if (!valid) {
+            return WireDecodeStatus::InvalidField;
+        }
+        (Field<I>::assign(*out, std::get<I>(wire)), ...);
+        return WireDecodeStatus::Ok;
+    }
+};
+
+// 读取消息类型字节，用于在多种消息之间分发；空数据返回0
+inline quint8 wireMessageType(const char *data, qint64 size) {
+    return size > 0 ? static_cast<quint8>(data[0]) : 0;
+}
+
+#endif // WIRE_CODEC_H
@@ -0,0 +1,260 @@
+/**
+ * @file wire_codec_benchmark.cpp
+ * @brief WireLayout定长编解码与手写QDataStream序列化的单核吞吐量对比
+ *
+ * 对StatusReply和SelfcheckReply分别测量：
+ *   wire                 WireLayout::appendTo写入复用的批缓冲区 / 按消息长度顺序解码
+ *   qdatastream-batch    一个QDataStream连续写入复用的批缓冲区 / 一个流连续读出
+ *   qdatastream-per-msg  每条消息一个QByteArray + QDataStream（常见写法）/ 每条消息一个只读流
+ * 输入是固定种子生成的4096条不同消息，循环使用直到达到消息数；
+ * 解码结果累加为校验和并打印，避免被编译器优化掉，也用于核对各实现解出的值一致。
+ *
+ * 用法: wire_codec_benchmark [消息数=5000000]
+ */
+
+#include <QBuffer>
+#include <QByteArray>
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "downlink_messages.h"
+
+// ===== 手写QDataStream序列化（对照组）=====
+
+static QDataStream &operator<<(QDataStream &out, const StatusReply &status) {
+    return out << qint32(status.workMode) << qint32(status.loadPosition) << status.workStatus;
+}
+
+static QDataStream &operator>>(QDataStream &in, StatusReply &status) {
+    qint32 workMode = 0;
+    qint32 loadPosition = 0;
+    in >> workMode >> loadPosition >> status.workStatus;
+    status.workMode = workMode;
+    status.loadPosition = loadPosition;
+    return in;
+}
+
+static QDataStream &operator<<(QDataStream &out, const SelfcheckReply &selfcheck) {
+    return out << qint32(selfcheck.channelState) << qint32(selfcheck.freqConvState)
+               << qint32(selfcheck.mainCtrlState) << qint32(selfcheck.powerState) << qint32(selfcheck.timeState);
+}
+
+static QDataStream &operator>>(QDataStream &in, SelfcheckReply &selfcheck) {
+    qint32 values[5] = {};
+    in >> values[0] >> values[1] >> values[2] >> values[3] >> values[4];
+    selfcheck.channelState = values[0];
+    selfcheck.freqConvState = values[1];
+    selfcheck.mainCtrlState = values[2];
+    selfcheck.powerState = values[3];
+    selfcheck.timeState = values[4];
+    return in;
+}
+
+static qint64 checksum(const StatusReply &status) {
+    return qint64(status.workMode) * 31 + qint64(status.loadPosition) * 7 + status.workStatus;
+}
+
+static qint64 checksum(const SelfcheckReply &selfcheck) {
+    return qint64(selfcheck.channelState) + qint64(selfcheck.freqConvState) * 3 + qint64(selfcheck.mainCtrlState) * 5
+         + qint64(selfcheck.powerState) * 7 + qint64(selfcheck.timeState) * 11;
+}
+
+// ===== 输入 =====
+
+static const int kDistinctMessages = 4096;
+static const int kBatchMessages = 1024;     // 一次下行发送的消息数
+
+static std::vector<StatusReply> buildMessages(StatusReply *, QRandomGenerator &generator) {
+    std::vector<StatusReply> messages(kDistinctMessages);
+    for (StatusReply &status : messages) {
+        status.workMode = generator.bounded(0, 16);
+        status.loadPosition = static_cast<int>(generator.generate());
+        status.workStatus = generator.bounded(2) != 0;
+    }
+    return messages;
+}
+
+static std::vector<SelfcheckReply> buildMessages(SelfcheckReply *, QRandomGenerator &generator) {
+    std::vector<SelfcheckReply> messages(kDistinctMessages);
+    for (SelfcheckReply &selfcheck : messages) {
+        selfcheck.channelState = generator.bounded(0, 4);
+        selfcheck.freqConvState = generator.bounded(0, 4);
+        selfcheck.mainCtrlState = generator.bounded(0, 4);
+        selfcheck.powerState = static_cast<int>(generator.generate());
+        selfcheck.timeState = static_cast<int>(generator.generate());
+    }
+    return messages;
+}
+
+static void report(const char *message, const char *codec, const char *direction, qint64 count,
+                   qint64 bytes, qint64 elapsedNs, qint64 sum) {
+    const double seconds = elapsedNs / 1e9;
+    std::printf("%-15s %-20s %-7s %8.2f Mmsg/s  %7.1f MB/s  %6.1f ns/msg  (%lld bytes, checksum %lld)\n",
+                message, codec, direction, count / seconds / 1e6, bytes / seconds / 1e6,
+                static_cast<double>(elapsedNs) / count, static_cast<long long>(bytes),
+                static_cast<long long>(sum));
+}
+
+// ===== 各实现 =====
+
+template <typename Message, typename Wire>
+static void runWire(const char *name, const std::vector<Message> &messages, qint64 count) {
+    QByteArray batch;
+    batch.reserve(static_cast<int>(Wire::kSize) * kBatchMessages);
+    qint64 bytes = 0;
+    qint64 sum = 0;
+
+    QElapsedTimer timer;
+    timer.start();
+    for (qint64 i = 0; i < count;) {
+        batch.resize(0);
+        for (int j = 0; j < kBatchMessages && i < count; ++j, ++i) {
+            Wire::appendTo(batch, messages[static_cast<size_t>(i % kDistinctMessages)]);
+        }
+        bytes += batch.size();
+        sum += static_cast<uchar>(batch.at(batch.size() - 1));
+    }
+    report(name, "wire", "encode", count, bytes, timer.nsecsElapsed(), sum);
+
+    // 全部输入编码成一个流，循环解码
+    QByteArray stream;
+    for (const Message &message : messages) {
+        Wire::appendTo(stream, message);
+    }
+
+    bytes = 0;
+    sum = 0;
+    timer.start();
+    for (qint64 i = 0; i < count;) {
+        const char *data = stream.constData();
+        qint64 remaining = stream.size();
+        for (; remaining > 0 && i < count; ++i) {
+            Message message;
+            if (Wire::decode(data, remaining, &message) != WireDecodeStatus::Ok) {
+                std::printf("  !! %s message %lld rejected\n", name, static_cast<long long>(i));
+                return;
+            }
+            data += Wire::kSize;
+            remaining -= static_cast<qint64>(Wire::kSize);
+            sum += checksum(message);
+        }
+        bytes += stream.size() - remaining;
+    }
+    report(name, "wire", "decode", count, bytes, timer.nsecsElapsed(), sum);
+}
+
+template <typename Message>
+static void runDataStreamBatch(const char *name, const std::vector<Message> &messages, qint64 count) {
+    QByteArray batch;
+    QBuffer device(&batch);
+    device.open(QIODevice::WriteOnly);
+    QDataStream out(&device);
+    qint64 bytes = 0;
+    qint64 sum = 0;
+
+    QElapsedTimer timer;
+    timer.start();
+    for (qint64 i = 0; i < count;) {
+        device.seek(0);
+        batch.resize(0);
+        for (int j = 0; j < kBatchMessages && i < count; ++j, ++i) {
+            out << messages[static_cast<size_t>(i % kDistinctMessages)];
+        }
+        bytes += batch.size();
+        sum += static_cast<uchar>(batch.at(batch.size() - 1));
+    }
+    report(name, "qdatastream-batch", "encode", count, bytes, timer.nsecsElapsed(), sum);
+
+    QByteArray stream;
+    {
+        QDataStream encoder(&stream, QIODevice::WriteOnly);
+        for (const Message &message : messages) {
+            encoder << message;
+        }
+    }
+
+    bytes = 0;
+    sum = 0;
+    timer.start();
+    for (qint64 i = 0; i < count;) {
+        QDataStream in(stream);
+        for (; !in.atEnd() && i < count; ++i) {
+            Message message;
+            in >> message;
+            if (in.status() != QDataStream::Ok) {
+                std::printf("  !! %s message %lld rejected\n", name, static_cast<long long>(i));
+                return;
+            }
+            sum += checksum(message);
+        }
+        bytes += in.device()->pos();
+    }
+    report(name, "qdatastream-batch", "decode", count, bytes, timer.nsecsElapsed(), sum);
+}
+
+template <typename Message>
+static void runDataStreamPerMessage(const char *name, const std::vector<Message> &messages, qint64 count) {
+    qint64 bytes = 0;
+    qint64 sum = 0;
+
+    QElapsedTimer timer;
+    timer.start();
+    for (qint64 i = 0; i < count; ++i) {
+        QByteArray data;
+        QDataStream out(&data, QIODevice::WriteOnly);
+        out << messages[static_cast<size_t>(i % kDistinctMessages)];
+        bytes += data.size();
+        sum += static_cast<uchar>(data.at(data.size() - 1));
+    }
+    report(name, "qdatastream-per-msg", "encode", count, bytes, timer.nsecsElapsed(), sum);
+
+    std::vector<QByteArray> encoded;
+    encoded.reserve(messages.size());
+    for (const Message &message : messages) {
+        QByteArray data;
+        QDataStream out(&data, QIODevice::WriteOnly);
+        out << message;
+        encoded.push_back(data);
+    }
+
+    bytes = 0;
+    sum = 0;
+    timer.start();
+    for (qint64 i = 0; i < count; ++i) {
+        const QByteArray &data = encoded[static_cast<size_t>(i % kDistinctMessages)];
+        QDataStream in(QByteArray::fromRawData(data.constData(), data.size()));
+        Message message;
+        in >> message;
+        if (in.status() != QDataStream::Ok) {
+            continue;
+        }
+        bytes += data.size();
+        sum += checksum(message);
+    }
+    report(name, "qdatastream-per-msg", "decode", count, bytes, timer.nsecsElapsed(), sum);
+}
+
+template <typename Message, typename Wire>
+static void runAll(const char *name, qint64 count) {
+    QRandomGenerator generator(42);
+    const std::vector<Message> messages = buildMessages(static_cast<Message *>(nullptr), generator);
+    runWire<Message, Wire>(name, messages, count);
+    runDataStreamBatch(name, messages, count);
+    runDataStreamPerMessage(name, messages, count);
+}
+
+int main(int argc, char *argv[]) {
+    const qint64 count = argc > 1 ? std::atoll(argv[1]) : 5000000;
+
+    std::printf("Wire codec benchmark: %lld messages per run, single core\n", static_cast<long long>(count));
+    std::printf("StatusReply wire size %d bytes, SelfcheckReply wire size %d bytes (1 byte type tag included)\n",
+                static_cast<int>(StatusReplyWire::kSize), static_cast<int>(SelfcheckReplyWire::kSize));
+
+    runAll<StatusReply, StatusReplyWire>("StatusReply", count);
+    runAll<SelfcheckReply, SelfcheckReplyWire>("SelfcheckReply", count);
+    return 0;
+}
@@ -0,0 +1,408 @@
+/**
+ * @file work_stealing_pool.h
+ * @brief 工作窃取线程池、每客户端串行队列与批量结果回送
+ *
+ * WorkStealingPool   每个工作线程一个双端队列：自己从队尾取（LIFO，缓存热），
+ *                    空闲时从其他线程的队首窃取（FIFO，先窃取最老的任务）。
+ *                    外部线程提交的任务轮流放入各线程的队列。
+ * SerialQueue        挂在线程池上的串行队列：同一队列中的任务按提交顺序、一次一个执行，
+ *                    不同队列并行执行。每个客户端一个队列即可保证该客户端消息的FIFO顺序，
+ *                    并且队列内的状态（如帧解码器）不需要加锁。任务是调用方复用的侵入式节点，
+ *                    提交和调度都不分配内存。
+ * ResultBatcher<T>   任意线程产生的结果先攒在一起，空→非空时向owner所在线程投递一次排队调用，
+ *                    owner一次取走整批，而不是每条结果一个事件。
+ */
+
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <QMetaObject>
+#include <QObject>
+#include <QPointer>
+#include <QtGlobal>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+struct WorkStealingPoolStats {
+    quint64 submitted = 0;
+    quint64 executed = 0;
+    quint64 stolen = 0;         // 从其他线程队列窃取执行的任务
+};
+
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+    // threadCount为0时使用全部核心
+    explicit WorkStealingPool(int threadCount = 0) {
+        if (threadCount <= 0) {
+            threadCount = qMax(1, static_cast<int>(std::thread::hardware_concurrency()));
+        }
+        m_workers.reserve(static_cast<size_t>(threadCount));
+        for (int i = 0; i < threadCount; ++i) {
+            m_workers.emplace_back(new Worker());
+        }
+        for (int i = 0; i < threadCount; ++i) {
+            m_workers[static_cast<size_t>(i)]->thread = std::thread([this, i]() { run(i); });
+        }
+    }
+
+    // 执行完已提交的任务后再退出
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            m_stopping = true;
+        }
+        m_wake.notify_all();
+        for (const std::unique_ptr<Worker> &worker : m_workers) {
+            worker->thread.join();
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+    int threadCount() const { return static_cast<int>(m_workers.size()); }
+
+    // 任意线程调用；工作线程中提交的任务进入自己的队列
+    void submit(Task task) {
+        size_t index;
+        if (t_currentPool == this) {
+            index = static_cast<size_t>(t_workerIndex);
+        } else {
+            index = m_nextWorker.fetch_add(1, std::memory_order_relaxed) % m_workers.size();
+        }
+
+        Worker &worker = *m_workers[index];
+        {
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            worker.tasks.pushBack(std::move(task));
+        }
+        m_submitted.fetch_add(1, std::memory_order_relaxed);
+
+        // 与run()中的sleepers/queued配对：要么工作线程看到新任务，要么这里看到有线程在睡眠
+        m_queued.fetch_add(1, std::memory_order_seq_cst);
+        if (m_sleepers.load(std::memory_order_seq_cst) > 0) {
+            { std::lock_guard<std::mutex> lock(m_sleepMutex); }
+            m_wake.notify_one();
+        }
+    }
+
+    WorkStealingPoolStats stats() const {
+        WorkStealingPoolStats stats;
+        stats.submitted = m_submitted.load(std::memory_order_relaxed);
+        stats.executed = m_executed.load(std::memory_order_relaxed);
+        stats.stolen = m_stolen.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+private:
+    // 容量只增不减的环形缓冲区：std::deque在本地出队和窃取跨越块边界时会反复释放、申请块，
+    // 这里稳态入队出队不分配。调用方持有Worker::mutex
+    class TaskRing {
+    public:
+        bool empty() const { return m_count == 0; }
+
+        void pushBack(Task &&task) {
+            if (m_count == m_slots.size()) {
+                grow();
+            }
+            m_slots[(m_head + m_count) % m_slots.size()] = std::move(task);
+            ++m_count;
+        }
+
+        Task popBack() {
+            --m_count;
+            return take((m_head + m_count) % m_slots.size());
+        }
+
+        Task popFront() {
+            const size_t index = m_head;
+            m_head = (m_head + 1) % m_slots.size();
+            --m_count;
+            return take(index);
+        }
+
+    private:
+        Task take(size_t index) {
+            Task task = std::move(m_slots[index]);
+            m_slots[index] = nullptr;       // 立即释放任务捕获的对象
+            return task;
+        }
+
+        void grow() {
+            std::vector<Task> slots(qMax<size_t>(16, m_slots.size() * 2));
+            for (size_t i = 0; i < m_count; ++i) {
+                slots[i] = std::move(m_slots[(m_head + i) % m_slots.size()]);
+            }
+            m_slots.swap(slots);
+            m_head = 0;
+        }
+
+        std::vector<Task> m_slots;
+        size_t m_head = 0;
+        size_t m_count = 0;
+    };
+
+    struct alignas(64) Worker {
+        std::mutex mutex;
+        TaskRing tasks;
+        std::thread thread;
+    };
+
+    bool popLocal(int index, Task *task) {
+        Worker &worker = *m_workers[static_cast<size_t>(index)];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (worker.tasks.empty()) {
+            return false;
+        }
+        *task = worker.tasks.popBack();
+        return true;
+    }
+
+    bool steal(int thief, Task *task) {
+        const int count = threadCount();
+        for (int offset = 1; offset < count; ++offset) {
+            Worker &victim = *m_workers[static_cast<size_t>((thief + offset) % count)];
+            // 不等待正在被操作的队列，换下一个
+            std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+            if (!lock.owns_lock() || victim.tasks.empty()) {
+                continue;
+            }
+            *task = victim.tasks.popFront();
+            m_stolen.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    void run(int index) {
+        t_currentPool = this;
+        t_workerIndex = index;
+
+        for (;;) {
+            Task task;
+            if (popLocal(index, &task) || steal(index, &task)) {
+                m_queued.fetch_sub(1, std::memory_order_relaxed);
+                task();
+                m_executed.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(m_sleepMutex);
+            m_sleepers.fetch_add(1, std::memory_order_seq_cst);
+            // try_to_lock窃取可能跳过了有任务的队列：只要还有积压就不睡眠，重新扫描
+            m_wake.wait(lock, [this]() {
+                return m_stopping || m_queued.load(std::memory_order_seq_cst) > 0;
+            });
+            m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+            if (m_stopping && m_queued.load(std::memory_order_relaxed) == 0) {
+                return;
+            }
+        }
+    }
+
+    static thread_local WorkStealingPool *t_currentPool;
+    static thread_local int t_workerIndex;
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::atomic<size_t> m_nextWorker{0};
+
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wake;
+    std::atomic<qint64> m_queued{0};        // 已提交未取出的任务数
+    std::atomic<int> m_sleepers{0};
+    bool m_stopping = false;                // 由m_sleepMutex保护
+
+    std::atomic<quint64> m_submitted{0};
+    std::atomic<quint64> m_executed{0};
+    std::atomic<quint64> m_stolen{0};
+};
+
+inline thread_local WorkStealingPool *WorkStealingPool::t_currentPool = nullptr;
+inline thread_local int WorkStealingPool::t_workerIndex = -1;
+
+/**
+ * @brief 线程池上的串行执行上下文
+ *
+ * 只有在队列从空变为非空时才向线程池提交一个排空任务；排空任务每次最多执行
+ * maxBatch个任务后重新提交自己，长队列不会独占一个工作线程。
+ * 必须以std::shared_ptr持有：有排空任务在线程池中时队列持有自己的引用，可以比创建者活得久。
+ *
+ * 任务是侵入式节点，由调用方分配并循环使用，post(Node *)只链接指针；
+ * 排空任务只捕获裸指针，std::function内联存放，同样不分配。
+ */
+class SerialQueue : public std::enable_shared_from_this<SerialQueue> {
+public:
+    using Task = WorkStealingPool::Task;
+
+    // 节点从post()到run()开始归队列所有；run()中可以把节点交还给它的所有者再次提交
+    struct Node {
+        virtual ~Node() = default;
+        virtual void run() = 0;
+        Node *next = nullptr;
+    };
+
+    explicit SerialQueue(WorkStealingPool *pool, int maxBatch = 64)
+        : m_pool(pool)
+        , m_maxBatch(maxBatch) {}
+
+    void post(Node *node) {
+        node->next = nullptr;
+        bool schedule = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_tail) {
+                m_tail->next = node;
+            } else {
+                m_head = node;
+            }
+            m_tail = node;
+            ++m_pending;
+            if (!m_scheduled) {
+                m_scheduled = true;
+                m_keepAlive = shared_from_this();
+                schedule = true;
+            }
+        }
+        if (schedule) {
+            scheduleDrain();
+        }
+    }
+
+    // 不在热路径上的任务：为task分配一个节点，执行后释放
+    void post(Task task) {
+        post(new FunctionNode(std::move(task)));
+    }
+
+    size_t pending() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_pending;
+    }
+
+private:
+    struct FunctionNode : Node {
+        explicit FunctionNode(Task function) : task(std::move(function)) {}
+        void run() override {
+            task();
+            delete this;
+        }
+        Task task;
+    };
+
+    void scheduleDrain() {
+        SerialQueue *self = this;
+        m_pool->submit([self]() { self->drain(); });
+    }
+
+    void drain() {
+        for (int i = 0; i < m_maxBatch; ++i) {
+            Node *node;
+            {
+                // keepAlive在解锁之后析构：最后一个引用释放时队列销毁，不能再碰m_mutex
+                std::shared_ptr<SerialQueue> keepAlive;
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (!m_head) {
+                    m_scheduled = false;
+                    keepAlive.swap(m_keepAlive);
+                    return;
+                }
+                node = m_head;
+                m_head = node->next;
+                if (!m_head) {
+                    m_tail = nullptr;
+                }
+                --m_pending;
+            }
+            node->run();
+        }
+
+        // 还有任务：让出工作线程，排到线程池队列后面
+        scheduleDrain();
+    }
+
+    WorkStealingPool *m_pool;
+    const int m_maxBatch;
+    mutable std::mutex m_mutex;
+    Node *m_head = nullptr;         // 以下由m_mutex保护
+    Node *m_tail = nullptr;
+    size_t m_pending = 0;
+    bool m_scheduled = false;       // 已有排空任务在线程池中（排队或正在执行）
+    std::shared_ptr<SerialQueue> m_keepAlive;   // m_scheduled期间持有自己
+};
+
+/**
+ * @brief 把工作线程产生的结果按批送回owner所在线程
+ *
+ * deliver在owner线程中调用，参数是自上次投递以来的全部结果。
+ * 以std::shared_ptr持有，工作线程中的任务可以安全地比owner活得久。
+ * owner应在析构函数中调用cancel()，之后push()直接丢弃结果；已投递未执行的调用随owner被Qt移除。
+ * m_owner是QPointer，忘记cancel()时owner销毁之后的push()同样被丢弃，
+ * 但与销毁同时发生的push()只有cancel()能排除。
+ */
+template <typename T>
+class ResultBatcher : public std::enable_shared_from_this<ResultBatcher<T>> {
+public:
+    using Deliver = std::function<void(std::vector<T> &batch)>;
+
+    ResultBatcher(QObject *owner, Deliver deliver)
+        : m_owner(owner)
+        , m_deliver(std::move(deliver)) {}
+
+    // 任意线程调用
+    // ❌ 原来：m_owner是裸指针，owner销毁后invokeMethod访问悬空对象
+    // ✅ 现在：检查owner和投递都在m_mutex内，与cancel()互斥，owner一旦取消就不会再被访问
+    void push(T value) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_owner.isNull()) {
+            return;
+        }
+        const bool wake = m_pending.empty();
+        m_pending.push_back(std::move(value));
+        if (wake) {
+            std::shared_ptr<ResultBatcher> self = this->shared_from_this();
+            QMetaObject::invokeMethod(m_owner.data(), [self]() { self->deliverPending(); }, Qt::QueuedConnection);
+        }
+    }
+
+    // 在owner线程中调用（通常是owner的析构函数），返回后不再投递，未送出的结果丢弃
+    void cancel() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_owner = nullptr;
+        m_pending.clear();
+    }
+
+    quint64 batches() const { return m_batches.load(std::memory_order_relaxed); }
+    quint64 delivered() const { return m_delivered.load(std::memory_order_relaxed); }
+
+private:
+    void deliverPending() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_owner.isNull()) {
+                return;
+            }
+            m_batch.swap(m_pending);        // 两个vector交替使用，稳态不重新分配
+        }
+        m_batches.fetch_add(1, std::memory_order_relaxed);
+        m_delivered.fetch_add(m_batch.size(), std::memory_order_relaxed);
+        m_deliver(m_batch);
+        m_batch.clear();
+    }
+
+    QPointer<QObject> m_owner;      // 由m_mutex保护
+    Deliver m_deliver;
+    std::mutex m_mutex;
+    std::vector<T> m_pending;       // 由m_mutex保护
+    std::vector<T> m_batch;         // 只在owner线程中使用
+    std::atomic<quint64> m_batches{0};
+    std::atomic<quint64> m_delivered{0};
+};
+
+#endif // WORK_STEALING_POOL_H
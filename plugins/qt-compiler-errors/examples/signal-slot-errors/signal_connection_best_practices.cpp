@@ -9,20 +9,15 @@
 #include <QThread>
 #include <memory>
 
-// ===== 数据结构定义 =====
-struct StatusReply {
-    int workMode = 0;
-    int loadPosition = 0;
-    bool workStatus = false;
-};
+#include "../network-performance/channel.h"
+#include "../network-performance/coalescing_connection.h"
+#include "../network-performance/copy_trace.h"
+#include "../network-performance/downlink_messages.h"
+#include "../network-performance/shm_transport.h"
+#include "../network-performance/thread_placement.h"
 
-struct SelfcheckReply {
-    int channelState = 0;
-    int freqConvState = 0;
-    int mainCtrlState = 0;
-    int powerState = 0;
-    int timeState = 0;
-};
+// ===== 数据结构定义 =====
+// StatusReply/SelfcheckReply及其下行线上格式（StatusReplyWire/SelfcheckReplyWire）见downlink_messages.h
 
 // ===== 正确的发送者类实现 =====
 class ServiceFacade : public QObject
@@ -47,7 +42,8 @@ public:
 
 signals:
     // ✅ 明确的信号定义，参数类型清晰
-    void statusReplyReady(const StatusReply &status);
+    // Traced<T>统计每次emit的复制/移动次数（NETDEBUG_TRACE_COPIES调试构建），否则就是StatusReply
+    void statusReplyReady(const Traced<StatusReply> &status);
     void selfcheckReplyReady(const SelfcheckReply &selfcheck);
 
 public slots:
@@ -56,7 +52,7 @@ public slots:
 
         // ✅ 更新状态并立即发送信号
         m_status.workMode = mode;
-        emit statusReplyReady(m_status);
+        emit statusReplyReady(NETDEBUG_TRACED(m_status, "ServiceFacade::statusReplyReady"));
         emit selfcheckReplyReady(m_selfcheck);
     }
 
@@ -91,7 +87,9 @@ public:
 
 public slots:
     // ✅ 避免重载，使用明确的函数名
-    void slot_UpdateStatus(const StatusReply &data) {
+    void slot_UpdateStatus(const Traced<StatusReply> &status) {
+        NETDEBUG_TRACE_DELIVERY(status, "ProtocolParser::slot_UpdateStatus");
+        const StatusReply &data = tracedValue(status);
         qDebug() << "Status update received - workMode:" << data.workMode;
 
         // ✅ 直接赋值，避免未定义行为
@@ -203,25 +201,46 @@ public:
 
         // 将接收者移动到不同线程
         m_receiverThread = new QThread();
+        m_receiverThread->setObjectName("receiver");
         m_receiver->moveToThread(m_receiverThread);
-
-        // ✅ 跨线程连接使用Qt::QueuedConnection
-        connect(m_sender, &ServiceFacade::statusReplyReady,
-                m_receiver, &ProtocolParser::slot_UpdateStatus,
-                Qt::QueuedConnection);
-
-        connect(m_sender, &ServiceFacade::selfcheckReplyReady,
-                m_receiver, &ProtocolParser::slot_UpdateSelfcheck,
-                Qt::QueuedConnection);
+        // 按名称"receiver"应用线程放置配置（见thread_placement.h）
+        ThreadPlacement::instance().attach(m_receiverThread, "receiver");
+
+        // ❌ 原来：statusReplyReady也用Qt::QueuedConnection，每次emit一个事件和一份拷贝，
+        //    kHz状态频率下接收线程处理的大多是已经过期的值
+        // ✅ 状态只关心最新值：合并连接覆盖未送达的旧值，每个事件循环周期最多一次唤醒
+        m_statusMailbox = connectCoalesced(m_sender, &ServiceFacade::statusReplyReady,
+                                           m_receiver, &ProtocolParser::slot_UpdateStatus);
+
+        // ✅ 每条自检结果都需要处理：用SPSC通道代替Qt::QueuedConnection，
+        //    消息按值写入环形缓冲区，不注册元类型、不为每条消息分配事件，接收线程按批排空；
+        //    接收线程跟不上时环会满，自检结果不能丢，用Spill转入溢出队列而不是丢弃
+        m_selfcheckChannel = connectChannel(m_sender, &ServiceFacade::selfcheckReplyReady,
+                                            m_receiver, &ProtocolParser::slot_UpdateSelfcheck,
+                                            1024, ChannelOverflow::Spill);
 
         m_receiverThread->start();
 
-        qDebug() << "🧵 Cross-thread connection established with Qt::QueuedConnection";
+        qDebug() << "🧵 Cross-thread connections established: status coalesced, selfcheck via lossless channel";
     }
 
     ~ThreadedConnection() {
         m_receiverThread->quit();
         m_receiverThread->wait();
+
+        const CoalescingStats stats = m_statusMailbox->stats();
+        qDebug() << "📊 StatusReply coalescing - published:" << stats.published
+                 << "delivered:" << stats.delivered
+                 << "superseded:" << stats.superseded
+                 << "wakeups:" << stats.wakeups;
+
+        const ChannelStats channelStats = m_selfcheckChannel->stats();
+        qDebug() << "📊 SelfcheckReply channel - pushed:" << channelStats.pushed
+                 << "delivered:" << channelStats.delivered
+                 << "spilled:" << channelStats.spilled
+                 << "wakeups:" << channelStats.wakeups
+                 << "max batch:" << channelStats.maxBatch;
+
         delete m_receiverThread;
         delete m_sender;
         delete m_receiver;
@@ -231,7 +250,96 @@ private:
     ServiceFacade* m_sender;
     ProtocolParser* m_receiver;
     QThread* m_receiverThread;
+    std::shared_ptr<LatestValueMailbox<Traced<StatusReply>>> m_statusMailbox;
+    std::unique_ptr<Channel<SelfcheckReply>> m_selfcheckChannel;   // 在sender/receiver之后销毁
+};
+
+#ifdef NETDEBUG_HAVE_SHM_TRANSPORT
+// ===== 同机跨进程连接示例 =====
+// ❌ 原来：界面进程经示例服务器的TCP往返取得StatusReply/SelfcheckReply
+// ✅ 同一台机器上的两个进程通过共享内存环传递定长消息（见shm_transport.h），
+//    接收端的槽函数与进程内连接完全相同
+
+// 采集进程：ServiceFacade的信号直接写入共享内存环
+class CrossProcessPublisher
+{
+public:
+    explicit CrossProcessPublisher(ServiceFacade *facade) {
+        QString error;
+        if (!m_publisher.listen("netdebug-downlink", &error)) {
+            qWarning() << "[WARNING] 共享内存发布端启动失败:" << error;
+            return;
+        }
+        // ✅ 直接连接：在emit的线程中编码并写入环，不经过事件队列
+        connectShmPublisher<StatusReplyWire>(facade, &ServiceFacade::statusReplyReady, &m_publisher);
+        // ❌ 原来：自检结果与状态一样在环满时丢弃
+        // ✅ 现在：与进程内的自检通道一致，环满时留在发布端积压队列中按顺序补写
+        connectShmPublisher<SelfcheckReplyWire>(facade, &ServiceFacade::selfcheckReplyReady, &m_publisher,
+                                                ShmOverflow::Spill);
+    }
+
+    ~CrossProcessPublisher() {
+        const ShmTransportStats &stats = m_publisher.stats();
+        qDebug() << "📊 Cross-process publisher - published:" << stats.published
+                 << "dropped:" << stats.dropped
+                 << "spilled:" << stats.spilled
+                 << "spill dropped:" << stats.spillDropped
+                 << "backlog:" << m_publisher.backlog()
+                 << "wakeups:" << stats.wakeups;
+    }
+
+private:
+    ShmPublisher m_publisher;
+};
+
+// 界面进程：按消息类型注册处理函数，在本线程的事件循环中排空
+class CrossProcessReceiver
+{
+public:
+    explicit CrossProcessReceiver(ProtocolParser *parser) {
+        m_subscriber.on<StatusReplyWire>([parser](const StatusReply &status) {
+            parser->slot_UpdateStatus(NETDEBUG_TRACED(status, "CrossProcessReceiver::StatusReply"));
+        });
+        m_subscriber.on<SelfcheckReplyWire>([parser](const SelfcheckReply &selfcheck) {
+            parser->slot_UpdateSelfcheck(selfcheck);
+        });
+        // ✅ 采集进程退出后定时重连，而不是让界面停在旧数据上
+        m_subscriber.onDisconnected([this]() {
+            qWarning() << "[WARNING] 采集进程已断开，1秒后重连";
+            m_reconnectTimer.start();
+        });
+        // ✅ connectTo()不阻塞界面线程，握手失败或超时从这里重连
+        m_subscriber.onConnectFailed([this](const QString &error) {
+            qWarning() << "[WARNING] 与采集进程握手失败:" << error;
+            m_reconnectTimer.start();
+        });
+        m_reconnectTimer.setInterval(1000);
+        m_reconnectTimer.setSingleShot(true);
+        QObject::connect(&m_reconnectTimer, &QTimer::timeout, [this]() { connectToPublisher(); });
+        connectToPublisher();
+    }
+
+    ~CrossProcessReceiver() {
+        const ShmTransportStats stats = m_subscriber.stats();
+        qDebug() << "📊 Cross-process receiver - delivered:" << stats.delivered
+                 << "dropped:" << stats.dropped
+                 << "invalid:" << stats.invalid
+                 << "max batch:" << stats.maxBatch;
+    }
+
+private:
+    void connectToPublisher() {
+        QString error;
+        if (!m_subscriber.connectTo("netdebug-downlink", &error)) {
+            qWarning() << "[WARNING] 连接采集进程失败:" << error;
+            m_reconnectTimer.start();
+        }
+    }
+
+    ShmSubscriber m_subscriber;
+    QTimer m_reconnectTimer;      // 在m_subscriber之前销毁
 };
+#endif // NETDEBUG_HAVE_SHM_TRANSPORT
 
 // ===== 错误示例对比 =====
 class BadExample : public QObject
@@ -300,7 +408,9 @@ private:
  2. 避免槽函数重载，使用明确的函数名
  3. 验证信号连接状态
  4. 实现重试机制处理初始化时机问题
- 5. 跨线程连接使用Qt::QueuedConnection
+ 5. 跨线程连接使用Qt::QueuedConnection；只关心最新值的高频状态使用connectCoalesced()，
+    高频POD消息使用connectChannel()（不能丢的消息用ChannelOverflow::Spill）；
+    同机跨进程使用共享内存环（connectShmPublisher/ShmSubscriber）
  6. 管理对象生命周期
  7. 使用调试宏验证连接和初始化
 
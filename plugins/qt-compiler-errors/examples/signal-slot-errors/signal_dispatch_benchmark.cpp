@@ -0,0 +1,347 @@
+/**
+ * @file signal_dispatch_benchmark.cpp
+ * @brief 信号槽分发开销基准：参数签名 × 连接方式
+ *
+ * 覆盖parameter_mismatch.cpp中ParameterMatchingExample使用的签名
+ * （int / const int& / QString值传递 / const QString& / QByteArray值传递 / const QByteArray&），
+ * 对每种签名分别测量五种连接方式：
+ *   direct           同线程成员函数槽，Qt::DirectConnection
+ *   queued           接收者在另一线程，Qt::QueuedConnection
+ *   blocking-queued  接收者在另一线程，Qt::BlockingQueuedConnection（一次往返）
+ *   lambda           同线程lambda槽
+ *   functor          同线程函数对象槽
+ *
+ * 每行结果包含：发送端每次emit耗时、端到端吞吐量、每次调用的堆分配次数（全局operator new计数，
+ * 包括接收线程）、每次调用的参数复制/移动次数。复制次数由与该签名形状相同（值传递或const引用）
+ * 的CopyProbe类型在同一连接方式下测得；QString/QByteArray按值复制只增加引用计数，不复制数据块。
+ *
+ * 用法: signal_dispatch_benchmark [--iterations=200000] [--output=result.json]
+ */
+
+#include <QByteArray>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMetaType>
+#include <QObject>
+#include <QString>
+#include <QThread>
+#include <QtGlobal>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+
+// ===== 堆分配计数 =====
+
+static std::atomic<quint64> g_allocations{0};
+
+void *operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+// ===== 参数复制计数 =====
+
+struct CopyProbe {
+    static std::atomic<quint64> copies;
+    static std::atomic<quint64> moves;
+
+    CopyProbe() = default;
+    CopyProbe(const CopyProbe &) { copies.fetch_add(1, std::memory_order_relaxed); }
+    CopyProbe(CopyProbe &&) noexcept { moves.fetch_add(1, std::memory_order_relaxed); }
+    CopyProbe &operator=(const CopyProbe &) {
+        copies.fetch_add(1, std::memory_order_relaxed);
+        return *this;
+    }
+    CopyProbe &operator=(CopyProbe &&) noexcept {
+        moves.fetch_add(1, std::memory_order_relaxed);
+        return *this;
+    }
+};
+Q_DECLARE_METATYPE(CopyProbe)
+
+std::atomic<quint64> CopyProbe::copies{0};
+std::atomic<quint64> CopyProbe::moves{0};
+
+// ===== 发送者和接收者 =====
+
+class DispatchSender : public QObject {
+    Q_OBJECT
+
+signals:
+    void signalInt(int value);
+    void signalIntConstRef(const int &value);
+    void signalString(QString text);
+    void signalStringConstRef(const QString &text);
+    void signalByteArray(QByteArray data);
+    void signalByteArrayConstRef(const QByteArray &data);
+    void signalProbe(CopyProbe probe);
+    void signalProbeConstRef(const CopyProbe &probe);
+};
+
+class DispatchReceiver : public QObject {
+    Q_OBJECT
+
+public:
+    // 槽、lambda和函数对象都调用consume()，处理内容完全相同
+    void consume(int value) { m_sink += value; countReceived(); }
+    void consume(const QString &text) { m_sink += text.size(); countReceived(); }
+    void consume(const QByteArray &data) { m_sink += data.size(); countReceived(); }
+    void consume(const CopyProbe &) { countReceived(); }
+
+    void resetReceived() { m_received.store(0, std::memory_order_relaxed); }
+    quint64 received() const { return m_received.load(std::memory_order_acquire); }
+
+public slots:
+    void slotInt(int value) { consume(value); }
+    void slotIntConstRef(const int &value) { consume(value); }
+    void slotString(QString text) { consume(text); }
+    void slotStringConstRef(const QString &text) { consume(text); }
+    void slotByteArray(QByteArray data) { consume(data); }
+    void slotByteArrayConstRef(const QByteArray &data) { consume(data); }
+    void slotProbe(CopyProbe probe) { consume(probe); }
+    void slotProbeConstRef(const CopyProbe &probe) { consume(probe); }
+
+private:
+    void countReceived() {
+        m_received.store(m_received.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    qint64 m_sink = 0;
+    std::atomic<quint64> m_received{0};
+};
+
+enum class ConnectionKind {
+    Direct,
+    Queued,
+    BlockingQueued,
+    Lambda,
+    Functor
+};
+
+static const char *connectionName(ConnectionKind kind) {
+    switch (kind) {
+    case ConnectionKind::Direct:         return "direct";
+    case ConnectionKind::Queued:         return "queued";
+    case ConnectionKind::BlockingQueued: return "blocking-queued";
+    case ConnectionKind::Lambda:         return "lambda";
+    case ConnectionKind::Functor:        return "functor";
+    }
+    return "unknown";
+}
+
+template <typename Arg>
+struct DispatchFunctor {
+    DispatchReceiver *receiver;
+    void operator()(Arg value) const { receiver->consume(value); }
+};
+
+struct BenchEnvironment {
+    DispatchSender *sender;
+    DispatchReceiver *localReceiver;     // 与发送者同一线程
+    DispatchReceiver *remoteReceiver;    // 在工作线程中
+};
+
+struct CaseResult {
+    qint64 iterations = 0;
+    double emitNsPerCall = 0;
+    double callsPerSecond = 0;
+    double allocationsPerCall = 0;
+    double copiesPerCall = 0;
+    double movesPerCall = 0;
+};
+
+template <typename Arg>
+static CaseResult runCase(BenchEnvironment &env, ConnectionKind kind,
+                          void (DispatchSender::*signal)(Arg), void (DispatchReceiver::*slot)(Arg),
+                          const typename std::decay<Arg>::type &argument, qint64 iterations) {
+    const bool remote = kind == ConnectionKind::Queued || kind == ConnectionKind::BlockingQueued;
+    DispatchReceiver *receiver = remote ? env.remoteReceiver : env.localReceiver;
+
+    QMetaObject::Connection connection;
+    switch (kind) {
+    case ConnectionKind::Direct:
+        connection = QObject::connect(env.sender, signal, receiver, slot, Qt::DirectConnection);
+        break;
+    case ConnectionKind::Queued:
+        connection = QObject::connect(env.sender, signal, receiver, slot, Qt::QueuedConnection);
+        break;
+    case ConnectionKind::BlockingQueued:
+        connection = QObject::connect(env.sender, signal, receiver, slot, Qt::BlockingQueuedConnection);
+        break;
+    case ConnectionKind::Lambda:
+        connection = QObject::connect(env.sender, signal, receiver,
+                                      [receiver](Arg value) { receiver->consume(value); });
+        break;
+    case ConnectionKind::Functor:
+        connection = QObject::connect(env.sender, signal, receiver, DispatchFunctor<Arg>{receiver});
+        break;
+    }
+
+    receiver->resetReceived();
+    CopyProbe::copies.store(0, std::memory_order_relaxed);
+    CopyProbe::moves.store(0, std::memory_order_relaxed);
+    const quint64 allocationsBefore = g_allocations.load(std::memory_order_relaxed);
+
+    QElapsedTimer timer;
+    timer.start();
+    for (qint64 i = 0; i < iterations; ++i) {
+        (env.sender->*signal)(argument);
+    }
+    const qint64 emitNs = timer.nsecsElapsed();
+
+    // 排队连接：等待接收线程处理完所有事件（事件对象在接收线程中释放）
+    while (receiver->received() < static_cast<quint64>(iterations)) {
+        QThread::yieldCurrentThread();
+    }
+    const qint64 totalNs = timer.nsecsElapsed();
+
+    CaseResult result;
+    result.iterations = iterations;
+    result.emitNsPerCall = static_cast<double>(emitNs) / iterations;
+    result.callsPerSecond = iterations / (totalNs / 1e9);
+    result.allocationsPerCall =
+        static_cast<double>(g_allocations.load(std::memory_order_relaxed) - allocationsBefore) / iterations;
+    result.copiesPerCall = static_cast<double>(CopyProbe::copies.load(std::memory_order_relaxed)) / iterations;
+    result.movesPerCall = static_cast<double>(CopyProbe::moves.load(std::memory_order_relaxed)) / iterations;
+
+    QObject::disconnect(connection);
+    return result;
+}
+
+// 一种签名在一种连接方式下：实际类型测耗时和分配，同形状的CopyProbe测复制次数
+template <typename Arg, typename ProbeArg>
+static QJsonObject measure(BenchEnvironment &env, const char *signature, ConnectionKind kind,
+                           void (DispatchSender::*signal)(Arg), void (DispatchReceiver::*slot)(Arg),
+                           const typename std::decay<Arg>::type &argument,
+                           void (DispatchSender::*probeSignal)(ProbeArg),
+                           void (DispatchReceiver::*probeSlot)(ProbeArg), qint64 iterations) {
+    // 阻塞连接每次都是一次线程往返，减少次数
+    if (kind == ConnectionKind::BlockingQueued) {
+        iterations = qMax<qint64>(iterations / 10, 1000);
+    }
+
+    // 预热：让分配器、连接表和接收线程进入稳态
+    runCase(env, kind, signal, slot, argument, qMax<qint64>(iterations / 10, 100));
+
+    const CaseResult timing = runCase(env, kind, signal, slot, argument, iterations);
+    const CaseResult copies = runCase(env, kind, probeSignal, probeSlot, CopyProbe(), iterations);
+
+    QJsonObject row;
+    row["signature"] = signature;
+    row["connection"] = connectionName(kind);
+    row["iterations"] = timing.iterations;
+    row["emit_ns_per_call"] = timing.emitNsPerCall;
+    row["calls_per_s"] = timing.callsPerSecond;
+    row["allocations_per_call"] = timing.allocationsPerCall;
+    row["copies_per_call"] = copies.copiesPerCall;
+    row["moves_per_call"] = copies.movesPerCall;
+
+    std::fprintf(stderr, "%-20s %-16s %10.1f ns/emit %12.0f calls/s %6.2f allocs %5.2f copies %5.2f moves\n",
+                 signature, connectionName(kind), timing.emitNsPerCall, timing.callsPerSecond,
+                 timing.allocationsPerCall, copies.copiesPerCall, copies.movesPerCall);
+    return row;
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Signal/slot dispatch cost per signature and connection type");
+    parser.addHelpOption();
+    QCommandLineOption iterationsOption("iterations", "每种组合的调用次数", "count", "200000");
+    QCommandLineOption outputOption("output", "JSON输出文件，默认标准输出", "file");
+    parser.addOption(iterationsOption);
+    parser.addOption(outputOption);
+    parser.process(app);
+
+    const qint64 iterations = qMax<qint64>(parser.value(iterationsOption).toLongLong(), 1000);
+
+    // 排队连接需要元类型；CopyProbe注册后QMetaType::create通过复制构造函数复制参数
+    qRegisterMetaType<CopyProbe>();
+
+    DispatchSender sender;
+    DispatchReceiver localReceiver;
+
+    QThread receiverThread;
+    receiverThread.setObjectName("dispatch-receiver");
+    DispatchReceiver *remoteReceiver = new DispatchReceiver();
+    remoteReceiver->moveToThread(&receiverThread);
+    QObject::connect(&receiverThread, &QThread::finished, remoteReceiver, &QObject::deleteLater);
+    receiverThread.start();
+
+    BenchEnvironment env{&sender, &localReceiver, remoteReceiver};
+
+    // 典型消息大小：64字符的文本和256字节的二进制数据
+    const QString text(64, QLatin1Char('x'));
+    const QByteArray data(256, 'x');
+
+    const ConnectionKind kinds[] = {ConnectionKind::Direct, ConnectionKind::Queued, ConnectionKind::BlockingQueued,
+                                    ConnectionKind::Lambda, ConnectionKind::Functor};
+
+    QJsonArray results;
+    for (ConnectionKind kind : kinds) {
+        results.append(measure(env, "int", kind, &DispatchSender::signalInt, &DispatchReceiver::slotInt, 42,
+                               &DispatchSender::signalProbe, &DispatchReceiver::slotProbe, iterations));
+        results.append(measure(env, "const int&", kind,
+                               &DispatchSender::signalIntConstRef, &DispatchReceiver::slotIntConstRef, 42,
+                               &DispatchSender::signalProbeConstRef, &DispatchReceiver::slotProbeConstRef,
+                               iterations));
+        results.append(measure(env, "QString", kind,
+                               &DispatchSender::signalString, &DispatchReceiver::slotString, text,
+                               &DispatchSender::signalProbe, &DispatchReceiver::slotProbe, iterations));
+        results.append(measure(env, "const QString&", kind,
+                               &DispatchSender::signalStringConstRef, &DispatchReceiver::slotStringConstRef, text,
+                               &DispatchSender::signalProbeConstRef, &DispatchReceiver::slotProbeConstRef,
+                               iterations));
+        results.append(measure(env, "QByteArray", kind,
+                               &DispatchSender::signalByteArray, &DispatchReceiver::slotByteArray, data,
+                               &DispatchSender::signalProbe, &DispatchReceiver::slotProbe, iterations));
+        results.append(measure(env, "const QByteArray&", kind,
+                               &DispatchSender::signalByteArrayConstRef, &DispatchReceiver::slotByteArrayConstRef,
+                               data, &DispatchSender::signalProbeConstRef, &DispatchReceiver::slotProbeConstRef,
+                               iterations));
+    }
+
+    receiverThread.quit();
+    receiverThread.wait();
+
+    QJsonObject report;
+    report["qt_version"] = qVersion();
+    report["iterations"] = iterations;
+    report["string_length"] = text.size();
+    report["bytearray_size"] = data.size();
+    report["results"] = results;
+
+    const QByteArray json = QJsonDocument(report).toJson(QJsonDocument::Indented);
+    if (parser.isSet(outputOption)) {
+        QFile file(parser.value(outputOption));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            std::fprintf(stderr, "[ERROR] Cannot write %s\n", qPrintable(file.fileName()));
+            return 1;
+        }
+        file.write(json);
+    } else {
+        std::fwrite(json.constData(), 1, static_cast<size_t>(json.size()), stdout);
+    }
+    return 0;
+}
+
+#include "signal_dispatch_benchmark.moc"
@@ -0,0 +1,124 @@
+/**
+ * @file chart_benchmark.cpp
+ * @brief TimeSeriesChart的帧耗时：千万个点、多条序列，纯CPU光栅绘制
+ *
+ * 测量：
+ *   - 写满环形缓冲区的耗时
+ *   - 整体重画（改变时间窗口后同步重绘，抽取并绘制全部像素列）
+ *   - 流式帧：每帧每条序列追加16 ms的采样后同步重绘，只重画新增和变化的列
+ * 每项重复若干次，统计p50/p99/max，并换算成帧率。
+ *
+ * 用法: chart_benchmark [-platform offscreen] [序列数=16] [每条序列点数=625000] [宽度=1200]
+ */
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "time_series_chart.h"
+
+// 与Dashboard相同：每秒1000个采样
+static const int kSampleRate = 1000;
+
+struct FrameLatency {
+    double p50Ms = 0;
+    double p99Ms = 0;
+    double maxMs = 0;
+};
+
+static FrameLatency summarize(std::vector<qint64> &samplesNs)
+{
+    FrameLatency latency;
+    if (samplesNs.empty()) {
+        return latency;
+    }
+    std::sort(samplesNs.begin(), samplesNs.end());
+    auto at = [&samplesNs](double percentile) {
+        const size_t index = static_cast<size_t>(percentile / 100.0 * (samplesNs.size() - 1));
+        return samplesNs[index] / 1e6;
+    };
+    latency.p50Ms = at(50.0);
+    latency.p99Ms = at(99.0);
+    latency.maxMs = samplesNs.back() / 1e6;
+    return latency;
+}
+
+static void report(const char *name, const FrameLatency &latency, double columns)
+{
+    std::printf("%-12s p50 %6.2f ms  p99 %6.2f ms  max %6.2f ms  (%5.0f fps at p99)  columns/frame %6.0f\n",
+                name, latency.p50Ms, latency.p99Ms, latency.maxMs,
+                latency.p99Ms > 0 ? 1000.0 / latency.p99Ms : 0.0, columns);
+    std::fflush(stdout);
+}
+
+int main(int argc, char *argv[])
+{
+    QApplication app(argc, argv);
+    const QStringList arguments = app.arguments();
+    const int seriesCount = arguments.size() > 1 ? arguments.at(1).toInt() : 16;
+    const qint64 pointsPerSeries = arguments.size() > 2 ? arguments.at(2).toLongLong() : 625000;
+    const int width = arguments.size() > 3 ? arguments.at(3).toInt() : 1200;
+
+    TimeSeriesChart chart;
+    chart.resize(width, 500);
+    chart.setTimeWindow(static_cast<double>(pointsPerSeries) / kSampleRate);
+    for (int i = 0; i < seriesCount; ++i) {
+        chart.addSeries(QString("s%1").arg(i), QColor::fromHsv(i * 360 / qMax(1, seriesCount), 200, 200),
+                        pointsPerSeries);
+    }
+
+    QRandomGenerator generator(7);
+    std::vector<float> levels(static_cast<size_t>(seriesCount), 0.0f);
+    qint64 sample = 0;
+    auto append = [&](qint64 count) {
+        for (qint64 n = 0; n < count; ++n, ++sample) {
+            for (int i = 0; i < seriesCount; ++i) {
+                float &level = levels[static_cast<size_t>(i)];
+                level = level * 0.999f + static_cast<float>(generator.generateDouble() - 0.5) * 0.2f;
+                chart.appendSample(i, static_cast<double>(sample) / kSampleRate,
+                                   static_cast<float>(10.0 * i + 3.0 * std::sin(sample * 0.001 * (1 + i % 5))) + level);
+            }
+        }
+    };
+
+    QElapsedTimer timer;
+    timer.start();
+    append(pointsPerSeries);
+    std::printf("Time-series chart benchmark: %d series x %lld points = %lld points, plot width %d\n",
+                seriesCount, static_cast<long long>(pointsPerSeries), static_cast<long long>(chart.pointCount()),
+                width);
+    std::printf("fill         %8.2f ms\n", timer.nsecsElapsed() / 1e6);
+
+    chart.show();
+    QApplication::processEvents();
+
+    // 整体重画：改变时间窗口使缓存失效
+    std::vector<qint64> samples;
+    double columns = 0;
+    for (int i = 0; i < 30; ++i) {
+        chart.setTimeWindow(chart.timeWindow() * (i % 2 ? 1.01 : 1 / 1.01));
+        timer.start();
+        chart.repaint();
+        samples.push_back(timer.nsecsElapsed());
+        columns += chart.lastRenderedColumns();
+    }
+    report("full", summarize(samples), columns / 30);
+
+    // 流式帧：每帧追加16 ms的采样
+    samples.clear();
+    columns = 0;
+    const int frames = 300;
+    for (int i = 0; i < frames; ++i) {
+        append(16 * kSampleRate / 1000);
+        timer.start();
+        chart.repaint();
+        samples.push_back(timer.nsecsElapsed());
+        columns += chart.lastRenderedColumns();
+    }
+    report("streaming", summarize(samples), columns / frames);
+    return 0;
+}
@@ -3,6 +3,48 @@
 #include <QMessageBox>
 #include <QHeaderView>
 #include <QRandomGenerator>
+#include <QStatusBar>
+#include <QtConcurrent>
+#include <QtMath>
+#include <numeric>
+
+// 示例项目行数：模型/视图按可见行取数，百万到千万行都可以流畅滚动
+static const int kSampleProjectRows = 1000000;
+
+// 每次刷新约有1%的行变化
+static const double kRefreshChangeRatio = 0.01;
+// 删除段、插入段和移动的总数超过该值时整体重置（每个移动要搬移整列，有行映射时代理每个都要扫描整个映射）
+static const int kMaxStructuralOps = 2000;
+// 每轮事件循环最多搬移（或扫描映射）的行数，约几毫秒
+static const qint64 kDiffRowsPerBatch = 4000000;
+// 停止输入多久后开始搜索
+static const int kSearchDebounceMs = 150;
+
+// 图表：16条序列各保留62.5万个点（合计一千万个点，约120 MB），每秒1000个采样
+static const int kChartSeries = 16;
+static const qint64 kChartPointsPerSeries = 625000;
+static const int kChartSampleRate = 1000;
+static const double kChartWindowSeconds = 600;
+// 初始数据每轮事件循环追加的采样数（每个采样16个点），约几毫秒
+static const qint64 kChartSeedSamplesPerBatch = 20000;
+
+// 生成从first开始的count个采样，按采样、序列交错写入values；levels和random为随机游走的状态
+static void generateChartSamples(qint64 first, qint64 count, std::vector<float> *levels,
+                                 QRandomGenerator *random, std::vector<float> *values)
+{
+    values->resize(static_cast<size_t>(count * kChartSeries));
+    float *out = values->data();
+    for (qint64 sample = first; sample < first + count; ++sample) {
+        for (int series = 0; series < kChartSeries; ++series) {
+            // 随机游走叠加周期为5～20秒的正弦波，各序列错开基线
+            float &level = (*levels)[static_cast<size_t>(series)];
+            level = level * 0.999f + static_cast<float>(random->generateDouble() - 0.5) * 0.2f;
+            const double period = (5.0 + series) * kChartSampleRate;
+            const double wave = 3.0 * std::sin(2.0 * M_PI * static_cast<double>(sample) / period);
+            *out++ = static_cast<float>(10.0 * series + wave) + level;
+        }
+    }
+}
 
 Dashboard::Dashboard(QWidget *parent)
     : QMainWindow(parent)
@@ -26,18 +68,57 @@ Dashboard::Dashboard(QWidget *parent)
     , m_contentSplitter(nullptr)
     , m_tabWidget(nullptr)
     , m_tableTab(nullptr)
+    , m_searchEdit(nullptr)
     , m_dataTable(nullptr)
+    , m_tableModel(nullptr)
+    , m_tableProxy(nullptr)
     , m_chartTab(nullptr)
     , m_chartContainer(nullptr)
+    , m_chart(nullptr)
     , m_controlTab(nullptr)
     , m_controlScrollArea(nullptr)
     , m_controlWidget(nullptr)
     , m_updateTimer(nullptr)
+    , m_loadWatcher(nullptr)
+    , m_diffWatcher(nullptr)
+    , m_nextDiffOp(0)
+    , m_refreshInFlight(false)
+    , m_refreshQueued(false)
+    , m_searchDebounce(nullptr)
+    , m_viewWatcher(nullptr)
+    , m_sortColumn(-1)
+    , m_sortOrder(Qt::AscendingOrder)
+    , m_chartTimer(nullptr)
+    , m_chartSamples(0)
+    , m_chartRandom(20240601)
+    , m_chartSeedWatcher(nullptr)
+    , m_chartSeedNext(0)
 {
     setupUI();
     connectSignals();
     loadSampleData();
 
+    m_diffWatcher = new QFutureWatcher<ProjectTableDiff>(this);
+    connect(m_diffWatcher, &QFutureWatcher<ProjectTableDiff>::finished, this, &Dashboard::onDiffReady);
+
+    // ❌ 原来：搜索框没有连接；直接用QSortFilterProxyModel过滤百万行，每次按键都会卡住界面
+    // ✅ 现在：停止输入后在工作线程用索引查询，结果一次性替换代理的行映射
+    m_searchDebounce = new QTimer(this);
+    m_searchDebounce->setSingleShot(true);
+    m_searchDebounce->setInterval(kSearchDebounceMs);
+    connect(m_searchEdit, &QLineEdit::textChanged, m_searchDebounce, QOverload<>::of(&QTimer::start));
+    connect(m_searchDebounce, &QTimer::timeout, this, [this]() { startViewQuery(false); });
+    m_viewWatcher = new QFutureWatcher<TableViewResult>(this);
+    connect(m_viewWatcher, &QFutureWatcher<TableViewResult>::finished, this, &Dashboard::onViewQueryFinished);
+
+    // ❌ 原来：表格不能排序；setSortingEnabled或QSortFilterProxyModel在GUI线程排序百万行，点击表头会卡住数秒
+    // ✅ 现在：表头只切换排序指示，排列在工作线程中并行计算，算好后一次性替换行映射
+    QHeaderView *header = m_dataTable->horizontalHeader();
+    header->setSectionsClickable(true);
+    header->setSortIndicatorShown(true);
+    header->setSortIndicator(-1, Qt::AscendingOrder);
+    connect(header, &QHeaderView::sortIndicatorChanged, this, &Dashboard::onSortRequested);
+
     // 启动定时更新
     m_updateTimer = new QTimer(this);
     connect(m_updateTimer, &QTimer::timeout, this, &Dashboard::updateStatistics);
@@ -46,6 +127,13 @@ Dashboard::Dashboard(QWidget *parent)
 
 Dashboard::~Dashboard()
 {
+    if (m_viewCancel) {
+        m_viewCancel->store(true);
+    }
+    m_loadWatcher->waitForFinished();
+    m_chartSeedWatcher->waitForFinished();
+    m_diffWatcher->waitForFinished();
+    m_viewWatcher->waitForFinished();
 }
 
 void Dashboard::setupUI()
@@ -254,9 +342,10 @@ void Dashboard::setupMainContent()
     QHBoxLayout *toolbarLayout = new QHBoxLayout(tableToolbar);
     toolbarLayout->setContentsMargins(0, 0, 0, 0);
 
-    QLineEdit *searchEdit = new QLineEdit();
-    searchEdit->setPlaceholderText("搜索数据...");
-    searchEdit->setMaximumWidth(300);
+    m_searchEdit = new QLineEdit();
+    m_searchEdit->setPlaceholderText("搜索项目名称、负责人、状态...");
+    m_searchEdit->setMaximumWidth(300);
+    m_searchEdit->setClearButtonEnabled(true);
 
     QPushButton *filterBtn = new QPushButton("筛选");
     QPushButton *addBtn = new QPushButton("添加");
@@ -265,18 +354,28 @@ void Dashboard::setupMainContent()
 
     toolbarLayout->addWidget(new QLabel("数据列表"));
     toolbarLayout->addStretch();
-    toolbarLayout->addWidget(searchEdit);
+    toolbarLayout->addWidget(m_searchEdit);
     toolbarLayout->addWidget(filterBtn);
     toolbarLayout->addWidget(addBtn);
 
     // 数据表格
-    m_dataTable = new QTableWidget(10, 6);
-    QStringList headers = {"ID", "项目名称", "负责人", "状态", "进度", "创建时间"};
-    m_dataTable->setHorizontalHeaderLabels(headers);
+    // ❌ 原来：QTableWidget每个单元格一个堆上的QTableWidgetItem，百万行时占用数GB、填充需要数十秒
+    // ✅ 现在：列式存储的ProjectTableModel + QTableView，只为可见单元格格式化文本
+    m_tableModel = new ProjectTableModel(this);
+    // 搜索和排序结果通过代理的行映射显示，源模型不变
+    m_tableProxy = new RowMappingProxyModel(this);
+    m_tableProxy->setSourceModel(m_tableModel);
+    m_dataTable = new QTableView();
+    m_dataTable->setModel(m_tableProxy);
 
     // 设置表格样式
     m_dataTable->horizontalHeader()->setStretchLastSection(true);
     m_dataTable->horizontalHeader()->setDefaultSectionSize(120);
+    // ✅ 固定行高：视图直接由行号计算位置，不需要逐行测量sizeHint
+    m_dataTable->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    m_dataTable->verticalHeader()->setDefaultSectionSize(28);
+    m_dataTable->verticalHeader()->hide();
+    m_dataTable->setWordWrap(false);
     m_dataTable->setAlternatingRowColors(true);
     m_dataTable->setSelectionBehavior(QAbstractItemView::SelectRows);
 
@@ -297,10 +396,19 @@ void Dashboard::setupMainContent()
     QVBoxLayout *chartContainerLayout = new QVBoxLayout(m_chartContainer);
     chartContainerLayout->setContentsMargins(20, 20, 20, 20);
 
-    QLabel *chartPlaceholder = new QLabel("📊 图表区域\n\n这里将显示数据可视化图表\n(需要集成图表库如Qt Charts)");
-    chartPlaceholder->setAlignment(Qt::AlignCenter);
-    chartPlaceholder->setStyleSheet("color: #616161; font-size: 16px;");
-    chartContainerLayout->addWidget(chartPlaceholder);
+    // ❌ 原来：只有占位标签；Qt Charts的QLineSeries每次重绘都要处理全部点，千万点时无法实时刷新
+    // ✅ 现在：QPainter直接绘制的TimeSeriesChart，环形缓冲区 + 按像素列抽取 + 分层缓存
+    m_chart = new TimeSeriesChart();
+    m_chart->setTimeWindow(kChartWindowSeconds);
+    const QStringList seriesNames = {"CPU", "内存", "磁盘IO", "网络入", "网络出", "请求数", "错误数", "延迟p50",
+                                     "延迟p99", "队列长度", "连接数", "缓存命中", "GC暂停", "线程数", "吞吐量", "温度"};
+    const QStringList seriesColors = {"#2196F3", "#4CAF50", "#FF9800", "#9C27B0", "#F44336", "#00BCD4",
+                                      "#795548", "#3F51B5", "#E91E63", "#8BC34A", "#FFC107", "#009688",
+                                      "#673AB7", "#607D8B", "#CDDC39", "#FF5722"};
+    for (int i = 0; i < kChartSeries; ++i) {
+        m_chart->addSeries(seriesNames.at(i), QColor(seriesColors.at(i)), kChartPointsPerSeries);
+    }
+    chartContainerLayout->addWidget(m_chart);
 
     chartLayout->addWidget(chartTitle);
     chartLayout->addWidget(m_chartContainer);
@@ -396,36 +504,85 @@ void Dashboard::connectSignals()
 
 void Dashboard::loadSampleData()
 {
-    // 加载表格数据
-    QStringList projects = {
-        "电商平台开发", "移动APP重构", "数据分析系统", "客户管理系统",
-        "在线教育平台", "金融交易系统", "物联网监控", "内容管理系统",
-        "人工智能助手", "区块链钱包", "云计算平台", "社交网络应用"
-    };
-
-    QStringList managers = {
-        "张三", "李四", "王五", "赵六", "钱七", "孙八",
-        "周九", "吴十", "郑十一", "冯十二", "陈十三", "褚十四"
-    };
+    // ❌ 原来：在构造函数中同步生成一百万行，窗口要等生成完才能显示
+    // ✅ 现在：工作线程生成，完成后整体交给模型；期间表格为空，刷新请求按进行中排队
+    m_refreshInFlight = true;
+    statusBar()->showMessage(QString("正在生成%1行示例数据…").arg(kSampleProjectRows));
+    m_loadWatcher = new QFutureWatcher<std::shared_ptr<const ProjectTable>>(this);
+    connect(m_loadWatcher, &QFutureWatcher<std::shared_ptr<const ProjectTable>>::finished,
+            this, &Dashboard::onSampleDataReady);
+    const quint32 seed = QRandomGenerator::global()->generate();
+    m_loadWatcher->setFuture(QtConcurrent::run([seed]() {
+        return std::make_shared<const ProjectTable>(generateProjectTable(kSampleProjectRows, seed));
+    }));
+
+    // 加载图表数据：先写满环形缓冲区，之后按采样率持续追加
+    // ❌ 原来：构造函数中同步生成并追加一千万个点，窗口要等数秒才显示
+    // ✅ 现在：工作线程生成初始数据，GUI线程分批追加；追加完才开始实时采样
+    m_chartLevels.assign(kChartSeries, 0.0f);
+    m_chartTimer = new QTimer(this);
+    connect(m_chartTimer, &QTimer::timeout, this, &Dashboard::onChartTick);
+    m_chartSeedWatcher = new QFutureWatcher<std::shared_ptr<ChartSeed>>(this);
+    connect(m_chartSeedWatcher, &QFutureWatcher<std::shared_ptr<ChartSeed>>::finished,
+            this, &Dashboard::onChartSeedReady);
+    auto seed = std::make_shared<ChartSeed>();
+    seed->levels = m_chartLevels;
+    seed->random = m_chartRandom;
+    m_chartSeedWatcher->setFuture(QtConcurrent::run([seed]() {
+        generateChartSamples(0, kChartPointsPerSeries, &seed->levels, &seed->random, &seed->values);
+        return seed;
+    }));
+}
 
-    QStringList statuses = {"进行中", "已完成", "暂停", "计划中"};
+void Dashboard::onChartSeedReady()
+{
+    m_chartSeed = m_chartSeedWatcher->result();
+    m_chartLevels = m_chartSeed->levels;
+    m_chartRandom = m_chartSeed->random;
+    m_chartSeedNext = 0;
+    appendChartSeedBatch();
+}
 
-    m_dataTable->setRowCount(projects.size());
+void Dashboard::appendChartSeedBatch()
+{
+    const qint64 count = qMin(kChartSeedSamplesPerBatch, kChartPointsPerSeries - m_chartSeedNext);
+    appendChartValues(m_chartSeed->values.data() + m_chartSeedNext * kChartSeries, count);
+    m_chartSeedNext += count;
+    if (m_chartSeedNext < kChartPointsPerSeries) {
+        // 与实时数据一样分批进入图表，期间输入和绘制照常处理
+        QTimer::singleShot(0, this, &Dashboard::appendChartSeedBatch);
+        return;
+    }
 
-    for (int i = 0; i < projects.size(); ++i) {
-        m_dataTable->setItem(i, 0, new QTableWidgetItem(QString::number(1001 + i)));
-        m_dataTable->setItem(i, 1, new QTableWidgetItem(projects[i]));
-        m_dataTable->setItem(i, 2, new QTableWidgetItem(managers[i]));
-        m_dataTable->setItem(i, 3, new QTableWidgetItem(statuses[i % statuses.size()]));
+    m_chartSeed.reset();
+    m_chartClock.start();
+    m_chartTimer->start(10);
+}
 
-        int progress = QRandomGenerator::global()->bounded(20, 100);
-        m_dataTable->setItem(i, 4, new QTableWidgetItem(QString("%1%").arg(progress)));
+void Dashboard::appendChartSamples(qint64 count)
+{
+    std::vector<float> values;
+    generateChartSamples(m_chartSamples, count, &m_chartLevels, &m_chartRandom, &values);
+    appendChartValues(values.data(), count);
+}
 
-        QDateTime date = QDateTime::currentDateTime().addDays(-QRandomGenerator::global()->bounded(1, 365));
-        m_dataTable->setItem(i, 5, new QTableWidgetItem(date.toString("yyyy-MM-dd")));
+void Dashboard::appendChartValues(const float *values, qint64 count)
+{
+    for (qint64 n = 0; n < count; ++n, ++m_chartSamples) {
+        const double x = static_cast<double>(m_chartSamples) / kChartSampleRate;
+        for (int series = 0; series < kChartSeries; ++series) {
+            m_chart->appendSample(series, x, *values++);
+        }
     }
 }
 
+void Dashboard::onChartTick()
+{
+    // 按经过的时间补齐采样，定时器抖动不影响采样率
+    const qint64 target = kChartPointsPerSeries + m_chartClock.elapsed() * kChartSampleRate / 1000;
+    appendChartSamples(target - m_chartSamples);
+}
+
 void Dashboard::applyCardStyle(QWidget *widget)
 {
     widget->setStyleSheet(
@@ -470,11 +627,198 @@ void Dashboard::createModernProgressBar(QProgressBar *progressBar, int value)
 }
 
 // 槽函数实现
+void Dashboard::onSampleDataReady()
+{
+    QElapsedTimer timer;
+    timer.start();
+    m_snapshot = m_loadWatcher->result();
+    m_tableModel->setTable(*m_snapshot);
+    m_refreshInFlight = false;
+    statusBar()->showMessage(QString("已加载%1行示例数据（交给模型%2 ms）")
+                             .arg(m_snapshot->rowCount())
+                             .arg(timer.elapsed()), 5000);
+
+    // 生成期间输入的搜索或点击的排序在这里补算
+    if (!m_searchEdit->text().trimmed().isEmpty() || m_sortColumn >= 0) {
+        startViewQuery(false);
+    }
+    if (m_refreshQueued) {
+        m_refreshQueued = false;
+        onRefreshData();
+    }
+}
+
 void Dashboard::onRefreshData()
 {
-    loadSampleData();
+    // ❌ 原来：重新加载并重置整个表格，选择、滚动位置和视图缓存全部丢失
+    // ✅ 现在：工作线程取得新数据并按ID计算差异，GUI线程只应用变化的行
+    if (m_refreshInFlight) {
+        m_refreshQueued = true;
+        return;
+    }
+    m_refreshInFlight = true;
+
+    // 工作线程读取只读快照，与GUI线程修改模型互不影响
+    const std::shared_ptr<const ProjectTable> current = m_snapshot;
+    const quint32 seed = QRandomGenerator::global()->generate();
+    m_diffWatcher->setFuture(QtConcurrent::run([current, seed]() {
+        auto next = std::make_shared<const ProjectTable>(simulateProjectUpdate(*current, seed, kRefreshChangeRatio));
+        return diffProjectTables(*current, std::move(next), kMaxStructuralOps);
+    }));
+
     updateStatistics();
-    QMessageBox::information(this, "刷新完成", "数据已刷新到最新状态");
+}
+
+void Dashboard::onDiffReady()
+{
+    m_pendingDiff = m_diffWatcher->result();
+    m_nextDiffOp = 0;
+    m_applyTimer.start();
+    applyDiffBatch();
+}
+
+void Dashboard::applyDiffBatch()
+{
+    // ❌ 原来：每批固定256个操作，每个删除/插入段都搬移整列，一批在一百万行上要搬移上亿行
+    // ✅ 现在：每批按估计搬移的行数限额；有行映射时每个结构操作再计一遍映射长度
+    const qint64 mappedRows = m_tableProxy->hasRowMapping() ? m_tableProxy->rowCount() : 0;
+    if (!m_tableModel->applyDiff(m_pendingDiff, &m_nextDiffOp, kDiffRowsPerBatch, mappedRows)) {
+        // 剩余操作留到下一轮事件循环，期间输入和绘制照常处理
+        QTimer::singleShot(0, this, &Dashboard::applyDiffBatch);
+        return;
+    }
+
+    if (m_pendingDiff.reset) {
+        statusBar()->showMessage(QString("数据已刷新：变化过多，整体重置（%1 ms）")
+                                 .arg(m_applyTimer.elapsed()), 5000);
+    } else {
+        statusBar()->showMessage(QString("数据已刷新：新增%1 删除%2 移动%3 更新%4行（差异%5 ms，应用%6 ms）")
+                                 .arg(m_pendingDiff.insertedRows)
+                                 .arg(m_pendingDiff.removedRows)
+                                 .arg(m_pendingDiff.movedRows)
+                                 .arg(m_pendingDiff.updatedRows)
+                                 .arg(m_pendingDiff.elapsedNs / 1000000)
+                                 .arg(m_applyTimer.elapsed()), 5000);
+    }
+
+    // 模型内容现在与目标表一致
+    m_snapshot = m_pendingDiff.target;
+    m_pendingDiff = ProjectTableDiff();
+    m_refreshInFlight = false;
+
+    // 有搜索或排序时在新数据上重新计算，新增的行才会出现在结果中
+    if (m_tableProxy->hasRowMapping() || !m_searchEdit->text().trimmed().isEmpty() || m_sortColumn >= 0) {
+        startViewQuery(false);
+    }
+    if (m_refreshQueued) {
+        m_refreshQueued = false;
+        onRefreshData();
+    }
+}
+
+void Dashboard::onSortRequested(int column, Qt::SortOrder order)
+{
+    m_sortColumn = column;
+    m_sortOrder = order;
+    // 以当前显示顺序作为输入，稳定排序使上一次排序的列成为次序
+    startViewQuery(true);
+}
+
+void Dashboard::startViewQuery(bool keepDisplayOrder)
+{
+    // 示例数据还在生成，完成后会按当前的搜索和排序重新计算
+    if (!m_snapshot) {
+        return;
+    }
+
+    // 仍在运行的旧查询或排序尽快结束；QFutureWatcher只报告最新一次
+    if (m_viewCancel) {
+        m_viewCancel->store(true);
+    }
+    m_viewCancel = std::make_shared<std::atomic<bool>>(false);
+
+    const std::shared_ptr<const ProjectTable> snapshot = m_snapshot;
+    const std::shared_ptr<const ProjectSearchIndex> index = m_searchIndex;
+    const std::shared_ptr<std::atomic<bool>> canceled = m_viewCancel;
+    const QString query = m_searchEdit->text();
+    const int column = m_sortColumn;
+    const Qt::SortOrder order = m_sortOrder;
+
+    // 只换排序列时行集合不变，直接排序当前映射；刷新期间映射与快照不一致，重新搜索
+    std::shared_ptr<std::vector<int>> displayOrder;
+    if (keepDisplayOrder && column >= 0 && !m_refreshInFlight && m_tableProxy->hasRowMapping()) {
+        displayOrder = std::make_shared<std::vector<int>>(m_tableProxy->rowMapping());
+    }
+
+    m_viewWatcher->setFuture(QtConcurrent::run([snapshot, index, query, column, order, displayOrder, canceled]() {
+        TableViewResult result;
+        if (displayOrder) {
+            result.search.query = query;
+            result.search.snapshot = snapshot;
+            result.search.index = index;
+            result.search.rows = std::move(*displayOrder);
+        } else {
+            result.search = runProjectSearch(snapshot, index, query, *canceled);
+        }
+        if (result.search.canceled || column < 0) {
+            return result;
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        std::vector<int> &rows = result.search.rows;
+        if (result.search.matchesAll) {
+            rows.resize(static_cast<size_t>(snapshot->rowCount()));
+            std::iota(rows.begin(), rows.end(), 0);
+            result.search.matchesAll = false;
+        }
+        result.search.canceled = !sortProjectRows(*snapshot, column, order, &rows, *canceled);
+        result.sorted = true;
+        result.sortElapsedNs = timer.nsecsElapsed();
+        return result;
+    }));
+}
+
+void Dashboard::onViewQueryFinished()
+{
+    TableViewResult result = m_viewWatcher->result();
+    ProjectSearchResult &search = result.search;
+    if (search.canceled) {
+        return;
+    }
+    if (search.index) {
+        m_searchIndex = search.index;
+    }
+
+    if (search.matchesAll) {
+        m_tableProxy->clearRowMapping();
+        statusBar()->clearMessage();
+        return;
+    }
+
+    // 结果中的行号属于查询时的快照；期间数据已刷新时丢弃，刷新完成后会重新计算
+    if (search.snapshot != m_snapshot || m_refreshInFlight) {
+        return;
+    }
+
+    const int matched = static_cast<int>(search.rows.size());
+    m_tableProxy->setRowMapping(std::move(search.rows));
+
+    QStringList parts;
+    if (!search.query.trimmed().isEmpty()) {
+        parts << QString("搜索“%1”：%2 行匹配（%3 ms）")
+                 .arg(search.query.trimmed())
+                 .arg(matched)
+                 .arg(search.elapsedNs / 1e6, 0, 'f', 1);
+    }
+    if (result.sorted) {
+        parts << QString("按“%1”%2排序 %3 行（%4 ms）")
+                 .arg(m_tableModel->headerData(m_sortColumn, Qt::Horizontal).toString())
+                 .arg(m_sortOrder == Qt::AscendingOrder ? "升序" : "降序")
+                 .arg(matched)
+                 .arg(result.sortElapsedNs / 1e6, 0, 'f', 1);
+    }
+    statusBar()->showMessage(parts.join("，"), 5000);
 }
 
 void Dashboard::onThemeChanged(const QString &theme)
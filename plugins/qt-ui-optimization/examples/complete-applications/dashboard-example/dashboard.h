@@ -8,7 +8,7 @@
 #include <QGridLayout>
 #include <QPushButton>
 #include <QProgressBar>
-#include <QTableWidget>
+#include <QTableView>
 #include <QGroupBox>
 #include <QScrollArea>
 #include <QSplitter>
@@ -19,6 +19,35 @@
 #include <QCheckBox>
 #include <QFrame>
 #include <QTimer>
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+#include <QRandomGenerator>
+#include "project_table_model.h"
+#include "project_search.h"
+#include "project_sort.h"
+#include "row_mapping_proxy_model.h"
+#include "time_series_chart.h"
+
+/**
+ * @brief 表格视图的一次搜索+排序结果（在工作线程中得到）
+ */
+struct TableViewResult
+{
+    ProjectSearchResult search;     // sorted时rows为排好序的行
+    bool sorted = false;
+    qint64 sortElapsedNs = 0;
+};
+
+/**
+ * @brief 图表的初始数据（在工作线程中生成），values按采样、序列交错排列
+ * levels和random是生成之后随机游走的状态，实时采样从这里接着生成
+ */
+struct ChartSeed
+{
+    std::vector<float> values;
+    std::vector<float> levels;
+    QRandomGenerator random;
+};
 
 /**
  * @brief 现代仪表盘主窗口类
@@ -33,11 +62,19 @@ public:
     ~Dashboard();
 
 private slots:
+    void onSampleDataReady();
     void onRefreshData();
     void onThemeChanged(const QString &theme);
     void onExportReport();
     void onSettingsClicked();
     void updateStatistics();
+    void onDiffReady();
+    void applyDiffBatch();
+    void onSortRequested(int column, Qt::SortOrder order);
+    void onViewQueryFinished();
+    void onChartSeedReady();
+    void appendChartSeedBatch();
+    void onChartTick();
 
 private:
     void setupUI();
@@ -47,6 +84,9 @@ private:
     void setupStatusBar();
     void connectSignals();
     void loadSampleData();
+    void startViewQuery(bool keepDisplayOrder);
+    void appendChartSamples(qint64 count);
+    void appendChartValues(const float *values, qint64 count);
 
     // UI组件
     QWidget *m_centralWidget;
@@ -77,11 +117,15 @@ private:
 
     // 数据表格标签页
     QWidget *m_tableTab;
-    QTableWidget *m_dataTable;
+    QLineEdit *m_searchEdit;
+    QTableView *m_dataTable;
+    ProjectTableModel *m_tableModel;
+    RowMappingProxyModel *m_tableProxy;
 
     // 图表标签页
     QWidget *m_chartTab;
     QWidget *m_chartContainer;
+    TimeSeriesChart *m_chart;
 
     // 控制面板标签页
     QWidget *m_controlTab;
@@ -91,6 +135,36 @@ private:
     // 统计信息
     QTimer *m_updateTimer;
 
+    // 与模型内容一致的只读快照，供工作线程使用；差异应用完成后替换。示例数据生成完成前为空
+    std::shared_ptr<const ProjectTable> m_snapshot;
+    QFutureWatcher<std::shared_ptr<const ProjectTable>> *m_loadWatcher;
+
+    // 增量刷新：工作线程计算差异，GUI线程分批应用
+    QFutureWatcher<ProjectTableDiff> *m_diffWatcher;
+    ProjectTableDiff m_pendingDiff;
+    size_t m_nextDiffOp;
+    bool m_refreshInFlight;
+    bool m_refreshQueued;
+    QElapsedTimer m_applyTimer;
+
+    // 搜索和排序：输入防抖后或点击表头时在工作线程计算，结果作为行映射交给代理
+    QTimer *m_searchDebounce;
+    QFutureWatcher<TableViewResult> *m_viewWatcher;
+    std::shared_ptr<std::atomic<bool>> m_viewCancel;
+    std::shared_ptr<const ProjectSearchIndex> m_searchIndex;
+    int m_sortColumn;                   // -1为不排序
+    Qt::SortOrder m_sortOrder;
+
+    // 图表：模拟的监控指标按固定采样率写入环形缓冲区
+    QTimer *m_chartTimer;
+    QElapsedTimer m_chartClock;
+    qint64 m_chartSamples;
+    std::vector<float> m_chartLevels;
+    QRandomGenerator m_chartRandom;
+    QFutureWatcher<std::shared_ptr<ChartSeed>> *m_chartSeedWatcher;
+    std::shared_ptr<ChartSeed> m_chartSeed;     // 分批追加期间持有
+    qint64 m_chartSeedNext;
+
     // 样式相关
     void applyCardStyle(QWidget *widget);
     void applyButtonStyle(QPushButton *button, const QString &styleClass = "");
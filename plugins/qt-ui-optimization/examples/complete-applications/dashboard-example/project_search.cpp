@@ -0,0 +1,162 @@
+#include "project_search.h"
+#include <QElapsedTimer>
+#include <QRegularExpression>
+#include <algorithm>
+
+// 三个UTF-16码元组成一个键
+static quint64 trigramKey(const QString &text, int position)
+{
+    return (quint64(text.at(position).unicode()) << 32)
+         | (quint64(text.at(position + 1).unicode()) << 16)
+         | quint64(text.at(position + 2).unicode());
+}
+
+std::shared_ptr<const ProjectSearchIndex> ProjectSearchIndex::build(const ProjectTable &table)
+{
+    auto index = std::make_shared<ProjectSearchIndex>();
+    buildColumn(&index->m_names, table.namePool);
+    buildColumn(&index->m_managers, table.managerPool);
+    buildColumn(&index->m_statuses, table.statusPool);
+    return index;
+}
+
+bool ProjectSearchIndex::covers(const ProjectTable &table) const
+{
+    return m_names.pool == table.namePool && m_managers.pool == table.managerPool
+        && m_statuses.pool == table.statusPool;
+}
+
+void ProjectSearchIndex::buildColumn(ColumnIndex *column, const QStringList &pool)
+{
+    column->pool = pool;
+    for (int entry = 0; entry < pool.size(); ++entry) {
+        const QString folded = pool.at(entry).toCaseFolded();
+        column->folded.append(folded);
+        for (int i = 0; i + 3 <= folded.size(); ++i) {
+            std::vector<int> &postings = column->trigrams[trigramKey(folded, i)];
+            // 条目按升序加入，同一条目中重复的三元组只记一次
+            if (postings.empty() || postings.back() != entry) {
+                postings.push_back(entry);
+            }
+        }
+    }
+}
+
+void ProjectSearchIndex::matchColumn(const ColumnIndex &column, const QString &term, std::vector<quint8> *match)
+{
+    match->assign(static_cast<size_t>(column.folded.size()), 0);
+
+    if (term.size() < 3) {
+        for (int entry = 0; entry < column.folded.size(); ++entry) {
+            (*match)[static_cast<size_t>(entry)] = column.folded.at(entry).contains(term) ? 1 : 0;
+        }
+        return;
+    }
+
+    // 从最短的倒排表开始求交，交集中的条目再做一次子串确认（三元组都出现不代表相邻）
+    std::vector<const std::vector<int> *> lists;
+    for (int i = 0; i + 3 <= term.size(); ++i) {
+        const auto it = column.trigrams.constFind(trigramKey(term, i));
+        if (it == column.trigrams.constEnd()) {
+            return;
+        }
+        lists.push_back(&it.value());
+    }
+    std::sort(lists.begin(), lists.end(),
+              [](const std::vector<int> *a, const std::vector<int> *b) { return a->size() < b->size(); });
+
+    std::vector<int> candidates = *lists.front();
+    std::vector<int> intersection;
+    for (size_t i = 1; i < lists.size() && !candidates.empty(); ++i) {
+        intersection.clear();
+        std::set_intersection(candidates.begin(), candidates.end(), lists[i]->begin(), lists[i]->end(),
+                              std::back_inserter(intersection));
+        candidates.swap(intersection);
+    }
+    for (int entry : candidates) {
+        if (column.folded.at(entry).contains(term)) {
+            (*match)[static_cast<size_t>(entry)] = 1;
+        }
+    }
+}
+
+void ProjectSearchIndex::matchEntries(const QString &term, std::vector<quint8> *names,
+                                      std::vector<quint8> *managers, std::vector<quint8> *statuses) const
+{
+    matchColumn(m_names, term, names);
+    matchColumn(m_managers, term, managers);
+    matchColumn(m_statuses, term, statuses);
+}
+
+ProjectSearchResult runProjectSearch(std::shared_ptr<const ProjectTable> snapshot,
+                                     std::shared_ptr<const ProjectSearchIndex> index,
+                                     const QString &query, const std::atomic<bool> &canceled)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    ProjectSearchResult result;
+    result.query = query;
+    result.snapshot = std::move(snapshot);
+    const ProjectTable &table = *result.snapshot;
+
+    static const QRegularExpression whitespace("\\s+");
+    const QStringList terms = query.toCaseFolded().split(whitespace, Qt::SkipEmptyParts);
+    if (terms.isEmpty()) {
+        result.matchesAll = true;
+        result.index = std::move(index);
+        result.elapsedNs = timer.nsecsElapsed();
+        return result;
+    }
+
+    if (!index || !index->covers(table)) {
+        index = ProjectSearchIndex::build(table);
+    }
+    result.index = index;
+
+    // 每个词一组按池下标的查找表：该词出现在名称、负责人或状态中的条目
+    struct TermMatch {
+        std::vector<quint8> names;
+        std::vector<quint8> managers;
+        std::vector<quint8> statuses;
+    };
+    std::vector<TermMatch> matches(static_cast<size_t>(terms.size()));
+    for (int i = 0; i < terms.size(); ++i) {
+        TermMatch &match = matches[static_cast<size_t>(i)];
+        index->matchEntries(terms.at(i), &match.names, &match.managers, &match.statuses);
+        const auto any = [](const std::vector<quint8> &entries) {
+            return std::find(entries.begin(), entries.end(), quint8(1)) != entries.end();
+        };
+        if (!any(match.names) && !any(match.managers) && !any(match.statuses)) {
+            // 有一个词在任何条目中都不出现，不需要扫描行
+            result.elapsedNs = timer.nsecsElapsed();
+            return result;
+        }
+    }
+
+    // 扫描编码列：每行每个词三次查表，不接触任何字符串
+    const int rows = table.rowCount();
+    const int kCancelCheckRows = 1 << 16;
+    for (int begin = 0; begin < rows; begin += kCancelCheckRows) {
+        if (canceled.load(std::memory_order_relaxed)) {
+            result.canceled = true;
+            result.rows.clear();
+            break;
+        }
+        const int end = qMin(rows, begin + kCancelCheckRows);
+        for (int row = begin; row < end; ++row) {
+            const size_t i = static_cast<size_t>(row);
+            bool matched = true;
+            for (const TermMatch &match : matches) {
+                matched = matched && (match.names[table.name[i]] | match.managers[table.manager[i]]
+                                      | match.statuses[table.status[i]]) != 0;
+            }
+            if (matched) {
+                result.rows.push_back(row);
+            }
+        }
+    }
+
+    result.elapsedNs = timer.nsecsElapsed();
+    return result;
+}
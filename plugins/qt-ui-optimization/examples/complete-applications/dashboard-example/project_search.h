@@ -0,0 +1,73 @@
+#ifndef PROJECT_SEARCH_H
+#define PROJECT_SEARCH_H
+
+#include <QHash>
+#include <QString>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "project_table.h"
+
+/**
+ * @brief 项目名称、负责人、状态三个文本列的三元组（trigram）索引
+ *
+ * 文本列是字典编码的，索引建立在字符串池的不同取值上而不是每一行上：
+ * 查询先用三元组倒排表找出匹配的池条目（不足3个字符时直接扫描池），
+ * 再用按池下标的查找表扫描编码列得到行号。池不变时索引一直可用，
+ * 行的增删改只影响编码列，不需要更新索引。
+ *
+ * 构建后只读，可以在多个工作线程间共享。
+ */
+class ProjectSearchIndex
+{
+public:
+    static std::shared_ptr<const ProjectSearchIndex> build(const ProjectTable &table);
+
+    // 索引是否由table的字符串池建立
+    bool covers(const ProjectTable &table) const;
+
+    // 各文本列中包含term（已折叠大小写）的池条目，match[池下标]为1
+    void matchEntries(const QString &term, std::vector<quint8> *names, std::vector<quint8> *managers,
+                      std::vector<quint8> *statuses) const;
+
+private:
+    struct ColumnIndex {
+        QStringList pool;                           // 原始池，用于判断是否需要重建
+        QStringList folded;                         // 折叠大小写后的池
+        QHash<quint64, std::vector<int>> trigrams;  // 三元组 -> 升序的池下标
+    };
+
+    static void buildColumn(ColumnIndex *column, const QStringList &pool);
+    static void matchColumn(const ColumnIndex &column, const QString &term, std::vector<quint8> *match);
+
+    ColumnIndex m_names;
+    ColumnIndex m_managers;
+    ColumnIndex m_statuses;
+};
+
+/**
+ * @brief 一次搜索的结果
+ */
+struct ProjectSearchResult
+{
+    QString query;
+    std::shared_ptr<const ProjectTable> snapshot;       // 结果中的行号属于这份数据
+    std::shared_ptr<const ProjectSearchIndex> index;    // 本次使用（或新建）的索引
+    std::vector<int> rows;                              // 匹配的行，升序
+    bool matchesAll = false;                            // 空查询：显示全部行
+    bool canceled = false;
+    qint64 elapsedNs = 0;
+};
+
+/**
+ * @brief 在snapshot中搜索query，可在工作线程中调用
+ *
+ * query按空白拆分为多个词，每个词都要在某个文本列中出现（不区分大小写）。
+ * index为空或不覆盖snapshot的字符串池时在本线程重建。
+ * canceled被置位后尽快返回canceled结果。
+ */
+ProjectSearchResult runProjectSearch(std::shared_ptr<const ProjectTable> snapshot,
+                                     std::shared_ptr<const ProjectSearchIndex> index,
+                                     const QString &query, const std::atomic<bool> &canceled);
+
+#endif // PROJECT_SEARCH_H
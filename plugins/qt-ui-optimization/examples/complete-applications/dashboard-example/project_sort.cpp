@@ -0,0 +1,152 @@
+#include "project_sort.h"
+#include <QCollator>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <algorithm>
+#include <numeric>
+
+// 少于该行数时不再分块
+static const size_t kMinRowsPerChunk = 64 * 1024;
+
+// 池中各条目的本地化排序名次
+static std::vector<quint32> poolRanks(const QStringList &pool)
+{
+    std::vector<int> order(static_cast<size_t>(pool.size()));
+    std::iota(order.begin(), order.end(), 0);
+    QCollator collator;
+    collator.setNumericMode(true);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return collator.compare(pool.at(a), pool.at(b)) < 0;
+    });
+
+    std::vector<quint32> ranks(order.size());
+    for (size_t rank = 0; rank < order.size(); ++rank) {
+        ranks[static_cast<size_t>(order[rank])] = static_cast<quint32>(rank);
+    }
+    return ranks;
+}
+
+// 有符号整数映射为保持顺序的无符号键
+static quint32 orderedKey(qint32 value)
+{
+    return static_cast<quint32>(value) ^ 0x80000000u;
+}
+
+template <typename KeyOf>
+static void fillKeys(const std::vector<int> &rows, size_t begin, size_t end, bool descending,
+                     quint64 *packed, KeyOf keyOf)
+{
+    const quint32 flip = descending ? 0xffffffffu : 0u;
+    for (size_t i = begin; i < end; ++i) {
+        const quint32 key = keyOf(static_cast<size_t>(rows[i])) ^ flip;
+        packed[i] = (quint64(key) << 32) | quint64(i);
+    }
+}
+
+namespace {
+
+struct SortChunk {
+    size_t begin;
+    size_t middle;      // 归并时前一半的结尾；分块排序时不用
+    size_t end;
+};
+
+} // namespace
+
+bool sortProjectRows(const ProjectTable &table, int column, Qt::SortOrder order, std::vector<int> *rows,
+                     const std::atomic<bool> &canceled)
+{
+    const size_t count = rows->size();
+    if (count < 2) {
+        return !canceled.load();
+    }
+
+    std::vector<quint32> ranks;
+    if (column == ProjectColumnName) {
+        ranks = poolRanks(table.namePool);
+    } else if (column == ProjectColumnManager) {
+        ranks = poolRanks(table.managerPool);
+    } else if (column == ProjectColumnStatus) {
+        ranks = poolRanks(table.statusPool);
+    }
+    const bool descending = order == Qt::DescendingOrder;
+
+    const size_t threads = static_cast<size_t>(qMax(1, QThreadPool::globalInstance()->maxThreadCount()));
+    const size_t chunkCount = qBound<size_t>(1, count / kMinRowsPerChunk, threads * 4);
+    std::vector<SortChunk> chunks;
+    for (size_t i = 0; i < chunkCount; ++i) {
+        chunks.push_back({count * i / chunkCount, 0, count * (i + 1) / chunkCount});
+    }
+
+    std::vector<quint64> packed(count);
+    std::vector<quint64> buffer(count);
+
+    // 1. 各块并行生成键并排序（整数键，std::sort即可；稳定性由位置保证）
+    QtConcurrent::blockingMap(chunks, [&](const SortChunk &chunk) {
+        if (canceled.load(std::memory_order_relaxed)) {
+            return;
+        }
+        quint64 *out = packed.data();
+        switch (column) {
+        case ProjectColumnId:
+            fillKeys(*rows, chunk.begin, chunk.end, descending, out,
+                     [&table](size_t row) { return orderedKey(table.id[row]); });
+            break;
+        case ProjectColumnName:
+            fillKeys(*rows, chunk.begin, chunk.end, descending, out,
+                     [&table, &ranks](size_t row) { return ranks[table.name[row]]; });
+            break;
+        case ProjectColumnManager:
+            fillKeys(*rows, chunk.begin, chunk.end, descending, out,
+                     [&table, &ranks](size_t row) { return ranks[table.manager[row]]; });
+            break;
+        case ProjectColumnStatus:
+            fillKeys(*rows, chunk.begin, chunk.end, descending, out,
+                     [&table, &ranks](size_t row) { return ranks[table.status[row]]; });
+            break;
+        case ProjectColumnProgress:
+            fillKeys(*rows, chunk.begin, chunk.end, descending, out,
+                     [&table](size_t row) { return quint32(table.progress[row]); });
+            break;
+        default:
+            fillKeys(*rows, chunk.begin, chunk.end, descending, out,
+                     [&table](size_t row) { return orderedKey(table.createdDay[row]); });
+            break;
+        }
+        std::sort(packed.begin() + chunk.begin, packed.begin() + chunk.end);
+    });
+
+    // 2. 相邻块两两并行归并，直到只剩一块
+    quint64 *source = packed.data();
+    quint64 *target = buffer.data();
+    while (chunks.size() > 1 && !canceled.load()) {
+        std::vector<SortChunk> merges;
+        for (size_t i = 0; i < chunks.size(); i += 2) {
+            if (i + 1 < chunks.size()) {
+                merges.push_back({chunks[i].begin, chunks[i].end, chunks[i + 1].end});
+            } else {
+                merges.push_back({chunks[i].begin, chunks[i].end, chunks[i].end});
+            }
+        }
+        QtConcurrent::blockingMap(merges, [&](const SortChunk &merge) {
+            if (canceled.load(std::memory_order_relaxed)) {
+                return;
+            }
+            std::merge(source + merge.begin, source + merge.middle, source + merge.middle, source + merge.end,
+                       target + merge.begin);
+        });
+        std::swap(source, target);
+        chunks.swap(merges);
+    }
+    if (canceled.load()) {
+        return false;
+    }
+
+    // 3. 低32位是原位置，换回行号
+    std::vector<int> sorted(count);
+    for (size_t i = 0; i < count; ++i) {
+        sorted[i] = (*rows)[static_cast<size_t>(source[i] & 0xffffffffu)];
+    }
+    rows->swap(sorted);
+    return true;
+}
@@ -0,0 +1,24 @@
+#ifndef PROJECT_SORT_H
+#define PROJECT_SORT_H
+
+#include <Qt>
+#include <atomic>
+#include <vector>
+#include "project_table.h"
+
+/**
+ * @brief 按column列对rows中的行号做并行稳定排序，可在工作线程中调用
+ *
+ * 每列先转换成32位无符号键，比较时不接触任何字符串：
+ *   - ID、进度、创建时间（儒略日）直接按数值；
+ *   - 项目名称、负责人、状态按字符串池中各条目的排序名次（QCollator，本地化顺序），
+ *     名次只对池中的不同取值计算一次。
+ * 键与行在rows中的位置拼成64位整数，分块后在线程池中并行排序，再两两并行归并；
+ * 位置作为次序保证稳定：键相同的行保持在rows中的先后（降序时也一样）。
+ *
+ * canceled被置位后尽快返回false，rows保持不变。
+ */
+bool sortProjectRows(const ProjectTable &table, int column, Qt::SortOrder order, std::vector<int> *rows,
+                     const std::atomic<bool> &canceled);
+
+#endif // PROJECT_SORT_H
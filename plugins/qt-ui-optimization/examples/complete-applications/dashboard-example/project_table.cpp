@@ -0,0 +1,223 @@
+#include "project_table.h"
+#include <QDate>
+#include <QRandomGenerator>
+#include <algorithm>
+
+// 对两张表的对应列逐一调用f(目标列, 源列)
+template <typename F>
+static void forEachColumn(ProjectTable &table, const ProjectTable &source, F f)
+{
+    f(table.id, source.id);
+    f(table.name, source.name);
+    f(table.manager, source.manager);
+    f(table.status, source.status);
+    f(table.progress, source.progress);
+    f(table.createdDay, source.createdDay);
+}
+
+void ProjectTable::reserve(int rows)
+{
+    const size_t count = static_cast<size_t>(rows);
+    id.reserve(count);
+    name.reserve(count);
+    manager.reserve(count);
+    status.reserve(count);
+    progress.reserve(count);
+    createdDay.reserve(count);
+}
+
+void ProjectTable::appendRow(const ProjectTable &source, int sourceRow)
+{
+    forEachColumn(*this, source, [sourceRow](auto &column, const auto &sourceColumn) {
+        column.push_back(sourceColumn[static_cast<size_t>(sourceRow)]);
+    });
+}
+
+void ProjectTable::insertRows(int row, const ProjectTable &source, int sourceFirst, int count)
+{
+    forEachColumn(*this, source, [=](auto &column, const auto &sourceColumn) {
+        column.insert(column.begin() + row, sourceColumn.begin() + sourceFirst,
+                      sourceColumn.begin() + sourceFirst + count);
+    });
+}
+
+void ProjectTable::copyRows(int row, const ProjectTable &source, int sourceFirst, int count)
+{
+    forEachColumn(*this, source, [=](auto &column, const auto &sourceColumn) {
+        std::copy(sourceColumn.begin() + sourceFirst, sourceColumn.begin() + sourceFirst + count,
+                  column.begin() + row);
+    });
+}
+
+void ProjectTable::removeRows(int first, int count)
+{
+    forEachColumn(*this, *this, [=](auto &column, const auto &) {
+        column.erase(column.begin() + first, column.begin() + first + count);
+    });
+}
+
+void ProjectTable::shiftRows(int first, int count, int destination)
+{
+    if (count <= 0 || first == destination) {
+        return;
+    }
+    forEachColumn(*this, *this, [=](auto &column, const auto &) {
+        if (destination < first) {
+            std::copy(column.begin() + first, column.begin() + first + count, column.begin() + destination);
+        } else {
+            std::copy_backward(column.begin() + first, column.begin() + first + count,
+                               column.begin() + destination + count);
+        }
+    });
+}
+
+void ProjectTable::resizeRows(int rows)
+{
+    forEachColumn(*this, *this, [=](auto &column, const auto &) {
+        column.resize(static_cast<size_t>(rows));
+    });
+}
+
+void ProjectTable::moveRow(int from, int destination)
+{
+    // std::rotate只搬动from与destination之间的元素
+    forEachColumn(*this, *this, [=](auto &column, const auto &) {
+        if (from < destination) {
+            std::rotate(column.begin() + from, column.begin() + from + 1, column.begin() + destination);
+        } else if (from > destination) {
+            std::rotate(column.begin() + destination, column.begin() + from, column.begin() + from + 1);
+        }
+    });
+}
+
+bool ProjectTable::sharesPoolsWith(const ProjectTable &other) const
+{
+    return namePool == other.namePool && managerPool == other.managerPool && statusPool == other.statusPool;
+}
+
+qint64 ProjectTable::columnBytes() const
+{
+    const qint64 rows = rowCount();
+    return rows * static_cast<qint64>(sizeof(qint32) + sizeof(quint16) + sizeof(quint16)
+                                      + sizeof(quint8) + sizeof(quint8) + sizeof(qint32));
+}
+
+ProjectTable generateProjectTable(int rows, quint32 seed)
+{
+    static const QStringList projects = {
+        "电商平台开发", "移动APP重构", "数据分析系统", "客户管理系统",
+        "在线教育平台", "金融交易系统", "物联网监控", "内容管理系统",
+        "人工智能助手", "区块链钱包", "云计算平台", "社交网络应用"
+    };
+    static const QStringList phases = {
+        "一期", "二期", "三期", "试点", "国际版", "企业版", "移动端", "运维",
+        "升级", "迁移", "安全加固", "性能优化", "华东", "华南", "华北", "西部"
+    };
+    static const QStringList surnames = {
+        "张", "李", "王", "赵", "钱", "孙", "周", "吴", "郑", "冯",
+        "陈", "褚", "卫", "蒋", "沈", "韩", "杨", "朱", "秦", "许"
+    };
+    static const QStringList givenNames = {
+        "伟", "芳", "娜", "敏", "静", "磊", "强", "洋", "艳", "勇",
+        "军", "杰", "娟", "涛", "明", "超", "秀英", "华", "平", "刚"
+    };
+
+    ProjectTable table;
+    for (const QString &project : projects) {
+        for (const QString &phase : phases) {
+            table.namePool.append(project + "-" + phase);
+        }
+    }
+    for (const QString &surname : surnames) {
+        for (const QString &givenName : givenNames) {
+            table.managerPool.append(surname + givenName);
+        }
+    }
+    table.statusPool = {"进行中", "已完成", "暂停", "计划中"};
+
+    QRandomGenerator generator(seed);
+    const qint32 today = static_cast<qint32>(QDate::currentDate().toJulianDay());
+    const quint32 nameCount = static_cast<quint32>(table.namePool.size());
+    const quint32 managerCount = static_cast<quint32>(table.managerPool.size());
+    const quint32 statusCount = static_cast<quint32>(table.statusPool.size());
+
+    table.reserve(rows);
+    for (int i = 0; i < rows; ++i) {
+        table.id.push_back(1001 + i);
+        table.name.push_back(static_cast<quint16>(generator.bounded(nameCount)));
+        table.manager.push_back(static_cast<quint16>(generator.bounded(managerCount)));
+        table.status.push_back(static_cast<quint8>(generator.bounded(statusCount)));
+        table.progress.push_back(static_cast<quint8>(generator.bounded(20, 100)));
+        table.createdDay.push_back(today - generator.bounded(1, 365));
+    }
+    return table;
+}
+
+ProjectTable simulateProjectUpdate(const ProjectTable &current, quint32 seed, double changeRatio)
+{
+    QRandomGenerator generator(seed);
+    const int rows = current.rowCount();
+    const int changes = qMax(1, static_cast<int>(rows * changeRatio));
+    const int removals = rows > 0 ? qMax(1, changes / 20) : 0;
+    const int insertions = qMax(1, changes / 20);
+    const int moves = qMin(changes / 50, 20);
+
+    // 删除：标记后在重建时跳过
+    std::vector<bool> removed(static_cast<size_t>(rows), false);
+    for (int i = 0; i < removals; ++i) {
+        removed[generator.bounded(static_cast<quint32>(rows))] = true;
+    }
+
+    // 新增：新ID插入到随机位置（按位置排序后在重建时依次插入）
+    ProjectTable added;
+    added.namePool = current.namePool;
+    added.managerPool = current.managerPool;
+    added.statusPool = current.statusPool;
+    qint32 nextId = rows > 0 ? *std::max_element(current.id.begin(), current.id.end()) + 1 : 1001;
+    std::vector<int> insertAt;
+    for (int i = 0; i < insertions; ++i) {
+        insertAt.push_back(static_cast<int>(generator.bounded(static_cast<quint32>(rows) + 1)));
+    }
+    std::sort(insertAt.begin(), insertAt.end());
+    const qint32 today = static_cast<qint32>(QDate::currentDate().toJulianDay());
+    for (int i = 0; i < insertions; ++i) {
+        added.id.push_back(nextId++);
+        added.name.push_back(static_cast<quint16>(generator.bounded(static_cast<quint32>(current.namePool.size()))));
+        added.manager.push_back(static_cast<quint16>(generator.bounded(static_cast<quint32>(current.managerPool.size()))));
+        added.status.push_back(static_cast<quint8>(generator.bounded(static_cast<quint32>(current.statusPool.size()))));
+        added.progress.push_back(0);
+        added.createdDay.push_back(today);
+    }
+
+    ProjectTable next;
+    next.namePool = current.namePool;
+    next.managerPool = current.managerPool;
+    next.statusPool = current.statusPool;
+    next.reserve(rows - removals + insertions);
+    size_t nextInsert = 0;
+    for (int row = 0; row <= rows; ++row) {
+        while (nextInsert < insertAt.size() && insertAt[nextInsert] == row) {
+            next.appendRow(added, static_cast<int>(nextInsert));
+            ++nextInsert;
+        }
+        if (row < rows && !removed[static_cast<size_t>(row)]) {
+            next.appendRow(current, row);
+        }
+    }
+
+    // 更新：进度变化，部分行状态变化
+    const quint32 nextRows = static_cast<quint32>(next.rowCount());
+    for (int i = 0; i < changes && nextRows > 0; ++i) {
+        const size_t row = generator.bounded(nextRows);
+        next.progress[row] = static_cast<quint8>(generator.bounded(0, 101));
+        if (generator.bounded(4) == 0) {
+            next.status[row] = static_cast<quint8>(generator.bounded(static_cast<quint32>(next.statusPool.size())));
+        }
+    }
+
+    // 位置调整
+    for (int i = 0; i < moves && nextRows > 1; ++i) {
+        next.moveRow(static_cast<int>(generator.bounded(nextRows)), static_cast<int>(generator.bounded(nextRows + 1)));
+    }
+    return next;
+}
@@ -0,0 +1,79 @@
+#ifndef PROJECT_TABLE_H
+#define PROJECT_TABLE_H
+
+#include <QStringList>
+#include <QtGlobal>
+#include <vector>
+
+/**
+ * @brief 项目表的列定义，顺序与表头一致
+ */
+enum ProjectColumn {
+    ProjectColumnId = 0,
+    ProjectColumnName,
+    ProjectColumnManager,
+    ProjectColumnStatus,
+    ProjectColumnProgress,
+    ProjectColumnCreated,
+    ProjectColumnCount
+};
+
+/**
+ * @brief 列式存储的项目数据
+ *
+ * 每列一个连续数组，文本列按字典编码（每行只存字符串池下标），
+ * 日期存儒略日，显示文本由模型在data()中按需格式化。
+ * 每行14字节，一千万行约140MB；QTableWidget每个单元格都是一个堆上的QTableWidgetItem。
+ *
+ * 不含QObject，可以整体拷贝或移动到工作线程中生成/处理。
+ */
+struct ProjectTable
+{
+    QStringList namePool;
+    QStringList managerPool;
+    QStringList statusPool;
+
+    std::vector<qint32> id;
+    std::vector<quint16> name;          // namePool下标
+    std::vector<quint16> manager;       // managerPool下标
+    std::vector<quint8> status;         // statusPool下标
+    std::vector<quint8> progress;       // 0-100
+    std::vector<qint32> createdDay;     // QDate::toJulianDay()
+
+    int rowCount() const { return static_cast<int>(id.size()); }
+
+    void reserve(int rows);
+
+    // 按行操作，同时作用于所有列；source必须与本表共用字符串池
+    void appendRow(const ProjectTable &source, int sourceRow);
+    void insertRows(int row, const ProjectTable &source, int sourceFirst, int count);
+    void copyRows(int row, const ProjectTable &source, int sourceFirst, int count);
+    void removeRows(int first, int count);
+    // 把[first, first + count)搬到destination开始的位置，两段可以重叠（memmove语义），原位置内容不确定
+    void shiftRows(int first, int count, int destination);
+    // 改变行数；新增的行内容不确定
+    void resizeRows(int rows);
+    // destination与QAbstractItemModel::beginMoveRows()的destinationChild相同：移动前的插入位置
+    void moveRow(int from, int destination);
+
+    // 字符串池相同（隐式共享时只比较指针）
+    bool sharesPoolsWith(const ProjectTable &other) const;
+
+    // 列数组占用的字节数（不含字符串池）
+    qint64 columnBytes() const;
+};
+
+/**
+ * @brief 生成示例项目数据，相同的seed生成相同的数据
+ */
+ProjectTable generateProjectTable(int rows, quint32 seed);
+
+/**
+ * @brief 模拟数据源的一次更新：在current基础上修改约changeRatio比例的行
+ *
+ * 大部分变化是进度/状态更新，另有少量删除、新增（新ID）和位置调整。
+ * 结果与current共用字符串池。
+ */
+ProjectTable simulateProjectUpdate(const ProjectTable &current, quint32 seed, double changeRatio);
+
+#endif // PROJECT_TABLE_H
@@ -0,0 +1,185 @@
+#include "project_table_diff.h"
+#include <QElapsedTimer>
+#include <QHash>
+#include <algorithm>
+
+// 目标行与当前行的非键列是否不同；不同时给出变化的列范围
+static bool changedColumns(const ProjectTable &current, int row, const ProjectTable &next, int targetRow,
+                           int *firstColumn, int *lastColumn)
+{
+    const size_t i = static_cast<size_t>(row);
+    const size_t t = static_cast<size_t>(targetRow);
+    const bool changed[ProjectColumnCount] = {
+        false,
+        current.name[i] != next.name[t],
+        current.manager[i] != next.manager[t],
+        current.status[i] != next.status[t],
+        current.progress[i] != next.progress[t],
+        current.createdDay[i] != next.createdDay[t]
+    };
+
+    *firstColumn = ProjectColumnCount;
+    *lastColumn = -1;
+    for (int column = 0; column < ProjectColumnCount; ++column) {
+        if (changed[column]) {
+            *firstColumn = qMin(*firstColumn, column);
+            *lastColumn = column;
+        }
+    }
+    return *lastColumn >= 0;
+}
+
+ProjectTableDiff diffProjectTables(const ProjectTable &current, std::shared_ptr<const ProjectTable> target,
+                                   int maxStructuralOps)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    ProjectTableDiff diff;
+    diff.target = std::move(target);
+    const ProjectTable &next = *diff.target;
+    auto finish = [&diff, &timer](bool reset) {
+        if (reset) {
+            diff.reset = true;
+            diff.ops.clear();
+        }
+        diff.elapsedNs = timer.nsecsElapsed();
+        return std::move(diff);
+    };
+
+    if (!current.sharesPoolsWith(next)) {
+        return finish(true);
+    }
+
+    const int currentRows = current.rowCount();
+    const int nextRows = next.rowCount();
+
+    QHash<qint32, int> nextRowOfId;
+    nextRowOfId.reserve(nextRows);
+    for (int t = 0; t < nextRows; ++t) {
+        nextRowOfId.insert(next.id[static_cast<size_t>(t)], t);
+    }
+
+    // 按ID匹配：targetOfCurrent[当前行] = 目标行，previousRow[目标行] = 当前行，-1表示没有对应行
+    std::vector<int> targetOfCurrent(static_cast<size_t>(currentRows), -1);
+    std::vector<int> previousRow(static_cast<size_t>(nextRows), -1);
+    std::vector<int> kept;          // 保留行的目标行号，按当前顺序
+    kept.reserve(static_cast<size_t>(qMin(currentRows, nextRows)));
+    for (int row = 0; row < currentRows; ++row) {
+        const auto it = nextRowOfId.constFind(current.id[static_cast<size_t>(row)]);
+        if (it == nextRowOfId.constEnd() || previousRow[static_cast<size_t>(*it)] >= 0) {
+            continue;
+        }
+        targetOfCurrent[static_cast<size_t>(row)] = *it;
+        previousRow[static_cast<size_t>(*it)] = row;
+        kept.push_back(*it);
+    }
+
+    // 1. 删除：从下往上，前面的行号不受影响
+    int structuralOps = 0;
+    for (int row = currentRows - 1; row >= 0;) {
+        if (targetOfCurrent[static_cast<size_t>(row)] >= 0) {
+            --row;
+            continue;
+        }
+        const int last = row;
+        while (row >= 0 && targetOfCurrent[static_cast<size_t>(row)] < 0) {
+            --row;
+        }
+        diff.ops.push_back({ProjectTableOp::Remove, row + 1, last, 0, 0, 0});
+        diff.removedRows += last - row;
+        ++structuralOps;
+    }
+
+    // 2. 移动：最长递增子序列（按目标行号）中的行保持不动，其余行逐个移到目标顺序中前一行之后
+    std::vector<int> tails;         // tails[k]：长度为k+1的递增子序列的最小结尾（kept下标）
+    std::vector<int> parent(kept.size(), -1);
+    for (size_t i = 0; i < kept.size(); ++i) {
+        const auto position = std::lower_bound(tails.begin(), tails.end(), kept[i],
+                                               [&kept](int index, int value) { return kept[static_cast<size_t>(index)] < value; });
+        parent[i] = position == tails.begin() ? -1 : *(position - 1);
+        if (position == tails.end()) {
+            tails.push_back(static_cast<int>(i));
+        } else {
+            *position = static_cast<int>(i);
+        }
+    }
+    std::vector<bool> stays(static_cast<size_t>(nextRows), false);
+    for (int i = tails.empty() ? -1 : tails.back(); i >= 0; i = parent[static_cast<size_t>(i)]) {
+        stays[static_cast<size_t>(kept[static_cast<size_t>(i)])] = true;
+    }
+    if (structuralOps + static_cast<int>(kept.size() - tails.size()) > maxStructuralOps) {
+        return finish(true);
+    }
+
+    // 在目标行号序列上模拟移动以得到每一步的实际行号；移动数已受maxStructuralOps限制
+    std::vector<int> order = kept;
+    int previousCommon = -1;
+    for (int t = 0; t < nextRows; ++t) {
+        if (previousRow[static_cast<size_t>(t)] < 0) {
+            continue;
+        }
+        if (!stays[static_cast<size_t>(t)]) {
+            const int from = static_cast<int>(std::find(order.begin(), order.end(), t) - order.begin());
+            const int destination = previousCommon < 0
+                ? 0
+                : static_cast<int>(std::find(order.begin(), order.end(), previousCommon) - order.begin()) + 1;
+            if (from != destination) {
+                diff.ops.push_back({ProjectTableOp::Move, from, from, destination, 0, 0});
+                ++diff.movedRows;
+                ++structuralOps;
+                if (from < destination) {
+                    std::rotate(order.begin() + from, order.begin() + from + 1, order.begin() + destination);
+                } else {
+                    std::rotate(order.begin() + destination, order.begin() + from, order.begin() + from + 1);
+                }
+            }
+        }
+        previousCommon = t;
+    }
+
+    // 3. 插入：从上往下，插入位置之前的行已与目标表一致，行号即目标行号
+    for (int t = 0; t < nextRows;) {
+        if (previousRow[static_cast<size_t>(t)] >= 0) {
+            ++t;
+            continue;
+        }
+        const int first = t;
+        while (t < nextRows && previousRow[static_cast<size_t>(t)] < 0) {
+            ++t;
+        }
+        diff.ops.push_back({ProjectTableOp::Insert, first, t - 1, 0, 0, 0});
+        diff.insertedRows += t - first;
+        ++structuralOps;
+    }
+    if (structuralOps > maxStructuralOps) {
+        return finish(true);
+    }
+
+    // 4. 更新：连续的变化行合并为一个dataChanged范围
+    for (int t = 0; t < nextRows;) {
+        int firstColumn = 0;
+        int lastColumn = 0;
+        const int row = previousRow[static_cast<size_t>(t)];
+        if (row < 0 || !changedColumns(current, row, next, t, &firstColumn, &lastColumn)) {
+            ++t;
+            continue;
+        }
+        const int first = t;
+        for (++t; t < nextRows; ++t) {
+            int rowFirstColumn = 0;
+            int rowLastColumn = 0;
+            const int nextPrevious = previousRow[static_cast<size_t>(t)];
+            if (nextPrevious < 0
+                || !changedColumns(current, nextPrevious, next, t, &rowFirstColumn, &rowLastColumn)) {
+                break;
+            }
+            firstColumn = qMin(firstColumn, rowFirstColumn);
+            lastColumn = qMax(lastColumn, rowLastColumn);
+        }
+        diff.ops.push_back({ProjectTableOp::Update, first, t - 1, 0, firstColumn, lastColumn});
+        diff.updatedRows += t - first;
+    }
+
+    return finish(false);
+}
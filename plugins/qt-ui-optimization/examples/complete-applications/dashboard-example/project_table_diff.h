@@ -0,0 +1,62 @@
+#ifndef PROJECT_TABLE_DIFF_H
+#define PROJECT_TABLE_DIFF_H
+
+#include <memory>
+#include <vector>
+#include "project_table.h"
+
+/**
+ * @brief 把当前表变为目标表的一步操作
+ *
+ * 行号都是应用到这一步时模型中的行号，操作必须按顺序应用：
+ * 先从下往上删除，再移动，再从上往下插入，最后更新；
+ * 插入和更新的数据取自目标表中相同行号的行。
+ */
+struct ProjectTableOp
+{
+    enum Kind {
+        Remove,     // 删除[first, last]
+        Move,       // 把first行移动到destination（beginMoveRows语义）
+        Insert,     // 在first处插入目标表[first, last]
+        Update      // 用目标表[first, last]覆盖，列范围[firstColumn, lastColumn]有变化
+    };
+
+    Kind kind;
+    int first;
+    int last;
+    int destination;
+    int firstColumn;
+    int lastColumn;
+};
+
+/**
+ * @brief 以ID为键的差异结果
+ *
+ * reset为true时（字符串池不同或结构性操作太多）直接用target重置模型。
+ */
+struct ProjectTableDiff
+{
+    std::shared_ptr<const ProjectTable> target;
+    std::vector<ProjectTableOp> ops;
+    bool reset = false;
+
+    int removedRows = 0;
+    int insertedRows = 0;
+    int movedRows = 0;
+    int updatedRows = 0;
+    qint64 elapsedNs = 0;       // 计算差异的耗时
+};
+
+/**
+ * @brief 计算current到target的差异，可在工作线程中调用
+ *
+ * 按ID列匹配行：只在current中的行删除，只在target中的行插入，
+ * 其余行中不属于最长递增子序列的移动，列值不同的更新。ID在同一张表中应唯一。
+ * 每个移动在列数组上是O(行数)的搬移（连续的删除段、插入段由ProjectTableModel::applyDiff()合并压缩），
+ * 代理有行映射时每个结构操作还要扫描一遍映射，三者数量之和超过maxStructuralOps时返回reset（整体替换更便宜）。
+ * 计算期间current不能被修改。
+ */
+ProjectTableDiff diffProjectTables(const ProjectTable &current, std::shared_ptr<const ProjectTable> target,
+                                   int maxStructuralOps);
+
+#endif // PROJECT_TABLE_DIFF_H
@@ -0,0 +1,201 @@
+#include "project_table_model.h"
+#include <QDate>
+#include <utility>
+
+ProjectTableModel::ProjectTableModel(QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_gapRow(0)
+    , m_gapSize(0)
+{
+}
+
+void ProjectTableModel::setTable(ProjectTable table)
+{
+    beginResetModel();
+    m_table = std::move(table);
+    endResetModel();
+}
+
+bool ProjectTableModel::applyDiff(const ProjectTableDiff &diff, size_t *nextOp, qint64 maxRows,
+                                  qint64 structuralOpRows)
+{
+    if (diff.reset) {
+        setTable(*diff.target);
+        *nextOp = diff.ops.size();
+        return true;
+    }
+
+    // ❌ 原来：按操作数分批，每个删除/插入段都搬移其后的全部行，一百万行时一批256段要搬移上亿行
+    // ✅ 现在：按估计搬移的行数分批，连续的删除/插入段合并为一次压缩
+    const std::vector<ProjectTableOp> &ops = diff.ops;
+    qint64 budget = maxRows;
+    bool first = true;
+    while (*nextOp < ops.size()) {
+        const ProjectTableOp &op = ops[*nextOp];
+        size_t end = *nextOp + 1;
+        qint64 cost = 0;
+        if (op.kind == ProjectTableOp::Remove || op.kind == ProjectTableOp::Insert) {
+            // 打开和合上空洞各搬移一次尾部，之后每段只搬移它与上一段之间的行；预算用完时截断该段
+            cost = rowCount() + op.last - op.first + 1 + structuralOpRows;
+            for (; end < ops.size() && ops[end].kind == op.kind; ++end) {
+                const ProjectTableOp &next = ops[end];
+                const ProjectTableOp &previous = ops[end - 1];
+                const int between = op.kind == ProjectTableOp::Remove ? previous.first - next.last - 1
+                                                                      : next.first - previous.last - 1;
+                const qint64 step = qint64(between) + next.last - next.first + 1 + structuralOpRows;
+                if (cost + step > budget) {
+                    break;
+                }
+                cost += step;
+            }
+        } else if (op.kind == ProjectTableOp::Move) {
+            cost = qAbs(op.destination - op.first) + 1 + structuralOpRows;
+        } else {
+            cost = op.last - op.first + 1;
+        }
+        if (!first && cost > budget) {
+            break;
+        }
+
+        switch (op.kind) {
+        case ProjectTableOp::Remove:
+            applyRemoveRun(ops, *nextOp, end);
+            break;
+        case ProjectTableOp::Insert:
+            applyInsertRun(*diff.target, ops, *nextOp, end);
+            break;
+        case ProjectTableOp::Move:
+            if (beginMoveRows(QModelIndex(), op.first, op.last, QModelIndex(), op.destination)) {
+                m_table.moveRow(op.first, op.destination);
+                endMoveRows();
+            }
+            break;
+        case ProjectTableOp::Update:
+            m_table.copyRows(op.first, *diff.target, op.first, op.last - op.first + 1);
+            emit dataChanged(index(op.first, op.firstColumn), index(op.last, op.lastColumn),
+                             {Qt::DisplayRole});
+            break;
+        }
+        *nextOp = end;
+        budget -= cost;
+        first = false;
+    }
+    return *nextOp == ops.size();
+}
+
+void ProjectTableModel::applyRemoveRun(const std::vector<ProjectTableOp> &ops, size_t begin, size_t end)
+{
+    // 段从下往上：空洞从第一段开始向上扩展，两段之间的行搬到空洞下方，最后一次性合上空洞
+    for (size_t i = begin; i < end; ++i) {
+        const ProjectTableOp &op = ops[i];
+        beginRemoveRows(QModelIndex(), op.first, op.last);
+        if (m_gapSize == 0) {
+            m_gapRow = op.last + 1;
+        }
+        m_table.shiftRows(op.last + 1, m_gapRow - op.last - 1, op.last + 1 + m_gapSize);
+        m_gapSize += op.last - op.first + 1;
+        m_gapRow = op.first;
+        endRemoveRows();
+    }
+    closeGap();
+}
+
+void ProjectTableModel::applyInsertRun(const ProjectTable &target, const std::vector<ProjectTableOp> &ops,
+                                       size_t begin, size_t end)
+{
+    // 段从上往下：先在第一段处打开能容纳全部新行的空洞，每段把空洞推进到插入位置后填入新行
+    int inserted = 0;
+    for (size_t i = begin; i < end; ++i) {
+        inserted += ops[i].last - ops[i].first + 1;
+    }
+    const int rows = m_table.rowCount();
+    const int gapRow = ops[begin].first;
+    m_table.resizeRows(rows + inserted);
+    m_table.shiftRows(gapRow, rows - gapRow, gapRow + inserted);
+    m_gapRow = gapRow;
+    m_gapSize = inserted;
+
+    for (size_t i = begin; i < end; ++i) {
+        const ProjectTableOp &op = ops[i];
+        const int count = op.last - op.first + 1;
+        beginInsertRows(QModelIndex(), op.first, op.last);
+        m_table.shiftRows(m_gapRow + m_gapSize, op.first - m_gapRow, m_gapRow);
+        m_table.copyRows(op.first, target, op.first, count);
+        m_gapRow = op.first + count;
+        m_gapSize -= count;
+        endInsertRows();
+    }
+}
+
+void ProjectTableModel::closeGap()
+{
+    const int rows = m_table.rowCount();
+    m_table.shiftRows(m_gapRow + m_gapSize, rows - m_gapRow - m_gapSize, m_gapRow);
+    m_table.resizeRows(rows - m_gapSize);
+    m_gapRow = 0;
+    m_gapSize = 0;
+}
+
+int ProjectTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_table.rowCount() - m_gapSize;
+}
+
+int ProjectTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ProjectColumnCount;
+}
+
+QVariant ProjectTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= rowCount()) {
+        return QVariant();
+    }
+
+    switch (role) {
+    case Qt::DisplayRole:
+        return displayText(index.row(), index.column());
+    case Qt::TextAlignmentRole:
+        if (index.column() == ProjectColumnId || index.column() == ProjectColumnProgress) {
+            return int(Qt::AlignRight | Qt::AlignVCenter);
+        }
+        return int(Qt::AlignLeft | Qt::AlignVCenter);
+    default:
+        return QVariant();
+    }
+}
+
+QVariant ProjectTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    if (orientation == Qt::Vertical) {
+        return section + 1;
+    }
+
+    static const QStringList headers = {"ID", "项目名称", "负责人", "状态", "进度", "创建时间"};
+    return headers.value(section);
+}
+
+QString ProjectTableModel::displayText(int row, int column) const
+{
+    const size_t i = static_cast<size_t>(storageRow(row));
+    switch (column) {
+    case ProjectColumnId:
+        return QString::number(m_table.id[i]);
+    case ProjectColumnName:
+        // 字符串池中的QString隐式共享，返回时不复制字符
+        return m_table.namePool.at(m_table.name[i]);
+    case ProjectColumnManager:
+        return m_table.managerPool.at(m_table.manager[i]);
+    case ProjectColumnStatus:
+        return m_table.statusPool.at(m_table.status[i]);
+    case ProjectColumnProgress:
+        return QString("%1%").arg(m_table.progress[i]);
+    case ProjectColumnCreated:
+        return QDate::fromJulianDay(m_table.createdDay[i]).toString(Qt::ISODate);
+    default:
+        return QString();
+    }
+}
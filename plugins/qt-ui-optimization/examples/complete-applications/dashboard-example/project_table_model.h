@@ -0,0 +1,58 @@
+#ifndef PROJECT_TABLE_MODEL_H
+#define PROJECT_TABLE_MODEL_H
+
+#include <QAbstractTableModel>
+#include "project_table.h"
+#include "project_table_diff.h"
+
+/**
+ * @brief 基于列式存储ProjectTable的只读表格模型
+ *
+ * 不为单元格创建任何对象：视图只对可见单元格调用data()，
+ * 显示文本在此时由列数组格式化，因此行数到千万级时滚动开销只取决于可见行数。
+ * 配合固定行高的QTableView使用（见Dashboard::setupMainContent()）。
+ */
+class ProjectTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    explicit ProjectTableModel(QObject *parent = nullptr);
+
+    // 整体替换数据（重置模型）
+    void setTable(ProjectTable table);
+    // applyDiff()执行期间（模型信号的槽函数中）不一致，应通过data()/displayText()读取
+    const ProjectTable &table() const { return m_table; }
+
+    /**
+     * @brief 从diff.ops[*nextOp]开始应用，估计搬移的行数用完maxRows时停止，全部应用完时返回true
+     *
+     * 只发出对应的行插入/删除/移动和dataChanged，视图的选择、滚动位置和缓存都保留。
+     * 连续的删除段（或插入段）在列数组上一次压缩完成，整段的代价是O(行数)而不是O(行数×段数)；
+     * 移动按搬移距离计，更新按行数计。每个结构操作另计structuralOpRows
+     * （例如代理的行映射长度：代理要为每个结构操作扫描一遍映射）。至少应用一步。
+     * diff必须基于当前数据计算，并且在全部应用完之前不能有其他修改。
+     */
+    bool applyDiff(const ProjectTableDiff &diff, size_t *nextOp, qint64 maxRows, qint64 structuralOpRows = 0);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    // 单元格的显示文本，供data()和导出等需要文本的场合使用
+    QString displayText(int row, int column) const;
+
+private:
+    // 删除段/插入段批量执行期间，m_table中[m_gapRow, m_gapRow + m_gapSize)是不属于任何行的空洞
+    int storageRow(int row) const { return row < m_gapRow ? row : row + m_gapSize; }
+    void applyRemoveRun(const std::vector<ProjectTableOp> &ops, size_t begin, size_t end);
+    void applyInsertRun(const ProjectTable &target, const std::vector<ProjectTableOp> &ops, size_t begin, size_t end);
+    void closeGap();
+
+    ProjectTable m_table;
+    int m_gapRow;
+    int m_gapSize;
+};
+
+#endif // PROJECT_TABLE_MODEL_H
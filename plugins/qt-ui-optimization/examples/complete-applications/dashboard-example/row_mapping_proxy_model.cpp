@@ -0,0 +1,314 @@
+#include "row_mapping_proxy_model.h"
+
+// dataChanged范围超过该行数时不逐行转换，直接通知整列范围
+static const int kMaxRowsPerDataChanged = 1024;
+
+RowMappingProxyModel::RowMappingProxyModel(QObject *parent)
+    : QAbstractProxyModel(parent)
+    , m_mapped(false)
+    , m_inverseValid(false)
+{
+}
+
+void RowMappingProxyModel::setSourceModel(QAbstractItemModel *sourceModel)
+{
+    beginResetModel();
+    for (const QMetaObject::Connection &connection : m_sourceConnections) {
+        disconnect(connection);
+    }
+    m_sourceConnections.clear();
+    m_mapped = false;
+    m_sourceRows.clear();
+    m_inverseValid = false;
+
+    QAbstractProxyModel::setSourceModel(sourceModel);
+    if (sourceModel) {
+        m_sourceConnections
+            << connect(sourceModel, &QAbstractItemModel::rowsAboutToBeInserted,
+                       this, &RowMappingProxyModel::onSourceRowsAboutToBeInserted)
+            << connect(sourceModel, &QAbstractItemModel::rowsInserted,
+                       this, &RowMappingProxyModel::onSourceRowsInserted)
+            << connect(sourceModel, &QAbstractItemModel::rowsAboutToBeRemoved,
+                       this, &RowMappingProxyModel::onSourceRowsAboutToBeRemoved)
+            << connect(sourceModel, &QAbstractItemModel::rowsRemoved,
+                       this, &RowMappingProxyModel::onSourceRowsRemoved)
+            << connect(sourceModel, &QAbstractItemModel::rowsAboutToBeMoved,
+                       this, &RowMappingProxyModel::onSourceRowsAboutToBeMoved)
+            << connect(sourceModel, &QAbstractItemModel::rowsMoved,
+                       this, &RowMappingProxyModel::onSourceRowsMoved)
+            << connect(sourceModel, &QAbstractItemModel::dataChanged,
+                       this, &RowMappingProxyModel::onSourceDataChanged)
+            << connect(sourceModel, &QAbstractItemModel::modelAboutToBeReset,
+                       this, &RowMappingProxyModel::onSourceAboutToBeReset)
+            << connect(sourceModel, &QAbstractItemModel::modelReset,
+                       this, &RowMappingProxyModel::onSourceReset)
+            << connect(sourceModel, &QAbstractItemModel::layoutAboutToBeChanged,
+                       this, &RowMappingProxyModel::onSourceAboutToBeReset)
+            << connect(sourceModel, &QAbstractItemModel::layoutChanged,
+                       this, &RowMappingProxyModel::onSourceReset)
+            << connect(sourceModel, &QAbstractItemModel::headerDataChanged,
+                       this, &QAbstractItemModel::headerDataChanged);
+    }
+    endResetModel();
+}
+
+void RowMappingProxyModel::setRowMapping(std::vector<int> sourceRows)
+{
+    replaceMapping(true, std::move(sourceRows));
+}
+
+void RowMappingProxyModel::clearRowMapping()
+{
+    if (m_mapped) {
+        replaceMapping(false, std::vector<int>());
+    }
+}
+
+void RowMappingProxyModel::replaceMapping(bool mapped, std::vector<int> sourceRows)
+{
+    emit layoutAboutToBeChanged();
+
+    // 持久索引（选择、当前项）先换算成源行，换上新映射后再换算回代理行
+    const QModelIndexList oldPersistent = persistentIndexList();
+    std::vector<int> persistentSourceRows;
+    persistentSourceRows.reserve(static_cast<size_t>(oldPersistent.size()));
+    for (const QModelIndex &index : oldPersistent) {
+        const QModelIndex source = mapToSource(index);
+        persistentSourceRows.push_back(source.isValid() ? source.row() : -1);
+    }
+
+    m_mapped = mapped;
+    m_sourceRows = std::move(sourceRows);
+    m_inverseValid = false;
+    if (!m_mapped) {
+        std::vector<int>().swap(m_proxyRowOfSource);
+    }
+
+    QModelIndexList newPersistent;
+    newPersistent.reserve(oldPersistent.size());
+    for (int i = 0; i < oldPersistent.size(); ++i) {
+        const int sourceRow = persistentSourceRows[static_cast<size_t>(i)];
+        const int proxyRow = sourceRow < 0 ? -1 : proxyRowOf(sourceRow);
+        newPersistent << (proxyRow < 0 ? QModelIndex() : createIndex(proxyRow, oldPersistent.at(i).column()));
+    }
+    changePersistentIndexList(oldPersistent, newPersistent);
+
+    emit layoutChanged();
+}
+
+int RowMappingProxyModel::proxyRowOf(int sourceRow) const
+{
+    if (!m_mapped) {
+        return sourceRow;
+    }
+    if (!m_inverseValid) {
+        const int sourceRows = sourceModel() ? sourceModel()->rowCount() : 0;
+        m_proxyRowOfSource.assign(static_cast<size_t>(sourceRows), -1);
+        for (size_t proxyRow = 0; proxyRow < m_sourceRows.size(); ++proxyRow) {
+            const int row = m_sourceRows[proxyRow];
+            if (row >= 0 && row < sourceRows) {
+                m_proxyRowOfSource[static_cast<size_t>(row)] = static_cast<int>(proxyRow);
+            }
+        }
+        m_inverseValid = true;
+    }
+    return sourceRow >= 0 && sourceRow < static_cast<int>(m_proxyRowOfSource.size())
+        ? m_proxyRowOfSource[static_cast<size_t>(sourceRow)]
+        : -1;
+}
+
+QModelIndex RowMappingProxyModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (parent.isValid() || row < 0 || column < 0 || row >= rowCount() || column >= columnCount()) {
+        return QModelIndex();
+    }
+    return createIndex(row, column);
+}
+
+QModelIndex RowMappingProxyModel::parent(const QModelIndex &child) const
+{
+    Q_UNUSED(child);
+    return QModelIndex();
+}
+
+int RowMappingProxyModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid() || !sourceModel()) {
+        return 0;
+    }
+    return m_mapped ? static_cast<int>(m_sourceRows.size()) : sourceModel()->rowCount();
+}
+
+int RowMappingProxyModel::columnCount(const QModelIndex &parent) const
+{
+    if (parent.isValid() || !sourceModel()) {
+        return 0;
+    }
+    return sourceModel()->columnCount();
+}
+
+QModelIndex RowMappingProxyModel::mapToSource(const QModelIndex &proxyIndex) const
+{
+    if (!proxyIndex.isValid() || !sourceModel() || proxyIndex.row() >= rowCount()) {
+        return QModelIndex();
+    }
+    const int sourceRow = m_mapped ? m_sourceRows[static_cast<size_t>(proxyIndex.row())] : proxyIndex.row();
+    return sourceModel()->index(sourceRow, proxyIndex.column());
+}
+
+QModelIndex RowMappingProxyModel::mapFromSource(const QModelIndex &sourceIndex) const
+{
+    if (!sourceIndex.isValid()) {
+        return QModelIndex();
+    }
+    const int proxyRow = proxyRowOf(sourceIndex.row());
+    return proxyRow < 0 ? QModelIndex() : createIndex(proxyRow, sourceIndex.column());
+}
+
+void RowMappingProxyModel::onSourceRowsAboutToBeInserted(const QModelIndex &parent, int first, int last)
+{
+    if (!parent.isValid() && !m_mapped) {
+        beginInsertRows(QModelIndex(), first, last);
+    }
+}
+
+void RowMappingProxyModel::onSourceRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid()) {
+        return;
+    }
+    if (!m_mapped) {
+        endInsertRows();
+        return;
+    }
+    const int count = last - first + 1;
+    for (int &row : m_sourceRows) {
+        if (row >= first) {
+            row += count;
+        }
+    }
+    m_inverseValid = false;
+}
+
+void RowMappingProxyModel::onSourceRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid()) {
+        return;
+    }
+    if (!m_mapped) {
+        beginRemoveRows(QModelIndex(), first, last);
+        return;
+    }
+
+    // 对应的代理行可能不连续：按连续段从后往前删除，源行此时还在，映射保持一致
+    std::vector<int> proxyRows;
+    for (size_t proxyRow = 0; proxyRow < m_sourceRows.size(); ++proxyRow) {
+        if (m_sourceRows[proxyRow] >= first && m_sourceRows[proxyRow] <= last) {
+            proxyRows.push_back(static_cast<int>(proxyRow));
+        }
+    }
+    for (size_t end = proxyRows.size(); end > 0;) {
+        size_t begin = end - 1;
+        while (begin > 0 && proxyRows[begin - 1] == proxyRows[begin] - 1) {
+            --begin;
+        }
+        beginRemoveRows(QModelIndex(), proxyRows[begin], proxyRows[end - 1]);
+        m_sourceRows.erase(m_sourceRows.begin() + proxyRows[begin], m_sourceRows.begin() + proxyRows[end - 1] + 1);
+        m_inverseValid = false;
+        endRemoveRows();
+        end = begin;
+    }
+}
+
+void RowMappingProxyModel::onSourceRowsRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid()) {
+        return;
+    }
+    if (!m_mapped) {
+        endRemoveRows();
+        return;
+    }
+    const int count = last - first + 1;
+    for (int &row : m_sourceRows) {
+        if (row > last) {
+            row -= count;
+        }
+    }
+    m_inverseValid = false;
+}
+
+void RowMappingProxyModel::onSourceRowsAboutToBeMoved(const QModelIndex &sourceParent, int start, int end,
+                                                      const QModelIndex &destinationParent, int destination)
+{
+    if (!sourceParent.isValid() && !destinationParent.isValid() && !m_mapped) {
+        beginMoveRows(QModelIndex(), start, end, QModelIndex(), destination);
+    }
+}
+
+void RowMappingProxyModel::onSourceRowsMoved(const QModelIndex &sourceParent, int start, int end,
+                                             const QModelIndex &destinationParent, int destination)
+{
+    if (sourceParent.isValid() || destinationParent.isValid()) {
+        return;
+    }
+    if (!m_mapped) {
+        endMoveRows();
+        return;
+    }
+
+    // destination是移动前的插入位置（beginMoveRows语义）
+    const int count = end - start + 1;
+    for (int &row : m_sourceRows) {
+        if (row >= start && row <= end) {
+            row = destination > end ? row - start + destination - count : row - start + destination;
+        } else if (destination > end && row > end && row < destination) {
+            row -= count;
+        } else if (destination < start && row >= destination && row < start) {
+            row += count;
+        }
+    }
+    m_inverseValid = false;
+}
+
+void RowMappingProxyModel::onSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                                               const QVector<int> &roles)
+{
+    if (!topLeft.isValid() || !bottomRight.isValid() || topLeft.parent().isValid()) {
+        return;
+    }
+    if (!m_mapped) {
+        emit dataChanged(createIndex(topLeft.row(), topLeft.column()),
+                         createIndex(bottomRight.row(), bottomRight.column()), roles);
+        return;
+    }
+
+    if (bottomRight.row() - topLeft.row() >= kMaxRowsPerDataChanged) {
+        if (rowCount() > 0) {
+            emit dataChanged(createIndex(0, topLeft.column()),
+                             createIndex(rowCount() - 1, bottomRight.column()), roles);
+        }
+        return;
+    }
+    for (int sourceRow = topLeft.row(); sourceRow <= bottomRight.row(); ++sourceRow) {
+        const int proxyRow = proxyRowOf(sourceRow);
+        if (proxyRow >= 0) {
+            emit dataChanged(createIndex(proxyRow, topLeft.column()),
+                             createIndex(proxyRow, bottomRight.column()), roles);
+        }
+    }
+}
+
+void RowMappingProxyModel::onSourceAboutToBeReset()
+{
+    beginResetModel();
+}
+
+void RowMappingProxyModel::onSourceReset()
+{
+    m_mapped = false;
+    m_sourceRows.clear();
+    std::vector<int>().swap(m_proxyRowOfSource);
+    m_inverseValid = false;
+    endResetModel();
+}
@@ -0,0 +1,67 @@
+#ifndef ROW_MAPPING_PROXY_MODEL_H
+#define ROW_MAPPING_PROXY_MODEL_H
+
+#include <QAbstractProxyModel>
+#include <vector>
+
+/**
+ * @brief 按给定源行号列表显示表格模型的代理
+ *
+ * 行映射（搜索结果、排序等）在工作线程中算好后通过setRowMapping()一次性替换，
+ * 代理本身不做任何过滤或比较，因此替换和取数都不会卡住GUI线程。
+ * 没有映射时是恒等代理，直接转发源模型的所有变化。
+ *
+ * 有映射时源模型的行变化按以下方式处理：
+ *   - 删除：对应的代理行随之删除；
+ *   - 插入：已有映射的源行号后移，新行不显示，直到下一次setRowMapping()；
+ *   - 移动：源行号随之调整，代理行顺序不变；
+ *   - 重置或布局变化：映射失效，回到恒等映射（恒等时也按重置转发布局变化）。
+ * 每次行变化的代价与映射长度成正比。
+ */
+class RowMappingProxyModel : public QAbstractProxyModel
+{
+    Q_OBJECT
+
+public:
+    explicit RowMappingProxyModel(QObject *parent = nullptr);
+
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
+
+    // 以sourceRows的顺序显示这些源行；选择等持久索引按源行保留
+    void setRowMapping(std::vector<int> sourceRows);
+    void clearRowMapping();
+    bool hasRowMapping() const { return m_mapped; }
+    const std::vector<int> &rowMapping() const { return m_sourceRows; }
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex mapToSource(const QModelIndex &proxyIndex) const override;
+    QModelIndex mapFromSource(const QModelIndex &sourceIndex) const override;
+
+private:
+    void replaceMapping(bool mapped, std::vector<int> sourceRows);
+    int proxyRowOf(int sourceRow) const;
+
+    void onSourceRowsAboutToBeInserted(const QModelIndex &parent, int first, int last);
+    void onSourceRowsInserted(const QModelIndex &parent, int first, int last);
+    void onSourceRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+    void onSourceRowsRemoved(const QModelIndex &parent, int first, int last);
+    void onSourceRowsAboutToBeMoved(const QModelIndex &sourceParent, int start, int end,
+                                    const QModelIndex &destinationParent, int destination);
+    void onSourceRowsMoved(const QModelIndex &sourceParent, int start, int end,
+                           const QModelIndex &destinationParent, int destination);
+    void onSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                             const QVector<int> &roles);
+    void onSourceAboutToBeReset();
+    void onSourceReset();
+
+    bool m_mapped;
+    std::vector<int> m_sourceRows;                  // 代理行 -> 源行
+    mutable std::vector<int> m_proxyRowOfSource;    // 源行 -> 代理行（-1为不显示），按需重建
+    mutable bool m_inverseValid;
+    QVector<QMetaObject::Connection> m_sourceConnections;
+};
+
+#endif // ROW_MAPPING_PROXY_MODEL_H
@@ -0,0 +1,390 @@
+/**
+ * @file table_benchmark.cpp
+ * @brief 项目表格的内存与滚动延迟对比：QTableWidget（原实现）与ProjectTableModel + QTableView
+ *
+ * 每种实现测量：
+ *   - 填充耗时（QTableWidget逐格setItem / 模型setTable）
+ *   - 常驻内存增量（Linux读取/proc/self/statm，其他平台不统计）
+ *   - 滚动延迟：随机跳转和逐行滚动各200次，每次设置滚动条后同步重绘视口，统计p50/p99/max
+ * 先测模型（列数组释放后内存归还系统），最后测QTableWidget（大量小对象释放后内存通常不归还）。
+ *
+ * 另外在Dashboard的行数（一百万）上对比一次约1%行变化的刷新：按ID差异增量应用
+ * （ProjectTableModel::applyDiff，按Dashboard的每批行数限额分批，统计批数和最长一批）与整体重置（setTable），
+ * 并检查刷新后选择和滚动位置是否保留。
+ *
+ * 搜索：在一百万行（与模型第一项行数相同）上对一组典型查询计时runProjectSearch（工作线程部分），
+ * 以及把结果交给RowMappingProxyModel并重绘的GUI线程耗时。
+ *
+ * 排序：在五百万行上对每一列在工作线程调用sortProjectRows，期间GUI线程运行1 ms定时器，
+ * 统计相邻两次定时器之间的最大间隔（界面最长无响应时间）；另测排序开始后取消到结束的等待时间。
+ *
+ * 用法: table_benchmark [-platform offscreen] [模型行数=1000000,10000000] [QTableWidget行数=200000]
+ *                       [刷新行数=1000000] [排序行数=5000000]
+ */
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHeaderView>
+#include <QItemSelectionModel>
+#include <QRandomGenerator>
+#include <QScrollBar>
+#include <QTableView>
+#include <QTableWidget>
+#include <QThread>
+#include <QTimer>
+#include <QtConcurrent>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+#include "project_search.h"
+#include "project_sort.h"
+#include "project_table_model.h"
+#include "row_mapping_proxy_model.h"
+
+static qint64 residentBytes()
+{
+#ifdef Q_OS_LINUX
+    QFile statm("/proc/self/statm");
+    if (statm.open(QIODevice::ReadOnly)) {
+        const QList<QByteArray> fields = statm.readAll().split(' ');
+        if (fields.size() > 1) {
+            return fields.at(1).toLongLong() * sysconf(_SC_PAGESIZE);
+        }
+    }
+#endif
+    return -1;
+}
+
+static void configureView(QTableView *view)
+{
+    view->resize(1200, 800);
+    view->horizontalHeader()->setStretchLastSection(true);
+    view->horizontalHeader()->setDefaultSectionSize(120);
+}
+
+// 与Dashboard相同的固定行高设置
+static void configureUniformRows(QTableView *view)
+{
+    view->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    view->verticalHeader()->setDefaultSectionSize(28);
+    view->verticalHeader()->hide();
+    view->setWordWrap(false);
+}
+
+struct ScrollLatency {
+    double p50Ms = 0;
+    double p99Ms = 0;
+    double maxMs = 0;
+};
+
+static ScrollLatency summarize(std::vector<qint64> &samplesNs)
+{
+    ScrollLatency latency;
+    if (samplesNs.empty()) {
+        return latency;
+    }
+    std::sort(samplesNs.begin(), samplesNs.end());
+    auto at = [&samplesNs](double percentile) {
+        const size_t index = static_cast<size_t>(percentile / 100.0 * (samplesNs.size() - 1));
+        return samplesNs[index] / 1e6;
+    };
+    latency.p50Ms = at(50.0);
+    latency.p99Ms = at(99.0);
+    latency.maxMs = samplesNs.back() / 1e6;
+    return latency;
+}
+
+static void measureScroll(QTableView *view, ScrollLatency *jump, ScrollLatency *step)
+{
+    view->show();
+    QApplication::processEvents();
+
+    QScrollBar *scrollBar = view->verticalScrollBar();
+    QRandomGenerator generator(7);
+    QElapsedTimer timer;
+    std::vector<qint64> samples;
+
+    for (int i = 0; i < 200; ++i) {
+        const int target = scrollBar->maximum() > 0 ? generator.bounded(scrollBar->maximum()) : 0;
+        timer.start();
+        scrollBar->setValue(target);
+        view->viewport()->repaint();
+        samples.push_back(timer.nsecsElapsed());
+    }
+    *jump = summarize(samples);
+
+    samples.clear();
+    scrollBar->setValue(scrollBar->maximum() / 2);
+    view->viewport()->repaint();
+    for (int i = 0; i < 200; ++i) {
+        timer.start();
+        scrollBar->setValue(scrollBar->value() + scrollBar->singleStep());
+        view->viewport()->repaint();
+        samples.push_back(timer.nsecsElapsed());
+    }
+    *step = summarize(samples);
+
+    view->hide();
+}
+
+static void report(const char *name, int rows, qint64 fillNs, qint64 memoryBytes,
+                   const ScrollLatency &jump, const ScrollLatency &step)
+{
+    std::printf("%-12s %9d rows  fill %9.1f ms  rss %+9.1f MB  jump p50/p99/max %6.2f/%6.2f/%6.2f ms  "
+                "step p50/p99/max %6.2f/%6.2f/%6.2f ms\n",
+                name, rows, fillNs / 1e6, memoryBytes >= 0 ? memoryBytes / 1048576.0 : 0.0,
+                jump.p50Ms, jump.p99Ms, jump.maxMs, step.p50Ms, step.p99Ms, step.maxMs);
+    std::fflush(stdout);
+}
+
+static void runModel(int rows)
+{
+    const qint64 before = residentBytes();
+    QElapsedTimer timer;
+    timer.start();
+
+    ProjectTableModel model;
+    model.setTable(generateProjectTable(rows, 42));
+    QTableView view;
+    configureView(&view);
+    configureUniformRows(&view);
+    view.setModel(&model);
+    const qint64 fillNs = timer.nsecsElapsed();
+    const qint64 after = residentBytes();
+
+    ScrollLatency jump;
+    ScrollLatency step;
+    measureScroll(&view, &jump, &step);
+    report("model/view", rows, fillNs, before >= 0 ? after - before : -1, jump, step);
+}
+
+static void runWidget(int rows)
+{
+    // 文本来源与模型相同，只比较存储和视图方式
+    ProjectTableModel source;
+    source.setTable(generateProjectTable(rows, 42));
+
+    const qint64 before = residentBytes();
+    QElapsedTimer timer;
+    timer.start();
+
+    QTableWidget table(rows, ProjectColumnCount);
+    configureView(&table);
+    table.setHorizontalHeaderLabels({"ID", "项目名称", "负责人", "状态", "进度", "创建时间"});
+    table.setAlternatingRowColors(true);
+    table.setSelectionBehavior(QAbstractItemView::SelectRows);
+    for (int row = 0; row < rows; ++row) {
+        for (int column = 0; column < ProjectColumnCount; ++column) {
+            table.setItem(row, column, new QTableWidgetItem(source.displayText(row, column)));
+        }
+    }
+    const qint64 fillNs = timer.nsecsElapsed();
+    const qint64 after = residentBytes();
+
+    ScrollLatency jump;
+    ScrollLatency step;
+    measureScroll(&table, &jump, &step);
+    report("QTableWidget", rows, fillNs, before >= 0 ? after - before : -1, jump, step);
+}
+
+static void runRefresh(int rows)
+{
+    ProjectTableModel model;
+    model.setTable(generateProjectTable(rows, 42));
+    QTableView view;
+    configureView(&view);
+    configureUniformRows(&view);
+    view.setSelectionBehavior(QAbstractItemView::SelectRows);
+    view.setModel(&model);
+    view.show();
+    QApplication::processEvents();
+
+    auto next = std::make_shared<const ProjectTable>(simulateProjectUpdate(model.table(), 7, 0.01));
+
+    // 增量：选中并滚动到中间一行，刷新后检查是否仍然选中且可见
+    const int middle = rows / 2;
+    view.selectRow(middle);
+    view.scrollTo(model.index(middle, 0), QAbstractItemView::PositionAtCenter);
+    const qint32 selectedId = model.table().id[static_cast<size_t>(middle)];
+
+    const ProjectTableDiff diff = diffProjectTables(model.table(), next, 2000);
+    // 与Dashboard相同：每批最多搬移400万行，每批之间视图可以处理事件
+    QElapsedTimer timer;
+    QElapsedTimer batchTimer;
+    timer.start();
+    size_t nextOp = 0;
+    int batches = 0;
+    qint64 maxBatchNs = 0;
+    bool done = false;
+    while (!done) {
+        batchTimer.start();
+        done = model.applyDiff(diff, &nextOp, 4000000);
+        maxBatchNs = qMax(maxBatchNs, batchTimer.nsecsElapsed());
+        ++batches;
+    }
+    view.viewport()->repaint();
+    const qint64 applyNs = timer.nsecsElapsed();
+
+    const QModelIndexList selected = view.selectionModel()->selectedRows();
+    const bool selectionKept = selected.size() == 1
+        && model.table().id[static_cast<size_t>(selected.first().row())] == selectedId;
+    const bool stillVisible = selectionKept
+        && view.viewport()->rect().intersects(view.visualRect(selected.first()));
+
+    std::printf("refresh      %9d rows  diff (worker) %7.2f ms  apply+repaint %7.2f ms  batches %d (max %6.2f ms)  "
+                "ops %zu  +%d -%d moved %d updated %d%s  selection %s, %s\n",
+                rows, diff.elapsedNs / 1e6, applyNs / 1e6, batches, maxBatchNs / 1e6, diff.ops.size(), diff.insertedRows,
+                diff.removedRows, diff.movedRows, diff.updatedRows, diff.reset ? " (reset)" : "",
+                selectionKept ? "kept" : "lost", stillVisible ? "visible" : "scrolled away");
+
+    // 整体重置（原来的刷新方式）
+    ProjectTable replacement = *next;
+    view.selectRow(middle);
+    timer.start();
+    model.setTable(std::move(replacement));
+    view.viewport()->repaint();
+    const qint64 resetNs = timer.nsecsElapsed();
+    std::printf("reset        %9d rows  setTable+repaint %7.2f ms  selection %s\n",
+                rows, resetNs / 1e6, view.selectionModel()->hasSelection() ? "kept" : "lost");
+    std::fflush(stdout);
+}
+
+static void runSearch(int rows)
+{
+    auto snapshot = std::make_shared<const ProjectTable>(generateProjectTable(rows, 42));
+    ProjectTableModel model;
+    model.setTable(*snapshot);
+    RowMappingProxyModel proxy;
+    proxy.setSourceModel(&model);
+    QTableView view;
+    configureView(&view);
+    configureUniformRows(&view);
+    view.setModel(&proxy);
+    view.show();
+    QApplication::processEvents();
+
+    const QStringList queries = {"张", "张伟", "电商", "平台-华东", "进行中", "李 暂停", "华东 张 进行", "不存在的项目"};
+    std::atomic<bool> canceled(false);
+    std::shared_ptr<const ProjectSearchIndex> index;
+    for (const QString &query : queries) {
+        ProjectSearchResult result = runProjectSearch(snapshot, index, query, canceled);
+        const bool built = !index;
+        index = result.index;
+        const size_t matched = result.rows.size();
+
+        QElapsedTimer timer;
+        timer.start();
+        proxy.setRowMapping(std::move(result.rows));
+        view.viewport()->repaint();
+        const qint64 applyNs = timer.nsecsElapsed();
+
+        std::printf("search       %9d rows  %-14s %8zu matches  query (worker) %6.2f ms%s  apply+repaint %6.2f ms\n",
+                    rows, qPrintable(query), matched, result.elapsedNs / 1e6, built ? " (with index build)" : "",
+                    applyNs / 1e6);
+    }
+    std::fflush(stdout);
+}
+
+static void runSort(int rows)
+{
+    auto snapshot = std::make_shared<const ProjectTable>(generateProjectTable(rows, 42));
+    ProjectTableModel model;
+    model.setTable(*snapshot);
+    RowMappingProxyModel proxy;
+    proxy.setSourceModel(&model);
+    QTableView view;
+    configureView(&view);
+    configureUniformRows(&view);
+    view.setModel(&proxy);
+    view.show();
+    QApplication::processEvents();
+
+    for (int column = 0; column < ProjectColumnCount; ++column) {
+        std::atomic<bool> canceled(false);
+        QElapsedTimer timer;
+        timer.start();
+        QFuture<std::vector<int>> future = QtConcurrent::run([snapshot, column, &canceled]() {
+            std::vector<int> sorted(static_cast<size_t>(snapshot->rowCount()));
+            std::iota(sorted.begin(), sorted.end(), 0);
+            sortProjectRows(*snapshot, column, Qt::AscendingOrder, &sorted, canceled);
+            return sorted;
+        });
+
+        // 排序期间GUI线程的事件循环：记录两次定时器之间的最大间隔
+        qint64 lastTickNs = timer.nsecsElapsed();
+        qint64 maxGapNs = 0;
+        QTimer tick;
+        tick.setInterval(1);
+        QObject::connect(&tick, &QTimer::timeout, [&]() {
+            const qint64 now = timer.nsecsElapsed();
+            maxGapNs = qMax(maxGapNs, now - lastTickNs);
+            lastTickNs = now;
+        });
+        tick.start();
+        while (!future.isFinished()) {
+            QApplication::processEvents(QEventLoop::AllEvents, 5);
+        }
+        tick.stop();
+        const qint64 sortNs = timer.nsecsElapsed();
+
+        timer.restart();
+        proxy.setRowMapping(future.result());
+        view.viewport()->repaint();
+        const qint64 applyNs = timer.nsecsElapsed();
+
+        // 开始后很快被新的请求取消
+        std::atomic<bool> superseded(false);
+        QFuture<bool> canceledRun = QtConcurrent::run([snapshot, column, &superseded]() {
+            std::vector<int> sorted(static_cast<size_t>(snapshot->rowCount()));
+            std::iota(sorted.begin(), sorted.end(), 0);
+            return sortProjectRows(*snapshot, column, Qt::DescendingOrder, &sorted, superseded);
+        });
+        QThread::msleep(10);
+        timer.restart();
+        superseded.store(true);
+        canceledRun.waitForFinished();
+        const qint64 cancelNs = timer.nsecsElapsed();
+
+        std::printf("sort         %9d rows  %-10s sort (worker) %7.2f ms  max GUI stall %5.2f ms  "
+                    "apply+repaint %6.2f ms  cancel %6.2f ms\n",
+                    rows, qPrintable(model.headerData(column, Qt::Horizontal).toString()), sortNs / 1e6,
+                    maxGapNs / 1e6, applyNs / 1e6, cancelNs / 1e6);
+        std::fflush(stdout);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QApplication app(argc, argv);
+    const QStringList arguments = app.arguments();
+
+    QList<int> modelRows = {1000000, 10000000};
+    if (arguments.size() > 1) {
+        modelRows.clear();
+        for (const QString &value : arguments.at(1).split(',')) {
+            modelRows.append(value.toInt());
+        }
+    }
+    const int widgetRows = arguments.size() > 2 ? arguments.at(2).toInt() : 200000;
+    const int refreshRows = arguments.size() > 3 ? arguments.at(3).toInt() : 1000000;
+    const int sortRows = arguments.size() > 4 ? arguments.at(4).toInt() : 5000000;
+
+    std::printf("Project table benchmark (QTableWidget capped at %d rows)\n", widgetRows);
+    for (int rows : modelRows) {
+        runModel(rows);
+    }
+    runRefresh(refreshRows);
+    runSearch(modelRows.isEmpty() ? 1000000 : modelRows.first());
+    runSort(sortRows);
+    runWidget(widgetRows);
+    return 0;
+}
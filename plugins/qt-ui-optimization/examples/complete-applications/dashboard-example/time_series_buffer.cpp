@@ -0,0 +1,126 @@
+#include "time_series_buffer.h"
+#include <algorithm>
+
+TimeSeriesBuffer::TimeSeriesBuffer(qint64 capacity)
+    : m_capacity((qMax<qint64>(1, capacity) + kBlockSize - 1) / kBlockSize * kBlockSize)
+    , m_end(0)
+    , m_head(0)
+    , m_x(static_cast<size_t>(m_capacity))
+    , m_y(static_cast<size_t>(m_capacity))
+    , m_blockMin(static_cast<size_t>(m_capacity / kBlockSize))
+    , m_blockMax(static_cast<size_t>(m_capacity / kBlockSize))
+{
+}
+
+void TimeSeriesBuffer::append(double x, float y)
+{
+    const size_t s = slot(m_end);
+    m_x[s] = x;
+    m_y[s] = y;
+
+    // 容量是块大小的整数倍，槽位所在的块就是绝对块号对块数取模
+    const size_t block = s / kBlockSize;
+    if (m_end % kBlockSize == 0) {
+        m_blockMin[block] = y;
+        m_blockMax[block] = y;
+    } else {
+        m_blockMin[block] = std::min(m_blockMin[block], y);
+        m_blockMax[block] = std::max(m_blockMax[block], y);
+    }
+    ++m_end;
+    if (++m_head == m_capacity) {
+        m_head = 0;
+    }
+}
+
+qint64 TimeSeriesBuffer::lowerBound(double value, qint64 from) const
+{
+    // 先从from倍增步长找到上界：相邻像素列的查找只访问附近的内存
+    qint64 low = qMax(from, firstIndex());
+    qint64 high = low;
+    qint64 stride = 1;
+    while (high < m_end && xAt(high) < value) {
+        low = high + 1;
+        high = qMin(m_end, low + stride);
+        stride *= 2;
+    }
+    while (low < high) {
+        const qint64 middle = low + (high - low) / 2;
+        if (xAt(middle) < value) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+void TimeSeriesBuffer::scan(qint64 begin, qint64 end, float *min, float *max) const
+{
+    // 环形缓冲区中最多分成两段连续内存
+    float low = *min;
+    float high = *max;
+    while (begin < end) {
+        const size_t first = slot(begin);
+        const size_t count = static_cast<size_t>(qMin<qint64>(end - begin, m_capacity - static_cast<qint64>(first)));
+        const float *y = m_y.data() + first;
+        for (size_t i = 0; i < count; ++i) {
+            low = std::min(low, y[i]);
+            high = std::max(high, y[i]);
+        }
+        begin += static_cast<qint64>(count);
+    }
+    *min = low;
+    *max = high;
+}
+
+bool TimeSeriesBuffer::range(qint64 begin, qint64 end, float *min, float *max) const
+{
+    begin = qMax(begin, firstIndex());
+    end = qMin(end, m_end);
+    if (begin >= end) {
+        return false;
+    }
+
+    float low = m_y[slot(begin)];
+    float high = low;
+    // [firstBlock, lastBlock)是完全落在区间内的块；它们都已写满，且还没有被新块覆盖
+    const qint64 firstBlock = (begin + kBlockSize - 1) / kBlockSize;
+    const qint64 lastBlock = end / kBlockSize;
+    if (firstBlock < lastBlock) {
+        scan(begin, firstBlock * kBlockSize, &low, &high);
+        const size_t blockCount = m_blockMin.size();
+        size_t b = slot(firstBlock * kBlockSize) / kBlockSize;
+        for (qint64 block = firstBlock; block < lastBlock; ++block) {
+            low = std::min(low, m_blockMin[b]);
+            high = std::max(high, m_blockMax[b]);
+            if (++b == blockCount) {
+                b = 0;
+            }
+        }
+        scan(lastBlock * kBlockSize, end, &low, &high);
+    } else {
+        scan(begin, end, &low, &high);
+    }
+
+    *min = low;
+    *max = high;
+    return true;
+}
+
+void TimeSeriesBuffer::decimate(double step, qint64 firstColumn, int count, std::vector<Column> *columns) const
+{
+    columns->assign(static_cast<size_t>(qMax(0, count)), Column());
+    qint64 begin = lowerBound(static_cast<double>(firstColumn) * step, 0);
+    for (int i = 0; i < count && begin < m_end; ++i) {
+        const qint64 end = lowerBound(static_cast<double>(firstColumn + i + 1) * step, begin);
+        if (end > begin) {
+            Column &column = (*columns)[static_cast<size_t>(i)];
+            column.valid = true;
+            column.first = yAt(begin);
+            column.last = yAt(end - 1);
+            range(begin, end, &column.min, &column.max);
+        }
+        begin = end;
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef TIME_SERIES_BUFFER_H
+#define TIME_SERIES_BUFFER_H
+
+#include <QtGlobal>
+#include <vector>
+
+/**
+ * @brief 一条时间序列的环形缓冲区，带按块的最小/最大值摘要
+ *
+ * 容量取整为kBlockSize的整数倍，写满后覆盖最旧的点。样本按绝对序号（从0开始累加）寻址，
+ * 有效范围是[firstIndex(), endIndex())；x（秒）必须单调不减。
+ * 每kBlockSize个点一块，追加时顺带更新当前块的最小/最大值；区间查询只在两端扫描原始点，
+ * 中间的整块直接用摘要，因此按像素列抽取的代价与列数和块数成正比，而不是与点数成正比。
+ */
+class TimeSeriesBuffer
+{
+public:
+    static const int kBlockSize = 64;
+
+    // 一个像素列内的点：进入值、最小值、最大值、离开值
+    struct Column {
+        float first = 0;
+        float min = 0;
+        float max = 0;
+        float last = 0;
+        bool valid = false;
+    };
+
+    explicit TimeSeriesBuffer(qint64 capacity);
+
+    void append(double x, float y);
+
+    qint64 capacity() const { return m_capacity; }
+    qint64 firstIndex() const { return qMax<qint64>(0, m_end - m_capacity); }
+    qint64 endIndex() const { return m_end; }
+    qint64 size() const { return m_end - firstIndex(); }
+    double xAt(qint64 index) const { return m_x[slot(index)]; }
+    float yAt(qint64 index) const { return m_y[slot(index)]; }
+
+    // [from, endIndex())中第一个x >= value的序号，没有时为endIndex()；结果离from越近越快
+    qint64 lowerBound(double value, qint64 from) const;
+
+    // [begin, end)内的最小/最大值，区间为空时返回false
+    bool range(qint64 begin, qint64 end, float *min, float *max) const;
+
+    /**
+     * @brief 按像素列抽取：第c列覆盖x∈[c*step, (c+1)*step)
+     * (*columns)[i]对应第firstColumn+i列，列内没有点时valid为false
+     */
+    void decimate(double step, qint64 firstColumn, int count, std::vector<Column> *columns) const;
+
+private:
+    // index须在[endIndex() - capacity(), endIndex()]内；避免每次访问都做64位取模
+    size_t slot(qint64 index) const
+    {
+        qint64 s = m_head - (m_end - index);
+        return static_cast<size_t>(s < 0 ? s + m_capacity : s);
+    }
+    void scan(qint64 begin, qint64 end, float *min, float *max) const;
+
+    qint64 m_capacity;
+    qint64 m_end;
+    qint64 m_head;                  // endIndex()对应的槽位
+    std::vector<double> m_x;
+    std::vector<float> m_y;
+    std::vector<float> m_blockMin;  // 按块：绝对块号 % 块数
+    std::vector<float> m_blockMax;
+};
+
+#endif // TIME_SERIES_BUFFER_H
@@ -0,0 +1,374 @@
+#include "time_series_chart.h"
+#include <QElapsedTimer>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+// 绘图区四周留给图例和坐标轴标签的空间
+static const int kLeftMargin = 56;
+static const int kTopMargin = 28;
+static const int kRightMargin = 12;
+static const int kBottomMargin = 24;
+// 合成一帧的最短间隔（约60 fps）
+static const int kFrameIntervalMs = 16;
+// 抽取的列数（所有序列合计）超过该值时按序列并行
+static const size_t kParallelDecimateColumns = 4096;
+
+// 约count个刻度时的整齐步长：1、2、5乘以10的幂
+static double niceStep(double span, int count)
+{
+    const double raw = qMax(span, 1e-9) / count;
+    const double magnitude = std::pow(10.0, std::floor(std::log10(raw)));
+    const double normalized = raw / magnitude;
+    if (normalized < 1.5) {
+        return magnitude;
+    } else if (normalized < 3) {
+        return 2 * magnitude;
+    } else if (normalized < 7) {
+        return 5 * magnitude;
+    }
+    return 10 * magnitude;
+}
+
+// x所在的列，与TimeSeriesBuffer::decimate的列边界c*step一致
+static qint64 columnOf(double x, double step)
+{
+    qint64 column = static_cast<qint64>(std::floor(x / step));
+    if (x < static_cast<double>(column) * step) {
+        --column;
+    } else if (x >= static_cast<double>(column + 1) * step) {
+        ++column;
+    }
+    return column;
+}
+
+TimeSeriesChart::TimeSeriesChart(QWidget *parent)
+    : QWidget(parent)
+    , m_timeWindow(60)
+    , m_latestX(-std::numeric_limits<double>::infinity())
+    , m_dirtyFromX(std::numeric_limits<double>::infinity())
+    , m_framePending(false)
+    , m_yMin(0)
+    , m_yMax(1)
+    , m_hasYRange(false)
+    , m_staticDirty(true)
+    , m_renderedEndColumn(-1)
+    , m_frameTimer(nullptr)
+    , m_lastRenderedColumns(0)
+    , m_lastRenderNs(0)
+{
+    // 两层缓存覆盖整个控件，不需要Qt先擦除背景
+    setAttribute(Qt::WA_OpaquePaintEvent);
+
+    m_frameTimer = new QTimer(this);
+    m_frameTimer->setSingleShot(true);
+    m_frameTimer->setInterval(kFrameIntervalMs);
+    m_frameTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_frameTimer, &QTimer::timeout, this, &TimeSeriesChart::onFrame);
+}
+
+int TimeSeriesChart::addSeries(const QString &name, const QColor &color, qint64 capacity)
+{
+    m_series.push_back({name, color, TimeSeriesBuffer(capacity), {}});
+    invalidateLayers();
+    update();
+    return seriesCount() - 1;
+}
+
+qint64 TimeSeriesChart::pointCount() const
+{
+    qint64 count = 0;
+    for (const Series &series : m_series) {
+        count += series.buffer.size();
+    }
+    return count;
+}
+
+void TimeSeriesChart::appendSample(int series, double x, float y)
+{
+    m_series[static_cast<size_t>(series)].buffer.append(x, y);
+    m_latestX = qMax(m_latestX, x);
+    m_dirtyFromX = qMin(m_dirtyFromX, x);
+    m_framePending = true;
+
+    // ❌ 每个点都update()：高频数据下重绘次数不受控
+    // ✅ 只记录脏区，最多每kFrameIntervalMs合成一帧
+    if (!m_frameTimer->isActive()) {
+        m_frameTimer->start();
+    }
+}
+
+void TimeSeriesChart::setTimeWindow(double seconds)
+{
+    m_timeWindow = qMax(seconds, 1e-3);
+    invalidateLayers();
+    update();
+}
+
+QRect TimeSeriesChart::plotRect() const
+{
+    return rect().adjusted(kLeftMargin, kTopMargin, -kRightMargin, -kBottomMargin);
+}
+
+void TimeSeriesChart::invalidateLayers()
+{
+    m_staticDirty = true;
+    m_renderedEndColumn = -1;
+    m_framePending = true;
+}
+
+void TimeSeriesChart::resizeEvent(QResizeEvent *event)
+{
+    invalidateLayers();
+    QWidget::resizeEvent(event);
+}
+
+void TimeSeriesChart::onFrame()
+{
+    // 隐藏时保留脏区，再次显示时由paintEvent渲染
+    if (!isVisible()) {
+        return;
+    }
+    renderDataLayer();
+    // 纵轴范围变化时标签也要重画，否则只更新绘图区
+    update(m_staticDirty ? rect() : plotRect());
+}
+
+void TimeSeriesChart::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+    if (m_framePending || m_renderedEndColumn < 0) {
+        renderDataLayer();
+    }
+    if (m_staticDirty || m_staticLayer.size() != size() * devicePixelRatioF()) {
+        renderStaticLayer();
+    }
+
+    // 绘制区域之外的部分由Qt裁剪掉，没有新列的帧只贴绘图区
+    QPainter painter(this);
+    painter.drawPixmap(0, 0, m_staticLayer);
+    painter.drawImage(QRectF(plotRect()), m_dataLayer);
+}
+
+bool TimeSeriesChart::updateYRange(qint64 firstColumn, double step)
+{
+    float low = std::numeric_limits<float>::max();
+    float high = std::numeric_limits<float>::lowest();
+    bool any = false;
+    const double windowStart = static_cast<double>(firstColumn) * step;
+    for (const Series &series : m_series) {
+        const TimeSeriesBuffer &buffer = series.buffer;
+        float min = 0;
+        float max = 0;
+        if (buffer.range(buffer.lowerBound(windowStart, 0), buffer.endIndex(), &min, &max)) {
+            low = std::min(low, min);
+            high = std::max(high, max);
+            any = true;
+        }
+    }
+    if (!any) {
+        return false;
+    }
+
+    // 数据仍在范围内且没有缩到不足四成时保持不变，避免每帧重画坐标轴
+    if (m_hasYRange && low >= m_yMin && high <= m_yMax && (high - low) >= 0.4f * (m_yMax - m_yMin)) {
+        return false;
+    }
+    const double padding = qMax(static_cast<double>(high - low), 1e-3) * 0.1;
+    const double tick = niceStep(high - low + 2 * padding, 5);
+    m_yMin = static_cast<float>(std::floor((low - padding) / tick) * tick);
+    m_yMax = static_cast<float>(std::ceil((high + padding) / tick) * tick);
+    m_hasYRange = true;
+    return true;
+}
+
+void TimeSeriesChart::renderStaticLayer()
+{
+    m_staticDirty = false;
+    const qreal dpr = devicePixelRatioF();
+    m_staticLayer = QPixmap(size() * dpr);
+    m_staticLayer.setDevicePixelRatio(dpr);
+    m_staticLayer.fill(Qt::white);
+
+    QPainter painter(&m_staticLayer);
+    const QRect plot = plotRect();
+    const QFontMetrics metrics(font());
+    const QColor gridColor("#EEEEEE");
+    const QColor labelColor("#9E9E9E");
+
+    // 图例：放不下的序列省略
+    int legendX = plot.left();
+    for (const Series &series : m_series) {
+        const int width = 16 + metrics.horizontalAdvance(series.name);
+        if (legendX + width > plot.right()) {
+            break;
+        }
+        painter.fillRect(QRect(legendX, kTopMargin / 2 - 2, 12, 4), series.color);
+        painter.setPen(QColor("#616161"));
+        painter.drawText(QRect(legendX + 16, 0, width, kTopMargin), Qt::AlignLeft | Qt::AlignVCenter, series.name);
+        legendX += width + 12;
+    }
+
+    // 横向网格和纵轴标签
+    if (m_hasYRange) {
+        const double span = m_yMax - m_yMin;
+        const double tick = niceStep(span, 5);
+        for (double value = m_yMin; value <= m_yMax + tick * 1e-3; value += tick) {
+            const int y = plot.top() + qRound((m_yMax - value) / span * (plot.height() - 1));
+            painter.setPen(gridColor);
+            painter.drawLine(plot.left(), y, plot.right(), y);
+            painter.setPen(labelColor);
+            painter.drawText(QRect(0, y - 8, kLeftMargin - 6, 16), Qt::AlignRight | Qt::AlignVCenter,
+                             QString::number(value, 'g', 4));
+        }
+    }
+
+    // 纵向网格和时间标签：相对最新数据的时间，位置固定，数据在其下方滚动
+    const double tick = niceStep(m_timeWindow, 6);
+    for (double age = 0; age <= m_timeWindow + tick * 1e-3; age += tick) {
+        const int x = plot.right() - qRound(age / m_timeWindow * (plot.width() - 1));
+        painter.setPen(gridColor);
+        painter.drawLine(x, plot.top(), x, plot.bottom());
+        painter.setPen(labelColor);
+        painter.drawText(QRect(x - 40, plot.bottom() + 4, 80, kBottomMargin - 4), Qt::AlignHCenter | Qt::AlignTop,
+                         age == 0 ? QString("现在") : QString("-%1s").arg(age, 0, 'g', 4));
+    }
+
+    painter.setPen(QColor("#BDBDBD"));
+    painter.drawRect(plot.adjusted(0, 0, -1, -1));
+}
+
+void TimeSeriesChart::scrollDataLayer(int shift)
+{
+    if (shift <= 0) {
+        return;
+    }
+    const size_t bytes = static_cast<size_t>(m_dataLayer.width() - shift) * sizeof(QRgb);
+    for (int y = 0; y < m_dataLayer.height(); ++y) {
+        uchar *line = m_dataLayer.scanLine(y);
+        std::memmove(line, line + shift * static_cast<int>(sizeof(QRgb)), bytes);
+    }
+}
+
+void TimeSeriesChart::renderDataLayer()
+{
+    QElapsedTimer timer;
+    timer.start();
+    m_framePending = false;
+    m_lastRenderedColumns = 0;
+
+    // 数据层按设备像素分配，每个设备像素一列
+    const QSize layerSize = (QSizeF(plotRect().size()) * devicePixelRatioF()).toSize();
+    if (layerSize.isEmpty()) {
+        return;
+    }
+    if (m_dataLayer.size() != layerSize) {
+        m_dataLayer = QImage(layerSize, QImage::Format_ARGB32_Premultiplied);
+        m_renderedEndColumn = -1;
+    }
+    if (!std::isfinite(m_latestX)) {
+        m_dataLayer.fill(Qt::transparent);
+        return;
+    }
+
+    const int width = layerSize.width();
+    const double step = m_timeWindow / width;
+    const qint64 endColumn = columnOf(m_latestX, step) + 1;
+    const qint64 firstColumn = endColumn - width;
+    if (updateYRange(firstColumn, step)) {
+        m_staticDirty = true;
+        m_renderedEndColumn = -1;
+    }
+
+    // ❌ 每帧重新抽取并绘制全部列
+    // ✅ 已有像素按新增的列数左移，只重画新露出的列和收到新点的列
+    qint64 start = firstColumn;     // 需要重画的第一列（绝对列号）
+    const qint64 shift = endColumn - m_renderedEndColumn;
+    if (m_renderedEndColumn >= 0 && shift >= 0 && shift < width) {
+        scrollDataLayer(static_cast<int>(shift));
+        qint64 changed = m_renderedEndColumn;
+        if (std::isfinite(m_dirtyFromX)) {
+            changed = qMin(changed, columnOf(m_dirtyFromX, step));
+        }
+        // 变化列与各序列之前最后一个点之间的连线也变了（中间可能隔着没有点的列），
+        // 从这些点所在的列开始重画
+        start = changed;
+        for (const Series &series : m_series) {
+            const TimeSeriesBuffer &buffer = series.buffer;
+            const qint64 next = buffer.lowerBound(static_cast<double>(changed) * step, 0);
+            if (next > buffer.firstIndex()) {
+                start = qMin(start, columnOf(buffer.xAt(next - 1), step));
+            }
+        }
+        start = qMax(start, firstColumn);
+    }
+    // 环形缓冲区覆盖掉的点与窗口内的点之间的连线无法局部擦除，整体重画
+    for (const Series &series : m_series) {
+        const TimeSeriesBuffer &buffer = series.buffer;
+        if (buffer.firstIndex() > 0 && columnOf(buffer.xAt(buffer.firstIndex()), step) >= firstColumn) {
+            start = firstColumn;
+        }
+    }
+    m_renderedEndColumn = endColumn;
+    m_dirtyFromX = std::numeric_limits<double>::infinity();
+    const int dirty = static_cast<int>(start - firstColumn);
+    if (dirty >= width || !m_hasYRange) {
+        m_lastRenderNs = timer.nsecsElapsed();
+        return;
+    }
+
+    QPainter painter(&m_dataLayer);
+    const QRect strip(dirty, 0, width - dirty, layerSize.height());
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.fillRect(strip, Qt::transparent);
+    painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+    painter.setClipRect(strip);
+
+    const int count = width - dirty;
+    const auto decimate = [start, count, step](Series &series) {
+        series.buffer.decimate(step, start, count, &series.columns);
+    };
+    if (static_cast<size_t>(count) * m_series.size() >= kParallelDecimateColumns) {
+        QtConcurrent::blockingMap(m_series, decimate);
+    } else {
+        std::for_each(m_series.begin(), m_series.end(), decimate);
+    }
+
+    // 每列画进入值→最小值→最大值→离开值，覆盖该列内的全部取值
+    const double scale = (layerSize.height() - 1) / static_cast<double>(m_yMax - m_yMin);
+    const auto toY = [this, scale](float value) {
+        return static_cast<int>(std::lround(qBound(-1e6, (m_yMax - value) * scale, 1e6)));
+    };
+    for (const Series &series : m_series) {
+        m_polyline.clear();
+        // 折线从重画范围之前的最后一个点接过来，超出左边界的部分被裁剪掉
+        const TimeSeriesBuffer &buffer = series.buffer;
+        const qint64 next = buffer.lowerBound(static_cast<double>(start) * step, 0);
+        if (next > buffer.firstIndex()) {
+            const qint64 x = qMax<qint64>(columnOf(buffer.xAt(next - 1), step) - firstColumn, -1000000);
+            m_polyline.emplace_back(static_cast<int>(x), toY(buffer.yAt(next - 1)));
+        }
+        for (int i = 0; i < count; ++i) {
+            const TimeSeriesBuffer::Column &column = series.columns[static_cast<size_t>(i)];
+            if (!column.valid) {
+                continue;
+            }
+            const int x = dirty + i;
+            m_polyline.emplace_back(x, toY(column.first));
+            m_polyline.emplace_back(x, toY(column.min));
+            m_polyline.emplace_back(x, toY(column.max));
+            m_polyline.emplace_back(x, toY(column.last));
+        }
+        if (!m_polyline.empty()) {
+            painter.setPen(QPen(series.color, 0));
+            painter.drawPolyline(m_polyline.data(), static_cast<int>(m_polyline.size()));
+        }
+    }
+
+    m_lastRenderedColumns = width - dirty;
+    m_lastRenderNs = timer.nsecsElapsed();
+}
@@ -0,0 +1,88 @@
+#ifndef TIME_SERIES_CHART_H
+#define TIME_SERIES_CHART_H
+
+#include <QColor>
+#include <QImage>
+#include <QPixmap>
+#include <QTimer>
+#include <QWidget>
+#include <vector>
+#include "time_series_buffer.h"
+
+/**
+ * @brief 基于QPainter的滚动时间序列图，显示各序列最近timeWindow()秒的数据
+ *
+ * 渲染分三层，每层只在需要时重画：
+ *   - 静态层（背景、网格、坐标轴标签、图例）缓存在QPixmap中，只在尺寸或纵轴范围变化时重画；
+ *   - 数据层是绘图区大小的QImage，每个设备像素一列。列按绝对时间对齐（第c列覆盖[c*step, (c+1)*step)），
+ *     新数据到来时把已有像素整体左移，只重画新露出的列和收到新点的列；
+ *   - 窗口绘制时只把两层缓存贴到屏幕上，没有新列的帧只更新绘图区。
+ * 每列用该列内点的进入值、最小值、最大值、离开值画折线（min/max抽取），尖峰不会丢失，
+ * 代价与像素列数成正比而与点数无关（见TimeSeriesBuffer::decimate）。
+ * 追加数据只记录脏区，最多每16 ms合成一帧。
+ */
+class TimeSeriesChart : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit TimeSeriesChart(QWidget *parent = nullptr);
+
+    // 添加一条序列，返回序号；capacity为环形缓冲区保留的点数
+    int addSeries(const QString &name, const QColor &color, qint64 capacity);
+    int seriesCount() const { return static_cast<int>(m_series.size()); }
+    qint64 pointCount() const;
+
+    // x为秒，同一序列内单调不减
+    void appendSample(int series, double x, float y);
+
+    void setTimeWindow(double seconds);
+    double timeWindow() const { return m_timeWindow; }
+
+    // 最近一次数据层渲染重画的像素列数和耗时
+    int lastRenderedColumns() const { return m_lastRenderedColumns; }
+    qint64 lastRenderNs() const { return m_lastRenderNs; }
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+
+private slots:
+    void onFrame();
+
+private:
+    struct Series {
+        QString name;
+        QColor color;
+        TimeSeriesBuffer buffer;
+        std::vector<TimeSeriesBuffer::Column> columns;  // 本次渲染的抽取结果
+    };
+
+    QRect plotRect() const;
+    void invalidateLayers();
+    bool updateYRange(qint64 firstColumn, double step);
+    void renderStaticLayer();
+    void renderDataLayer();
+    void scrollDataLayer(int shift);
+
+    std::vector<Series> m_series;
+    double m_timeWindow;
+    double m_latestX;
+    double m_dirtyFromX;            // 上次渲染后收到的最早的x
+    bool m_framePending;
+    float m_yMin;
+    float m_yMax;
+    bool m_hasYRange;
+
+    QPixmap m_staticLayer;
+    bool m_staticDirty;
+    QImage m_dataLayer;
+    qint64 m_renderedEndColumn;     // 数据层最右一列之后的绝对列号，-1为需要整体重画
+    std::vector<QPoint> m_polyline;
+
+    QTimer *m_frameTimer;
+    int m_lastRenderedColumns;
+    qint64 m_lastRenderNs;
+};
+
+#endif // TIME_SERIES_CHART_H